@@ -0,0 +1,31 @@
+// bench/bench.h
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * rsu-bench 공통 헬퍼
+ * - 각 벤치마크는 bench_<name>(argc, argv) 하나를 제공하고 bench_main.c 표에 등록
+ * - 결과는 "suite,case,metric,value" CSV 한 줄씩 (stdout), 진행 로그는 stderr
+ */
+
+static inline uint64_t bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline void bench_report(const char *suite, const char *case_name,
+                                const char *metric, double value) {
+  printf("%s,%s,%s,%.3f\n", suite, case_name, metric, value);
+  fflush(stdout);
+}
+
+int bench_wl1_workers(int argc, char **argv);
+int bench_sig_cache(int argc, char **argv);
+int bench_filter(int argc, char **argv);
+int bench_geofence(int argc, char **argv);
+int bench_runtime(int argc, char **argv);
+int bench_trace(int argc, char **argv);
+int bench_micro(int argc, char **argv);
@@ -0,0 +1,179 @@
+// bench/bench_filter.c
+// light filter: 패킷 단건(분기) vs 배치(scalar / SSE2 / AVX2 / NEON), 탈락 비율별 ns/pkt
+// - 탈락 패킷은 msg_type/ttl/version/severity 중 하나를 무작위로 망가뜨림
+// - 모든 배치 구현의 마스크가 단건 결과와 같은지도 확인 (mismatch)
+// - 규칙 순서: 탈락을 거의 다 만드는 규칙을 맨 뒤에 선언했을 때 재배치 끔/켬 비교
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "filter.h"
+#include "types.h"
+
+#define BATCH 32   // wireless RX 기본 배치 크기 (wl1_rx_batch)
+
+static uint64_t xorshift(uint64_t *s) {
+  uint64_t x = *s;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *s = x;
+}
+
+static void make_packets(wl1_packet_t *pkts, const wl1_packet_t **ptrs, uint32_t n, unsigned reject_pct) {
+  uint64_t rng = 0x2545f4914f6cdd1dull ^ reject_pct;
+  for (uint32_t i = 0; i < n; i++) {
+    wl1_packet_t *p = &pkts[i];
+    memset(p, 0, sizeof(*p));
+    p->payload.header.version = 1;
+    p->payload.header.msg_type = 0;
+    p->payload.header.ttl = 3;
+    p->payload.accident.severity = 2 + (uint8_t)(xorshift(&rng) % 3);
+    p->payload.accident.accident_id = i + 1;
+    if (xorshift(&rng) % 100 < reject_pct) {
+      switch (xorshift(&rng) % 4) {
+      case 0: p->payload.header.msg_type = 1; break;
+      case 1: p->payload.header.ttl = (uint8_t)(xorshift(&rng) % 3); break;
+      case 2: p->payload.header.version = 2; break;
+      default: p->payload.accident.severity = (uint8_t)(xorshift(&rng) % 2); break;
+      }
+    }
+    ptrs[i] = p;
+  }
+  // 수신 슬롯은 메모리상 연속이 아님 -> 포인터 순서를 섞음
+  for (uint32_t i = n - 1; i > 0; i--) {
+    uint32_t j = (uint32_t)(xorshift(&rng) % (i + 1));
+    const wl1_packet_t *t = ptrs[i];
+    ptrs[i] = ptrs[j];
+    ptrs[j] = t;
+  }
+}
+
+static volatile uint64_t g_sink;
+
+static double run_single(const wl1_packet_t **ptrs, uint32_t n, int reps, uint64_t *ref) {
+  uint64_t t0 = bench_now_ns();
+  for (int r = 0; r < reps; r++) {
+    for (uint32_t b = 0; b < n; b += BATCH) {
+      uint64_t m = 0;
+      for (uint32_t i = 0; i < BATCH && b + i < n; i++) {
+        if (filter_pass_light(ptrs[b + i])) m |= 1ull << i;
+      }
+      if (r == 0) ref[b / BATCH] = m;
+      g_sink += m;
+    }
+  }
+  return (double)(bench_now_ns() - t0) / ((double)n * reps);
+}
+
+static double run_batch(const wl1_packet_t **ptrs, uint32_t n, int reps,
+                        const uint64_t *ref, uint64_t *mismatch) {
+  uint64_t t0 = bench_now_ns();
+  for (int r = 0; r < reps; r++) {
+    for (uint32_t b = 0; b < n; b += BATCH) {
+      int cnt = (n - b < BATCH) ? (int)(n - b) : BATCH;
+      uint64_t m = filter_light_batch(&ptrs[b], cnt);
+      if (r == 0 && m != ref[b / BATCH]) (*mismatch)++;
+      g_sink += m;
+    }
+  }
+  return (double)(bench_now_ns() - t0) / ((double)n * reps);
+}
+
+// 비싼(키 밖 필드) 규칙을 앞에, 대부분을 떨어뜨리는 ttl 규칙을 맨 뒤에 선언
+#define RULES_WORST_ORDER                                             \
+  "lat in -90000000..90000000; lon in -180000000..180000000;"         \
+  "direction <= 359; lane not in {250, 251}; sender_id != 0;"         \
+  "msg_type != 1; version == 1; severity >= 2; ttl == 3"
+
+static void run_rule_order(wl1_packet_t *pkts, const wl1_packet_t **ptrs, uint32_t n, int reps,
+                           uint64_t *ref) {
+  make_packets(pkts, ptrs, n, 0);
+  uint64_t rng = 0x9e3779b97f4a7c15ull;
+  for (uint32_t i = 0; i < n; i++) {
+    pkts[i].payload.sender.sender_id = i + 1;
+    if (xorshift(&rng) % 100 < 90) pkts[i].payload.header.ttl = 1;
+  }
+  if (filter_set_rules(RULES_WORST_ORDER) != 0) return;
+
+  for (int on = 0; on <= 1; on++) {
+    const char *tag = on ? "reorder_on" : "reorder_off";
+    char case_name[48];
+    filter_set_rule_reorder(on != 0);
+    filter_set_rules(RULES_WORST_ORDER);
+    // 재배치가 수렴하도록 한 바퀴 먼저
+    uint64_t warm = 0;
+    run_batch(ptrs, n, 1 + (int)(65536 / n) * 2, ref, &warm);
+    filter_reset_rule_stats();
+
+    double single = run_single(ptrs, n, reps, ref);
+    uint64_t mismatch = 0;
+    double batch = run_batch(ptrs, n, reps, ref, &mismatch);
+    snprintf(case_name, sizeof(case_name), "rules_%s/single", tag);
+    bench_report("filter", case_name, "ns_per_pkt", single);
+    snprintf(case_name, sizeof(case_name), "rules_%s/batch", tag);
+    bench_report("filter", case_name, "ns_per_pkt", batch);
+    bench_report("filter", case_name, "mismatch", (double)mismatch);
+
+    filter_rule_stats_t st[FILTER_RULES_MAX];
+    int nr = filter_get_rule_stats(st, FILTER_RULES_MAX);
+    fprintf(stderr, "[filter] %s order:", tag);
+    for (int i = 0; i < nr; i++) {
+      fprintf(stderr, " [%s %.0f%%]", st[i].text,
+              st[i].evals ? 100.0 * (double)st[i].rejects / (double)st[i].evals : 0.0);
+    }
+    fprintf(stderr, "\n");
+  }
+  filter_set_rule_reorder(true);
+  filter_set_rules(NULL);
+}
+
+// args: [packets=4096] [reps=2000]
+int bench_filter(int argc, char **argv) {
+  uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 4096;
+  int reps   = (argc > 2) ? atoi(argv[2]) : 2000;
+  if (n < BATCH) n = BATCH;
+  if (reps < 1) reps = 1;
+
+  static const unsigned rejects[] = { 0, 10, 50, 90, 100 };
+  static const struct { filter_impl_t impl; const char *name; } impls[] = {
+    { FILTER_IMPL_SCALAR, "batch_scalar" },
+    { FILTER_IMPL_SSE2,   "batch_sse2" },
+    { FILTER_IMPL_AVX2,   "batch_avx2" },
+    { FILTER_IMPL_NEON,   "batch_neon" },
+  };
+
+  wl1_packet_t *pkts = malloc((size_t)n * sizeof(*pkts));
+  const wl1_packet_t **ptrs = malloc((size_t)n * sizeof(*ptrs));
+  uint64_t *ref = malloc(((size_t)n / BATCH + 1) * sizeof(*ref));
+  if (!pkts || !ptrs || !ref) return 1;
+
+  fprintf(stderr, "[filter] packets=%u reps=%d batch=%d\n", n, reps, BATCH);
+
+  for (size_t k = 0; k < sizeof(rejects) / sizeof(rejects[0]); k++) {
+    make_packets(pkts, ptrs, n, rejects[k]);
+    char case_name[48];
+
+    double single = run_single(ptrs, n, reps, ref);
+    snprintf(case_name, sizeof(case_name), "reject_%u/single", rejects[k]);
+    bench_report("filter", case_name, "ns_per_pkt", single);
+
+    for (size_t j = 0; j < sizeof(impls) / sizeof(impls[0]); j++) {
+      if (filter_set_batch_impl(impls[j].impl) != 0) continue; // 이 CPU/빌드에서 미지원
+      uint64_t mismatch = 0;
+      double ns = run_batch(ptrs, n, reps, ref, &mismatch);
+      snprintf(case_name, sizeof(case_name), "reject_%u/%s", rejects[k], impls[j].name);
+      bench_report("filter", case_name, "ns_per_pkt", ns);
+      bench_report("filter", case_name, "speedup", ns > 0 ? single / ns : 0);
+      bench_report("filter", case_name, "mismatch", (double)mismatch);
+    }
+  }
+
+  filter_set_batch_impl(FILTER_IMPL_AUTO);
+  run_rule_order(pkts, ptrs, n, reps, ref);
+  free(pkts);
+  free(ptrs);
+  free(ref);
+  return 0;
+}
@@ -0,0 +1,140 @@
+// bench/bench_geofence.c
+// heavy filter 담당영역 판정: 영역 수별 격자 인덱스 vs 선형 탐색 ns/pkt
+// - 도심 ~20km 범위에 작은 rect/poly 영역(절반은 진행 방향 조건)을 무작위 배치
+// - 조회 지점은 절반은 영역 안(적중), 절반은 범위 내 임의 위치
+// - 두 방식의 결과(영역 번호)가 같은지도 확인 (mismatch)
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "config.h"
+#include "filter.h"
+
+#define AREA_LAT0 37400000
+#define AREA_LON0 126800000
+#define AREA_SPAN 200000        // 0.2도 (~20km)
+
+typedef struct {
+  int32_t lat, lon;
+  uint16_t dir;
+} probe_t;
+
+static uint64_t xorshift(uint64_t *s) {
+  uint64_t x = *s;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *s = x;
+}
+
+static int build_zones(filter_ctx_t *ctx, uint32_t n, uint64_t *rng) {
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t lat = AREA_LAT0 + (int32_t)(xorshift(rng) % AREA_SPAN);
+    int32_t lon = AREA_LON0 + (int32_t)(xorshift(rng) % AREA_SPAN);
+    int32_t h = 300 + (int32_t)(xorshift(rng) % 1500);   // 30~200m
+    int32_t w = 300 + (int32_t)(xorshift(rng) % 1500);
+    int dir = (i & 1) ? (int)(xorshift(rng) % 360) : -1;
+    int rc;
+    if (i % 3 == 0) {
+      // 평행사변형 도로 구간
+      geo_pt_t v[4] = { { lat, lon }, { lat, lon + w }, { lat + h, lon + w + w / 2 }, { lat + h, lon + w / 2 } };
+      rc = filter_add_poly(ctx, v, 4, dir, 45);
+    } else {
+      rc = filter_add_rect(ctx, (geo_pt_t){ lat, lon }, (geo_pt_t){ lat + h, lon + w }, dir, 45);
+    }
+    if (rc != 0) return -1;
+  }
+  return filter_build_index(ctx);
+}
+
+static void make_probes(const filter_ctx_t *ctx, probe_t *pr, uint32_t n, uint64_t *rng) {
+  for (uint32_t i = 0; i < n; i++) {
+    if (i & 1) {
+      const geo_zone_t *z = &ctx->zones[xorshift(rng) % ctx->n_zones];
+      pr[i].lat = z->lat_min + (int32_t)(xorshift(rng) % (uint64_t)(z->lat_max - z->lat_min + 1));
+      pr[i].lon = z->lon_min + (int32_t)(xorshift(rng) % (uint64_t)(z->lon_max - z->lon_min + 1));
+    } else {
+      pr[i].lat = AREA_LAT0 + (int32_t)(xorshift(rng) % AREA_SPAN);
+      pr[i].lon = AREA_LON0 + (int32_t)(xorshift(rng) % AREA_SPAN);
+    }
+    pr[i].dir = (uint16_t)(xorshift(rng) % 360);
+  }
+}
+
+// args: [probes=200000] [reps=5]
+int bench_geofence(int argc, char **argv) {
+  uint32_t n_probe = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 200000;
+  int reps         = (argc > 2) ? atoi(argv[2]) : 5;
+  if (n_probe == 0) n_probe = 1;
+  if (reps < 1) reps = 1;
+
+  static const uint32_t zone_counts[] = { 16, 256, 1024, 4096, 16384 };
+  probe_t *pr = malloc((size_t)n_probe * sizeof(*pr));
+  if (!pr) return 1;
+
+  app_config_t cfg;
+  load_default_config(&cfg);
+  cfg.zones_path = NULL;
+  fprintf(stderr, "[geofence] probes=%u reps=%d\n", n_probe, reps);
+
+  for (size_t zi = 0; zi < sizeof(zone_counts) / sizeof(zone_counts[0]); zi++) {
+    uint32_t nz = zone_counts[zi];
+    uint64_t rng = 0x9e3779b97f4a7c15ull ^ nz;
+    filter_ctx_t ctx;
+    if (filter_init(&ctx, &cfg) != 0 || build_zones(&ctx, nz, &rng) != 0) {
+      filter_destroy(&ctx);
+      free(pr);
+      return 1;
+    }
+    make_probes(&ctx, pr, n_probe, &rng);
+
+    // 선형 탐색은 영역 수에 비례 -> 큰 경우 조회 수를 줄여 측정
+    uint32_t n_lin = n_probe;
+    if ((uint64_t)n_lin * nz > 200000000ull) n_lin = (uint32_t)(200000000ull / nz);
+    if (n_lin == 0) n_lin = 1;
+
+    double best_grid = 0, best_lin = 0;
+    uint64_t hits = 0, mismatch = 0;
+    volatile int sink = 0;
+    for (int r = 0; r < reps; r++) {
+      uint64_t t0 = bench_now_ns();
+      for (uint32_t i = 0; i < n_probe; i++) sink += filter_find_zone(&ctx, pr[i].lat, pr[i].lon, pr[i].dir);
+      uint64_t t1 = bench_now_ns();
+      for (uint32_t i = 0; i < n_lin; i++) sink += filter_find_zone_linear(&ctx, pr[i].lat, pr[i].lon, pr[i].dir);
+      uint64_t t2 = bench_now_ns();
+      double g = (double)(t1 - t0) / n_probe, l = (double)(t2 - t1) / n_lin;
+      if (r == 0 || g < best_grid) best_grid = g;
+      if (r == 0 || l < best_lin) best_lin = l;
+    }
+    for (uint32_t i = 0; i < n_lin; i++) {
+      int a = filter_find_zone(&ctx, pr[i].lat, pr[i].lon, pr[i].dir);
+      int b = filter_find_zone_linear(&ctx, pr[i].lat, pr[i].lon, pr[i].dir);
+      if (a != b) mismatch++;
+      if (a >= 0) hits++;
+    }
+
+    char case_name[32];
+    snprintf(case_name, sizeof(case_name), "zones%u", nz);
+    bench_report("geofence", case_name, "grid_ns_per_pkt", best_grid);
+    bench_report("geofence", case_name, "linear_ns_per_pkt", best_lin);
+    bench_report("geofence", case_name, "speedup", best_grid > 0 ? best_lin / best_grid : 0);
+    bench_report("geofence", case_name, "hit_pct", 100.0 * (double)hits / n_lin);
+    bench_report("geofence", case_name, "mismatch", (double)mismatch);
+    filter_destroy(&ctx);
+  }
+
+  // 거리 계산 (RSU 기준, 고정소수점)
+  {
+    filter_ctx_t ctx;
+    filter_init(&ctx, &cfg);
+    volatile uint32_t sink = 0;
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < n_probe; i++) sink += filter_distance_m(&ctx, pr[i].lat, pr[i].lon);
+    uint64_t t1 = bench_now_ns();
+    bench_report("geofence", "distance", "ns_per_pkt", (double)(t1 - t0) / n_probe);
+    filter_destroy(&ctx);
+  }
+
+  free(pr);
+  return 0;
+}
@@ -0,0 +1,22 @@
+// bench/bench_led_stub.c
+// pipeline을 벤치에서 띄우기 위한 LED 대체 (libgpiod 없이 링크)
+// - GPIO 없음과 같은 동작: open 실패 -> pipeline은 LED 없이 진행
+#include <stddef.h>
+
+#include "led.h"
+
+led_handle_t* led_open(const char *gpiochip, unsigned int line) {
+  (void)gpiochip;
+  (void)line;
+  return NULL;
+}
+
+void led_close(led_handle_t *h) {
+  (void)h;
+}
+
+bool led_set(led_handle_t *h, bool on) {
+  (void)h;
+  (void)on;
+  return false;
+}
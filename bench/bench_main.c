@@ -0,0 +1,59 @@
+// bench/bench_main.c
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "debug.h"
+
+typedef struct {
+  const char *name;
+  int (*fn)(int argc, char **argv);
+  const char *desc;
+} bench_entry_t;
+
+static const bench_entry_t g_benches[] = {
+  { "wl1_workers", bench_wl1_workers, "WL-1 worker 수별 처리량 (accident_id 샤딩)" },
+  { "sig_cache",   bench_sig_cache,   "중복률별 서명 검증 CPU (검증 결과 캐시 끔/켬)" },
+  { "filter",      bench_filter,      "light filter 단건 vs 배치 SIMD, 탈락 비율별" },
+  { "geofence",    bench_geofence,    "담당영역 판정: 영역 수별 격자 인덱스 vs 선형 탐색" },
+  { "runtime",     bench_runtime,     "스테이지별 스레드 vs epoll 루프: CPU, 종단 지연 (루프백)" },
+  { "trace",       bench_trace,       "단계별 지연 추적 비용 (꺼짐/켜짐)" },
+  { "micro",       bench_micro,       "큐/스케줄러/필터/패킷 변환/보안 primitive 단독 (median/MAD)" },
+};
+
+#define N_BENCHES (sizeof(g_benches) / sizeof(g_benches[0]))
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [all | <bench> [args...]]\n", prog);
+  for (size_t i = 0; i < N_BENCHES; i++) {
+    fprintf(stderr, "  %-14s %s\n", g_benches[i].name, g_benches[i].desc);
+  }
+}
+
+int main(int argc, char **argv) {
+  const char *which = (argc > 1) ? argv[1] : "all";
+  if (!strcmp(which, "-h") || !strcmp(which, "--help")) {
+    usage(argv[0]);
+    return 0;
+  }
+
+  // 패킷마다 찍히는 INFO/DEBUG 로그가 측정을 덮지 않도록
+  g_log_level = LOG_WARN;
+
+  printf("suite,case,metric,value\n");
+
+  if (!strcmp(which, "all")) {
+    int rc = 0;
+    for (size_t i = 0; i < N_BENCHES; i++) {
+      char *sub[] = { (char*)g_benches[i].name, NULL };
+      rc |= g_benches[i].fn(1, sub);
+    }
+    return rc ? 1 : 0;
+  }
+
+  for (size_t i = 0; i < N_BENCHES; i++) {
+    if (!strcmp(which, g_benches[i].name)) return g_benches[i].fn(argc - 1, argv + 1);
+  }
+  usage(argv[0]);
+  return 2;
+}
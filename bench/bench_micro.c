@@ -0,0 +1,401 @@
+// bench/bench_micro.c
+// 핵심 primitive 단독 시간 (큐/스케줄러/필터/패킷 변환/보안)
+// - case마다 워밍업 1회 + 반복 reps회, 각 반복의 ns/op로 중앙값(median)과 MAD를 냄
+//   (평균/표준편차 대신: 선점/주파수 변동으로 튀는 반복 몇 개에 흔들리지 않음)
+// - 커밋 간/x86 빌드 호스트와 ARM 타깃 간 비교용: case 이름과 metric은 고정
+//   metric: ns_med, ns_mad (+ 큐는 drop_pct 중앙값)
+// - args: [reps=15] [case 이름 부분 문자열]
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "config.h"
+#include "filter.h"
+#include "packet.h"
+#include "queue.h"
+#include "scheduler.h"
+#include "security.h"
+#include "timeutil.h"
+#include "types.h"
+
+#define MICRO_REPS_MAX 101
+#define MICRO_Q_CAP    1024
+#define MICRO_Q_ITEMS  200000u   // 반복 1회에 큐를 지나가는 item 수 (생산자 합)
+#define MICRO_PKTS     1024      // 필터/변환 입력 패킷 수 (L1/L2에 들어가는 크기)
+
+static volatile uint64_t g_sink;
+
+static uint64_t xorshift(uint64_t *s) {
+  uint64_t x = *s;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *s = x;
+}
+
+static int cmp_double(const void *a, const void *b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+// v[0..n) 정렬됨 가정 아님 (복사해서 계산)
+static double median_of(const double *v, int n) {
+  double t[MICRO_REPS_MAX];
+  memcpy(t, v, sizeof(double) * (size_t)n);
+  qsort(t, (size_t)n, sizeof(double), cmp_double);
+  return (n & 1) ? t[n / 2] : (t[n / 2 - 1] + t[n / 2]) / 2.0;
+}
+
+static double mad_of(const double *v, int n, double med) {
+  double d[MICRO_REPS_MAX];
+  for (int i = 0; i < n; i++) d[i] = v[i] > med ? v[i] - med : med - v[i];
+  return median_of(d, n);
+}
+
+typedef struct {
+  int reps;
+  const char *only;   // NULL = 전부
+} micro_opts_t;
+
+// 반복 1회: ns/op 반환 (aux가 있으면 보조 지표 하나)
+typedef double (*micro_fn_t)(void *ctx, double *aux);
+
+static bool micro_selected(const micro_opts_t *o, const char *case_name) {
+  return !o->only || strstr(case_name, o->only) != NULL;
+}
+
+static void micro_run(const micro_opts_t *o, const char *case_name, micro_fn_t fn, void *ctx,
+                      const char *aux_metric) {
+  if (!micro_selected(o, case_name)) return;
+  double ns[MICRO_REPS_MAX], aux[MICRO_REPS_MAX];
+  double dummy;
+  fn(ctx, &dummy);   // 워밍업 (캐시/분기 예측/페이지 폴트/스레드 생성 경로)
+  for (int r = 0; r < o->reps; r++) {
+    aux[r] = 0;
+    ns[r] = fn(ctx, &aux[r]);
+  }
+  double med = median_of(ns, o->reps);
+  bench_report("micro", case_name, "ns_med", med);
+  bench_report("micro", case_name, "ns_mad", mad_of(ns, o->reps, med));
+  if (aux_metric) bench_report("micro", case_name, aux_metric, median_of(aux, o->reps));
+}
+
+// ---------------------------------------------------------------------------
+// 큐: 1->1, N->1 (백엔드 x full 정책)
+// - 생산자는 bq_push 단건, 소비자는 bq_pop_many(32) (파이프라인 소비자와 같은 모양)
+// - ns/op = 시작 신호 ~ 소비자가 마지막 item을 꺼낼 때까지 / push 시도 수
+// - drop 정책은 생산자가 깊이 MICRO_Q_PACE 이상이면 양보 (pacing): 안 그러면 거의 전부가
+//   가득 찬 큐의 거부 경로가 되어 block과 비교가 안 됨. 그래도 남은 drop은 drop_pct
+// ---------------------------------------------------------------------------
+#define MICRO_Q_PACE (MICRO_Q_CAP * 3 / 4)
+
+typedef struct {
+  bq_backend_t backend;
+  q_full_policy_t policy;
+  int producers;
+  bq_t q;
+  _Atomic bool go;
+  _Atomic int done;
+} q_ctx_t;
+
+static void* q_producer(void *arg) {
+  q_ctx_t *c = (q_ctx_t*)arg;
+  uint32_t n = MICRO_Q_ITEMS / (uint32_t)c->producers;
+  while (!atomic_load_explicit(&c->go, memory_order_acquire)) {
+  }
+  const bool pace = c->policy != Q_BLOCK;
+  for (uint32_t i = 0; i < n; i++) {
+    while (pace && bq_depth(&c->q) >= MICRO_Q_PACE) sched_yield();
+    bq_push(&c->q, (void*)(uintptr_t)(i + 1));
+  }
+  atomic_fetch_add(&c->done, 1);
+  return NULL;
+}
+
+static double q_once(void *arg, double *drop_pct) {
+  q_ctx_t *c = (q_ctx_t*)arg;
+  int rc = (c->backend == BQ_RING) ? bq_init_ring(&c->q, MICRO_Q_CAP, c->policy)
+                                   : bq_init(&c->q, MICRO_Q_CAP, c->policy);
+  if (rc != 0) return 0;
+  atomic_store(&c->go, false);
+  atomic_store(&c->done, 0);
+
+  pthread_t th[8];
+  for (int i = 0; i < c->producers; i++) pthread_create(&th[i], NULL, q_producer, c);
+
+  void *buf[32];
+  uint64_t got = 0;
+  uint64_t t0 = bench_now_ns();
+  atomic_store_explicit(&c->go, true, memory_order_release);
+  for (;;) {
+    int n = bq_pop_many_timed(&c->q, buf, 32, 200);
+    got += (uint64_t)n;
+    if (n == 0 && atomic_load(&c->done) == c->producers && bq_depth(&c->q) == 0) break;
+  }
+  uint64_t dt = bench_now_ns() - t0;
+  for (int i = 0; i < c->producers; i++) pthread_join(th[i], NULL);
+
+  uint64_t total = (uint64_t)(MICRO_Q_ITEMS / (uint32_t)c->producers) * (uint64_t)c->producers;
+  *drop_pct = 100.0 * (double)(total - got) / (double)total;
+  bq_destroy(&c->q);
+  return (double)dt / (double)total;
+}
+
+static void bench_queues(const micro_opts_t *o) {
+  static const char *const pol_name[] = { "block", "drop_tail", "drop_head" };
+  static const int prods[] = { 1, 4 };
+  for (int b = 0; b < 2; b++) {
+    for (int p = Q_BLOCK; p <= Q_DROP_HEAD; p++) {
+      for (size_t k = 0; k < sizeof(prods) / sizeof(prods[0]); k++) {
+        char name[64];
+        snprintf(name, sizeof(name), "bq_%s_%s_%dto1", b ? "ring" : "mutex", pol_name[p], prods[k]);
+        if (!micro_selected(o, name)) continue;
+        fprintf(stderr, "[micro] %s\n", name);
+        static q_ctx_t c;
+        memset(&c, 0, sizeof(c));
+        c.backend = b ? BQ_RING : BQ_MUTEX;
+        c.policy = (q_full_policy_t)p;
+        c.producers = prods[k];
+        micro_run(o, name, q_once, &c, "drop_pct");
+      }
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// 스케줄러: 대기 타이머 수(size)별 scheduler_add + 만료 실행 (scheduler_run_due, 스레드 없이)
+// - 배경 타이머 size개는 먼 미래(1시간 뒤까지 흩뿌림)에 걸어둠 -> 상위 레벨 휠 슬롯을 채움
+// - 반복 1회 = 지금 만료되는 1회성 타이머 BATCH개 등록 + run_due로 모두 실행
+// ---------------------------------------------------------------------------
+#define SCHED_BATCH  1024
+#define SCHED_ROUNDS 64
+
+typedef struct {
+  scheduler_t s;
+  uint64_t fired;
+} sched_ctx_t;
+
+static void sched_cb(void *arg) {
+  ((sched_ctx_t*)arg)->fired++;
+}
+
+static double sched_once(void *arg, double *aux) {
+  sched_ctx_t *c = (sched_ctx_t*)arg;
+  (void)aux;
+  uint64_t t0 = bench_now_ns();
+  for (int rep = 0; rep < SCHED_ROUNDS; rep++) {
+    uint64_t now = now_ms_monotonic();
+    for (int i = 0; i < SCHED_BATCH; i++) scheduler_add(&c->s, now, sched_cb, c);
+    scheduler_run_due(&c->s);
+  }
+  return (double)(bench_now_ns() - t0) / ((double)SCHED_ROUNDS * SCHED_BATCH);
+}
+
+static void bench_sched(const micro_opts_t *o) {
+  static const uint32_t sizes[] = { 0, 1024, 65536, 1u << 20 };
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    char name[64];
+    snprintf(name, sizeof(name), "sched_add_fire_pending%u", sizes[k]);
+    if (!micro_selected(o, name)) continue;
+    fprintf(stderr, "[micro] %s\n", name);
+    sched_ctx_t *c = calloc(1, sizeof(*c));
+    if (!c || scheduler_init(&c->s, sizes[k] + SCHED_BATCH) != 0) {
+      free(c);
+      continue;
+    }
+    uint64_t rng = 0x853c49e6748fea9bull;
+    uint64_t now = now_ms_monotonic();
+    for (uint32_t i = 0; i < sizes[k]; i++) {
+      scheduler_add(&c->s, now + 60000 + xorshift(&rng) % 3600000, sched_cb, c);
+    }
+    micro_run(o, name, sched_once, c, NULL);
+    g_sink += c->fired;
+    scheduler_stop(&c->s);
+    scheduler_destroy(&c->s);
+    free(c);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// filter_pass_all (light + heavy, 담당영역 없음 -> 거리 계산), 탈락 비율별
+// ---------------------------------------------------------------------------
+typedef struct {
+  filter_ctx_t *ctx;
+  wl1_packet_t *pkts;
+} filt_ctx_t;
+
+static void make_mix(wl1_packet_t *pkts, uint32_t n, unsigned reject_pct) {
+  uint64_t rng = 0x2545f4914f6cdd1dull ^ reject_pct;
+  for (uint32_t i = 0; i < n; i++) {
+    wl1_packet_t *p = &pkts[i];
+    memset(p, 0, sizeof(*p));
+    p->payload.header.version = 1;
+    p->payload.header.ttl = 3;
+    p->payload.sender.sender_id = 7 + (uint32_t)(i % 16);
+    p->payload.accident.severity = 2 + (uint8_t)(xorshift(&rng) % 3);
+    p->payload.accident.accident_id = 0x1000 + i;
+    p->payload.accident.lat = 37000000 + (int32_t)(xorshift(&rng) % 20000);
+    p->payload.accident.lon = 127000000 + (int32_t)(xorshift(&rng) % 20000);
+    memset(p->security, 0xEE, WL_SEC_SIZE);
+    if (xorshift(&rng) % 100 < reject_pct) {
+      switch (xorshift(&rng) % 4) {
+      case 0: p->payload.header.msg_type = 1; break;
+      case 1: p->payload.header.ttl = 1; break;
+      case 2: p->payload.header.version = 2; break;
+      default: p->payload.accident.severity = 1; break;
+      }
+    }
+  }
+}
+
+static double filt_once(void *arg, double *aux) {
+  filt_ctx_t *c = (filt_ctx_t*)arg;
+  (void)aux;
+  uint64_t pass = 0;
+  uint64_t t0 = bench_now_ns();
+  for (int r = 0; r < 64; r++) {
+    for (uint32_t i = 0; i < MICRO_PKTS; i++) {
+      uint32_t d;
+      pass += filter_pass_all(c->ctx, &c->pkts[i], &d);
+    }
+  }
+  g_sink += pass;
+  return (double)(bench_now_ns() - t0) / (64.0 * MICRO_PKTS);
+}
+
+static void bench_filter_all(const micro_opts_t *o, wl1_packet_t *pkts) {
+  app_config_t cfg;
+  load_default_config(&cfg);
+  cfg.zones_path = NULL;
+  filter_ctx_t fctx;
+  if (filter_init(&fctx, &cfg) != 0) return;
+  filter_set_rules(NULL);
+  static const unsigned rejects[] = { 0, 10, 50, 90 };
+  for (size_t k = 0; k < sizeof(rejects) / sizeof(rejects[0]); k++) {
+    char name[64];
+    snprintf(name, sizeof(name), "filter_pass_all_reject%u", rejects[k]);
+    if (!micro_selected(o, name)) continue;
+    fprintf(stderr, "[micro] %s\n", name);
+    make_mix(pkts, MICRO_PKTS, rejects[k]);
+    filt_ctx_t c = { &fctx, pkts };
+    micro_run(o, name, filt_once, &c, NULL);
+  }
+  filter_destroy(&fctx);
+}
+
+// ---------------------------------------------------------------------------
+// 패킷 변환 / 보안 (단건 함수, MICRO_PKTS개 입력을 돌며)
+// ---------------------------------------------------------------------------
+typedef struct {
+  wl1_packet_t *pkts;
+  rsu3_payload_t *r3;
+  rsu3_packet_t *r3p;
+  rsu2_payload_t *r2;
+} codec_ctx_t;
+
+#define CODEC_LOOP(body)                                                   \
+  do {                                                                     \
+    uint64_t t0 = bench_now_ns();                                          \
+    for (int r = 0; r < 64; r++) {                                         \
+      for (uint32_t i = 0; i < MICRO_PKTS; i++) { body; }                  \
+    }                                                                      \
+    return (double)(bench_now_ns() - t0) / (64.0 * MICRO_PKTS);            \
+  } while (0)
+
+static double wl1_to_rsu2_once(void *arg, double *aux) {
+  codec_ctx_t *c = (codec_ctx_t*)arg;
+  (void)aux;
+  rsu2_payload_t out;
+  CODEC_LOOP(packet_wl1_to_rsu2(&c->pkts[i].payload, 200, i, &out); g_sink += out.rsu_id);
+}
+
+static double rsu3_to_wl1_once(void *arg, double *aux) {
+  codec_ctx_t *c = (codec_ctx_t*)arg;
+  (void)aux;
+  wl1_payload_t out;
+  CODEC_LOOP(packet_rsu3_to_wl1(&c->r3[i], &out); g_sink += out.sender.sender_id);
+}
+
+static double wl_rx_strip_once(void *arg, double *aux) {
+  codec_ctx_t *c = (codec_ctx_t*)arg;
+  (void)aux;
+  wl1_payload_t out;
+  CODEC_LOOP(sec_wireless_rx_strip(&c->pkts[i], &out); g_sink += out.header.ttl);
+}
+
+static double wl_tx_wrap_once(void *arg, double *aux) {
+  codec_ctx_t *c = (codec_ctx_t*)arg;
+  (void)aux;
+  static wl1_packet_t out;
+  CODEC_LOOP(sec_wireless_tx_wrap(&c->pkts[i].payload, &out); g_sink += out.security[i % WL_SEC_SIZE]);
+}
+
+static double wd_rx_strip_once(void *arg, double *aux) {
+  codec_ctx_t *c = (codec_ctx_t*)arg;
+  (void)aux;
+  rsu3_payload_t out;
+  CODEC_LOOP(sec_wired_rx_strip(&c->r3p[i], &out); g_sink += out.rsu_id);
+}
+
+static double wd_tx_wrap_once(void *arg, double *aux) {
+  codec_ctx_t *c = (codec_ctx_t*)arg;
+  (void)aux;
+  rsu2_packet_t out;
+  CODEC_LOOP(sec_wired_tx_wrap(&c->r2[i], &out); g_sink += out.token[0]);
+}
+
+static void bench_codec_sec(const micro_opts_t *o, wl1_packet_t *pkts) {
+  codec_ctx_t c;
+  c.pkts = pkts;
+  c.r3 = calloc(MICRO_PKTS, sizeof(*c.r3));
+  c.r3p = calloc(MICRO_PKTS, sizeof(*c.r3p));
+  c.r2 = calloc(MICRO_PKTS, sizeof(*c.r2));
+  if (!c.r3 || !c.r3p || !c.r2) goto out;
+  make_mix(pkts, MICRO_PKTS, 0);
+  for (uint32_t i = 0; i < MICRO_PKTS; i++) {
+    packet_wl1_to_rsu2(&pkts[i].payload, 200, i, &c.r2[i]);
+    c.r3[i].rsu_id = c.r2[i].rsu_id;
+    c.r3[i].accident = c.r2[i].accident;
+    c.r3[i].server_info.acc_flag = (i & 1) ? 0xFFFF : 0;
+    c.r3p[i].payload = c.r3[i];
+  }
+
+  micro_run(o, "packet_wl1_to_rsu2", wl1_to_rsu2_once, &c, NULL);
+  micro_run(o, "packet_rsu3_to_wl1", rsu3_to_wl1_once, &c, NULL);
+
+  // 서명 검증 결과 캐시는 끄고 함수 자체만 (캐시 효과는 sig_cache 벤치)
+  sec_vcache_set_enabled(false);
+  micro_run(o, "sec_wireless_rx_strip", wl_rx_strip_once, &c, NULL);
+  micro_run(o, "sec_wireless_tx_wrap", wl_tx_wrap_once, &c, NULL);
+  micro_run(o, "sec_wired_rx_strip", wd_rx_strip_once, &c, NULL);
+  micro_run(o, "sec_wired_tx_wrap", wd_tx_wrap_once, &c, NULL);
+out:
+  free(c.r3);
+  free(c.r3p);
+  free(c.r2);
+}
+
+// args: [reps=15] [case 이름 부분 문자열]
+int bench_micro(int argc, char **argv) {
+  micro_opts_t o;
+  o.reps = (argc > 1) ? atoi(argv[1]) : 15;
+  o.only = (argc > 2) ? argv[2] : NULL;
+  if (o.reps < 3) o.reps = 3;
+  if (o.reps > MICRO_REPS_MAX) o.reps = MICRO_REPS_MAX;
+  fprintf(stderr, "[micro] %d reps per case (+1 warmup), median/MAD of ns per op\n", o.reps);
+
+  wl1_packet_t *pkts = calloc(MICRO_PKTS, sizeof(wl1_packet_t));
+  if (!pkts) return 1;
+  bench_codec_sec(&o, pkts);
+  bench_filter_all(&o, pkts);
+  bench_sched(&o);
+  bench_queues(&o);
+  free(pkts);
+  return 0;
+}
@@ -0,0 +1,270 @@
+// bench/bench_runtime.c
+// 실행 구조 비교: 스테이지별 스레드(RUNTIME_THREADS) vs epoll 루프 1개(RUNTIME_EVLOOP)
+// - 실제 pipeline을 루프백으로 띄움: UDP WL-1 송신 -> RX -> worker -> SM -> wired TCP -> 스텁 서버
+// - 종단 지연 = sendto 직전 ~ 스텁 서버가 해당 사고의 RSU-2 보고를 recv한 시각
+// - CPU = 프로세스 CPU 시간에서 벤치 자신의 송신/스텁 스레드 몫을 뺀 것 (유휴 구간/부하 구간 따로)
+// - 설정은 기본값 그대로 (wired_tx_delay_us 묶음 대기 포함, 실제 배포와 같은 조건)
+#define _GNU_SOURCE // usleep, clock_nanosleep
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "config.h"
+#include "debug.h"
+#include "pipeline.h"
+#include "types.h"
+
+#define ACC_ID_BASE 0x5000000000ull
+
+typedef struct {
+  int listen_fd;
+  uint32_t n;
+  const uint64_t *t_send;   // 사고 seq별 송신 시각
+  uint64_t *lat_ns;         // 받은 순서대로
+  _Atomic uint32_t got;
+  _Atomic bool stop;
+  uint64_t cpu_ns;          // 이 스레드의 CPU 시간 (종료 시)
+} stub_srv_t;
+
+static uint64_t thread_cpu_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t process_cpu_ns(void) {
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ((uint64_t)ru.ru_utime.tv_sec + (uint64_t)ru.ru_stime.tv_sec) * 1000000000ull +
+         ((uint64_t)ru.ru_utime.tv_usec + (uint64_t)ru.ru_stime.tv_usec) * 1000ull;
+}
+
+static int thread_count(void) {
+  FILE *f = fopen("/proc/self/status", "r");
+  if (!f) return -1;
+  char line[128];
+  int n = -1;
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "Threads: %d", &n) == 1) break;
+  }
+  fclose(f);
+  return n;
+}
+
+// 비어 있는 포트 하나 (bind 0 후 반환된 번호)
+static uint16_t free_port(int type) {
+  int fd = socket(AF_INET, type, 0);
+  struct sockaddr_in a;
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(a);
+  uint16_t port = 0;
+  if (fd >= 0 && bind(fd, (struct sockaddr*)&a, sizeof(a)) == 0 &&
+      getsockname(fd, (struct sockaddr*)&a, &len) == 0) {
+    port = ntohs(a.sin_port);
+  }
+  if (fd >= 0) close(fd);
+  return port;
+}
+
+static void* stub_server_thread(void *arg) {
+  stub_srv_t *s = (stub_srv_t*)arg;
+  struct timeval tv = { .tv_sec = 0, .tv_usec = 100000 };
+  setsockopt(s->listen_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  int c = -1;
+  while (c < 0 && !atomic_load(&s->stop)) c = accept(s->listen_fd, NULL, NULL);
+  if (c >= 0) {
+    setsockopt(c, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    uint8_t buf[64 * 64];
+    size_t have = 0;
+    while (!atomic_load(&s->stop)) {
+      ssize_t r = recv(c, buf + have, sizeof(buf) - have, 0);
+      if (r == 0) break;
+      if (r < 0) continue;
+      uint64_t now = bench_now_ns();
+      have += (size_t)r;
+      size_t off = 0;
+      for (; have - off >= sizeof(rsu2_packet_t); off += sizeof(rsu2_packet_t)) {
+        rsu2_packet_t pkt;
+        memcpy(&pkt, buf + off, sizeof(pkt));
+        uint64_t seq = pkt.payload.accident.accident_id - ACC_ID_BASE;
+        uint32_t g = atomic_load(&s->got);
+        if (seq < s->n && g < s->n) {
+          s->lat_ns[g] = now - s->t_send[seq];
+          atomic_store(&s->got, g + 1);
+        }
+      }
+      memmove(buf, buf + off, have - off);
+      have -= off;
+    }
+    close(c);
+  }
+  s->cpu_ns = thread_cpu_ns();
+  return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
+
+static void make_wl1(wl1_packet_t *p, uint64_t seq) {
+  memset(p, 0, sizeof(*p));
+  p->payload.header.version = 1;
+  p->payload.header.msg_type = 0;
+  p->payload.header.ttl = 3;
+  p->payload.sender.sender_id = 7;
+  p->payload.accident.severity = 2;
+  p->payload.accident.accident_id = ACC_ID_BASE + seq;
+  p->payload.accident.lat = 37000100;
+  p->payload.accident.lon = 127000100;
+}
+
+static void run_mode(runtime_mode_t mode, const char *name, uint32_t rate, double secs) {
+  uint32_t n = (uint32_t)(rate * secs);
+  if (n < 1) n = 1;
+  uint64_t *t_send = calloc(n, sizeof(uint64_t));
+  uint64_t *lat = calloc(n, sizeof(uint64_t));
+  if (!t_send || !lat) return;
+
+  app_config_t cfg;
+  load_default_config(&cfg);
+  cfg.runtime_mode = mode;
+  cfg.server_ip = "127.0.0.1";
+  cfg.wl1_bind_ip = "127.0.0.1";
+  cfg.wl1_listen_port = free_port(SOCK_DGRAM);
+  cfg.wl1_tx_ip = "127.0.0.1";
+  cfg.wl1_tx_port = free_port(SOCK_DGRAM);
+  cfg.local_port = free_port(SOCK_STREAM);
+
+  stub_srv_t srv;
+  memset(&srv, 0, sizeof(srv));
+  srv.n = n;
+  srv.t_send = t_send;
+  srv.lat_ns = lat;
+  srv.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in a;
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t alen = sizeof(a);
+  if (bind(srv.listen_fd, (struct sockaddr*)&a, sizeof(a)) != 0 || listen(srv.listen_fd, 4) != 0 ||
+      getsockname(srv.listen_fd, (struct sockaddr*)&a, &alen) != 0) {
+    fprintf(stderr, "[runtime] stub server setup failed\n");
+    return;
+  }
+  cfg.server_port = ntohs(a.sin_port);
+  pthread_t th_srv;
+  pthread_create(&th_srv, NULL, stub_server_thread, &srv);
+
+  // 사고마다 찍히는 LOGI가 CSV에 섞이지 않도록 실행 중에는 stdout을 버림
+  fflush(stdout);
+  int saved_out = dup(STDOUT_FILENO);
+  int devnull = open("/dev/null", O_WRONLY);
+  dup2(devnull, STDOUT_FILENO);
+
+  static pipeline_t p;
+  int threads_before = thread_count();
+  if (pipeline_start_with(&p, &cfg) != 0) {
+    log_flush();
+    dup2(saved_out, STDOUT_FILENO);
+    fprintf(stderr, "[runtime] %s: pipeline start failed\n", name);
+    return;
+  }
+  int threads = thread_count() - threads_before;
+  usleep(200000);   // wired 연결
+
+  // 유휴: 트래픽 없이 1초
+  uint64_t cpu0 = process_cpu_ns(), me0 = thread_cpu_ns();
+  uint64_t w0 = bench_now_ns();
+  sleep(1);
+  uint64_t idle_cpu = (process_cpu_ns() - cpu0) - (thread_cpu_ns() - me0);
+  double idle_pct = 100.0 * (double)idle_cpu / (double)(bench_now_ns() - w0);
+
+  // 부하: rate pkt/s로 고르게
+  int tx = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in dst;
+  memset(&dst, 0, sizeof(dst));
+  dst.sin_family = AF_INET;
+  dst.sin_port = htons(cfg.wl1_listen_port);
+  dst.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  wl1_packet_t pkt;
+
+  cpu0 = process_cpu_ns();
+  me0 = thread_cpu_ns();
+  w0 = bench_now_ns();
+  uint64_t gap = 1000000000ull / (rate ? rate : 1);
+  for (uint32_t i = 0; i < n; i++) {
+    uint64_t due = w0 + (uint64_t)i * gap;
+    struct timespec ts = { (time_t)(due / 1000000000ull), (long)(due % 1000000000ull) };
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    make_wl1(&pkt, i);
+    t_send[i] = bench_now_ns();
+    sendto(tx, &pkt, sizeof(pkt), 0, (struct sockaddr*)&dst, sizeof(dst));
+  }
+  // 마지막 보고까지 (최대 1초)
+  uint64_t limit = bench_now_ns() + 1000000000ull;
+  while (atomic_load(&srv.got) < n && bench_now_ns() < limit) usleep(1000);
+  uint64_t wall = bench_now_ns() - w0;
+  uint64_t me_cpu = thread_cpu_ns() - me0;
+  uint64_t proc_cpu = process_cpu_ns() - cpu0;
+
+  pipeline_stop(&p);
+  atomic_store(&srv.stop, true);
+  pthread_join(th_srv, NULL);
+  close(srv.listen_fd);
+  close(tx);
+
+  log_flush();   // 로거가 아직 못 쓴 줄이 CSV 쪽으로 나가지 않게
+  fflush(stdout);
+  dup2(saved_out, STDOUT_FILENO);
+  close(saved_out);
+  close(devnull);
+
+  // 스텁 서버 CPU는 종료 시 총량만 알 수 있음 (유휴 구간엔 recv 대기라 거의 전부 부하 구간 몫)
+  uint64_t pipe_cpu = proc_cpu - me_cpu;
+  pipe_cpu = (srv.cpu_ns < pipe_cpu) ? pipe_cpu - srv.cpu_ns : 0;
+  uint32_t got = atomic_load(&srv.got);
+  qsort(lat, got, sizeof(uint64_t), cmp_u64);
+
+  char case_name[48];
+  snprintf(case_name, sizeof(case_name), "%s/%u_pps", name, rate);
+  bench_report("runtime", case_name, "threads", (double)threads);
+  bench_report("runtime", case_name, "idle_cpu_pct", idle_pct);
+  bench_report("runtime", case_name, "load_cpu_pct", 100.0 * (double)pipe_cpu / (double)wall);
+  bench_report("runtime", case_name, "cpu_us_per_pkt", (double)pipe_cpu / 1000.0 / (double)n);
+  bench_report("runtime", case_name, "delivered", (double)got);
+  if (got) {
+    bench_report("runtime", case_name, "lat_p50_us", (double)lat[got / 2] / 1000.0);
+    bench_report("runtime", case_name, "lat_p99_us", (double)lat[(uint64_t)got * 99 / 100] / 1000.0);
+    bench_report("runtime", case_name, "lat_max_us", (double)lat[got - 1] / 1000.0);
+  }
+  free(t_send);
+  free(lat);
+}
+
+// args: [rate pkt/s=2000] [seconds=2]
+int bench_runtime(int argc, char **argv) {
+  uint32_t rate = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000;
+  double secs   = (argc > 2) ? atof(argv[2]) : 2.0;
+  if (rate < 1) rate = 1;
+  if (secs <= 0) secs = 1;
+  fprintf(stderr, "[runtime] rate=%u pkt/s for %.1f s per mode (loopback)\n", rate, secs);
+
+  run_mode(RUNTIME_THREADS, "threads", rate, secs);
+  run_mode(RUNTIME_EVLOOP, "evloop", rate, secs);
+  return 0;
+}
@@ -0,0 +1,100 @@
+// bench/bench_sig_cache.c
+// 서명 검증 캐시: 중복률별 패킷당 검증 CPU 시간 (캐시 끔 vs 켬)
+// - 중복 패킷은 최근 window개의 고유 패킷 중 하나를 그대로 재전송한 것으로 가정
+// - 검증 비용은 sec_set_stub_verify_cost_ns로 에뮬레이션
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench.h"
+#include "security.h"
+#include "types.h"
+
+static uint64_t thread_cpu_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t xorshift(uint64_t *s) {
+  uint64_t x = *s;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *s = x;
+}
+
+static void make_unique(wl1_packet_t *pkt, uint64_t n) {
+  memset(pkt, 0, sizeof(*pkt));
+  pkt->payload.header.version = 1;
+  pkt->payload.sender.sender_id = (uint32_t)(n % 500);
+  pkt->payload.sender.send_time = n;
+  pkt->payload.accident.accident_id = n + 1;
+  memset(pkt->security, (int)(n & 0xff), WL_SEC_SIZE);
+  memcpy(pkt->security, &n, sizeof(n));
+}
+
+// 중복률 dup_pct%인 수신 순서 생성
+static void make_trace(wl1_packet_t *trace, uint32_t n_pkts, unsigned dup_pct, uint32_t window) {
+  uint64_t rng = 0x9e3779b97f4a7c15ull ^ dup_pct;
+  uint64_t uniques = 0;
+  for (uint32_t i = 0; i < n_pkts; i++) {
+    if (uniques > 0 && xorshift(&rng) % 100 < dup_pct) {
+      uint64_t back = xorshift(&rng) % (uniques < window ? uniques : window);
+      make_unique(&trace[i], uniques - 1 - back);
+    } else {
+      make_unique(&trace[i], uniques++);
+    }
+  }
+}
+
+static double run_case(const wl1_packet_t *trace, uint32_t n_pkts, bool cache) {
+  sec_vcache_reset();
+  sec_vcache_set_enabled(cache);
+  wl1_payload_t out;
+  uint64_t c0 = thread_cpu_ns();
+  for (uint32_t i = 0; i < n_pkts; i++) (void)sec_wireless_rx_strip(&trace[i], &out);
+  uint64_t c1 = thread_cpu_ns();
+  return (double)(c1 - c0) / (double)n_pkts;
+}
+
+// args: [verify_ns=20000] [packets=20000] [window=256]
+int bench_sig_cache(int argc, char **argv) {
+  uint32_t verify_ns = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+  uint32_t n_pkts    = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 20000;
+  uint32_t window    = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : 256;
+  if (n_pkts == 0) n_pkts = 1;
+  if (window == 0) window = 1;
+
+  static const unsigned dup_rates[] = { 0, 50, 75, 90, 99 };
+  wl1_packet_t *trace = malloc((size_t)n_pkts * sizeof(*trace));
+  if (!trace) return 1;
+
+  sec_set_stub_verify_cost_ns(verify_ns);
+  fprintf(stderr, "[sig_cache] verify=%uns packets=%u window=%u\n", verify_ns, n_pkts, window);
+
+  for (size_t k = 0; k < sizeof(dup_rates) / sizeof(dup_rates[0]); k++) {
+    make_trace(trace, n_pkts, dup_rates[k], window);
+
+    double off = run_case(trace, n_pkts, false);
+    double on = run_case(trace, n_pkts, true);
+    sec_vcache_stats_t st;
+    sec_vcache_get_stats(&st);
+
+    char case_name[32];
+    snprintf(case_name, sizeof(case_name), "dup_%u", dup_rates[k]);
+    bench_report("sig_cache", case_name, "cpu_ns_per_pkt_nocache", off);
+    bench_report("sig_cache", case_name, "cpu_ns_per_pkt_cache", on);
+    bench_report("sig_cache", case_name, "cpu_saving_pct", off > 0 ? (1.0 - on / off) * 100.0 : 0);
+    bench_report("sig_cache", case_name, "hit_rate_pct",
+                 (st.hits + st.misses) ? (double)st.hits * 100.0 / (double)(st.hits + st.misses) : 0);
+    bench_report("sig_cache", case_name, "evictions", (double)st.evictions);
+  }
+
+  sec_set_stub_verify_cost_ns(0);
+  sec_vcache_reset();
+  sec_vcache_set_enabled(true);
+  free(trace);
+  return 0;
+}
@@ -0,0 +1,54 @@
+// bench/bench_trace.c
+// 단계별 지연 추적 비용: 꺼짐 / 켜짐, 단계 1회 (시각 읽기 + 기록 + 히스토그램 누적)
+// - stamp: trace_stamp만 (배치마다 시각은 한 번 읽으므로 패킷당 비용은 이쪽에 가까움)
+// - now:   trace_now_if (배치당 1회)
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "trace.h"
+
+static volatile uint64_t g_sink;
+
+static double run_stamp(uint32_t n) {
+  pkt_trace_t t;
+  uint64_t base = 1000000;
+  uint64_t t0 = bench_now_ns();
+  for (uint32_t i = 0; i < n; i++) {
+    uint64_t rx = trace_enabled() ? base + i : 0;
+    trace_begin(&t, rx);
+    for (int st = TR_WL1_POP; st < TR_N_STAGES; st++) {
+      trace_stamp(&t, (trace_stage_t)st, rx ? rx + (uint64_t)st * 750 + (i & 1023) : 0);
+    }
+    g_sink += t.at[TR_TCP_SEND - 1];
+  }
+  return (double)(bench_now_ns() - t0) / ((double)n * (TR_N_STAGES - 1));
+}
+
+static double run_now(uint32_t n) {
+  uint64_t t0 = bench_now_ns();
+  for (uint32_t i = 0; i < n; i++) g_sink += trace_now_if();
+  return (double)(bench_now_ns() - t0) / (double)n;
+}
+
+// args: [packets=2000000]
+int bench_trace(int argc, char **argv) {
+  uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000000;
+  if (n < 1) n = 1;
+  fprintf(stderr, "[trace] packets=%u stages=%d\n", n, TR_N_STAGES - 1);
+
+  for (int on = 0; on <= 1; on++) {
+    const char *name = on ? "enabled" : "disabled";
+    trace_set_enabled(on != 0);
+    trace_reset();
+    bench_report("trace", name, "ns_per_stamp", run_stamp(n));
+    bench_report("trace", name, "ns_per_now", run_now(n));
+  }
+  trace_span_stats_t st;
+  trace_get_span_stats(TR_SPAN_E2E, &st);
+  fprintf(stderr, "[trace] e2e samples %llu p50 %llu ns max %llu ns\n",
+          (unsigned long long)st.count, (unsigned long long)st.p50_ns, (unsigned long long)st.max_ns);
+  trace_set_enabled(false);
+  trace_reset();
+  return 0;
+}
@@ -0,0 +1,127 @@
+// bench/bench_wl1_workers.c
+// WL-1 워커 수에 따른 처리량: [샤드 Q] -> worker x N -> [SM Event Q] -> drain
+// - 서명 검증 비용은 sec_set_stub_verify_cost_ns로 에뮬레이션
+// - drain 쪽에서 사고별 순서(accident.alt에 넣은 일련번호)가 지켜졌는지도 확인
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "pools.h"
+#include "queue.h"
+#include "config.h"
+#include "filter.h"
+#include "security.h"
+#include "types.h"
+#include "wl1_worker.h"
+
+typedef struct {
+  bq_t *q;
+  uint64_t expect;
+  uint32_t n_acc;
+  uint32_t *last_seq;     // 사고별 마지막 일련번호 (+1, 0 = 아직 없음)
+  uint64_t got;
+  uint64_t order_violations;
+} drain_ctx_t;
+
+static void* drain_thread(void *arg) {
+  drain_ctx_t *d = (drain_ctx_t*)arg;
+  void *evs[64];
+  while (d->got < d->expect) {
+    int n = bq_pop_many(d->q, evs, 64);
+    if (n == 0) break;
+    for (int i = 0; i < n; i++) {
+      sm_event_t *ev = (sm_event_t*)evs[i];
+      rsu2_payload_t *r = ev->u.rsu2p;
+      uint32_t acc = (uint32_t)(r->accident.accident_id - 1);
+      uint32_t seq = (uint32_t)ntohl((uint32_t)r->accident.alt) + 1;
+      if (acc < d->n_acc) {
+        if (seq <= d->last_seq[acc]) d->order_violations++;
+        d->last_seq[acc] = seq;
+      }
+      mempool_free(&g_pools.rsu2p, r);
+      mempool_free(&g_pools.sm_ev, ev);
+    }
+    d->got += (uint64_t)n;
+  }
+  return NULL;
+}
+
+static double run_once(int n_workers, uint32_t n_pkts, uint32_t n_acc, uint64_t *violations) {
+  bq_t shard[WL1_MAX_WORKERS];
+  bq_t out;
+  wl1_worker_t workers[WL1_MAX_WORKERS];
+  uint32_t *acc_seq = calloc(n_acc, sizeof(uint32_t));
+  drain_ctx_t d = { .q = &out, .expect = n_pkts, .n_acc = n_acc,
+                    .last_seq = calloc(n_acc, sizeof(uint32_t)) };
+
+  for (int i = 0; i < n_workers; i++) bq_init_ring(&shard[i], 256, Q_BLOCK);
+  bq_init(&out, 4096, Q_BLOCK);
+  app_config_t cfg;
+  filter_ctx_t filter;
+  load_default_config(&cfg);
+  cfg.zones_path = NULL;        // RSU_ZONES 무시: 합성 패킷(위치 0,0)이 영역 밖으로 빠지면 drain이 안 끝남
+  filter_init(&filter, &cfg);   // 담당영역 없음 -> heavy는 거리 계산만
+  filter_set_rules(NULL);
+  for (int i = 0; i < n_workers; i++) wl1_worker_start(&workers[i], &shard[i], &out, 200, &filter, NULL);
+  pthread_t th_drain;
+  pthread_create(&th_drain, NULL, drain_thread, &d);
+
+  uint64_t t0 = bench_now_ns();
+  for (uint32_t i = 0; i < n_pkts; i++) {
+    wl1_packet_t *pkt = mempool_alloc(&g_pools.wl1_pkt);
+    uint32_t acc = i % n_acc;
+    pkt->payload.header.version = 1;
+    pkt->payload.header.ttl = 3;
+    pkt->payload.accident.severity = 2;
+    pkt->payload.accident.accident_id = acc + 1;
+    pkt->payload.accident.alt = (int32_t)acc_seq[acc]++;
+    bq_push(&shard[wl1_shard_of(pkt, n_workers)], pkt);
+  }
+  pthread_join(th_drain, NULL);
+  uint64_t t1 = bench_now_ns();
+
+  for (int i = 0; i < n_workers; i++) bq_stop(&shard[i]);
+  for (int i = 0; i < n_workers; i++) wl1_worker_join(&workers[i]);
+  filter_destroy(&filter);
+  for (int i = 0; i < n_workers; i++) bq_destroy(&shard[i]);
+  bq_destroy(&out);
+
+  *violations = d.order_violations;
+  free(acc_seq);
+  free(d.last_seq);
+  return (double)n_pkts * 1e9 / (double)(t1 - t0);
+}
+
+// args: [verify_ns=20000] [packets=20000] [accidents=64] [max_workers=WL1_MAX_WORKERS]
+int bench_wl1_workers(int argc, char **argv) {
+  uint32_t verify_ns = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+  uint32_t n_pkts    = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 20000;
+  uint32_t n_acc     = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : 64;
+  int max_workers    = (argc > 4) ? atoi(argv[4]) : WL1_MAX_WORKERS;
+  if (n_acc == 0) n_acc = 1;
+  if (max_workers > WL1_MAX_WORKERS) max_workers = WL1_MAX_WORKERS;
+
+  if (pools_init() != 0) return 1;
+  sec_set_stub_verify_cost_ns(verify_ns);
+  fprintf(stderr, "[wl1_workers] verify=%uns packets=%u accidents=%u\n", verify_ns, n_pkts, n_acc);
+
+  double base = 0;
+  for (int w = 1; w <= max_workers; w *= 2) {
+    uint64_t viol = 0;
+    double pps = run_once(w, n_pkts, n_acc, &viol);
+    if (w == 1) base = pps;
+
+    char case_name[32];
+    snprintf(case_name, sizeof(case_name), "workers_%d", w);
+    bench_report("wl1_workers", case_name, "pkts_per_sec", pps);
+    bench_report("wl1_workers", case_name, "speedup", base > 0 ? pps / base : 0);
+    bench_report("wl1_workers", case_name, "order_violations", (double)viol);
+  }
+
+  sec_set_stub_verify_cost_ns(0);
+  pools_destroy();
+  return 0;
+}
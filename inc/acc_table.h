@@ -0,0 +1,65 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
+#include "bcast_frame.h"
+
+/*
+ * 사고 테이블: accident_id -> 상태 (state manager 스레드 전용, 잠금 없음)
+ * - open addressing + linear probing, 삭제는 backward shift (tombstone 없음)
+ * - 자주 보는 필드(hot: id/active/expire)와 가끔 쓰는 last_rsu3(cold)를
+ *   같은 인덱스의 별도 배열로 분리 -> probe가 캐시라인 몇 개로 끝남
+ * - active 개수는 증분 관리 (LED 판단에 전체 스캔 불필요)
+ * - load factor 3/4 넘으면 2배로 grow (max_cap까지)
+ * - 슬롯 인덱스는 insert/remove 후 바뀔 수 있으므로 바로 쓰고 버릴 것
+ * - 재전파 시각은 (due, accident_id) min-heap. 삭제/변경 시 heap은 건드리지 않고
+ *   꺼낼 때 hot.bcast_due와 비교해 지난 항목은 버림 (lazy deletion)
+ * - frame[i]: cold[i]로 만든 재전파 프레임 캐시 (cold가 바뀌면 acc_table_drop_frame)
+ */
+
+typedef struct {
+  uint64_t accident_id;
+  uint64_t expire_ms;
+  uint64_t bcast_due;     // 다음 재전파 시각 (0 = 예약 없음)
+  bool used;
+  bool active;
+} acc_hot_t;
+
+typedef struct {
+  uint64_t due_ms;
+  uint64_t accident_id;
+} acc_due_t;
+
+typedef struct {
+  acc_hot_t *hot;
+  rsu3_payload_t *cold;   // hot[i]의 last_rsu3 (rsu_id == 0 이면 아직 서버 응답 없음)
+  bcast_frame_t **frame;  // hot[i]의 재전파 프레임 (NULL = 아직 없음, 테이블이 1 참조 보유)
+  uint32_t cap, mask;
+  uint32_t max_cap;
+  uint32_t count;
+  uint32_t active_count;
+
+  acc_due_t *due;         // 재전파 min-heap
+  uint32_t due_n, due_cap;
+} acc_table_t;
+
+int  acc_table_init(acc_table_t *t, uint32_t init_cap, uint32_t max_cap);
+void acc_table_destroy(acc_table_t *t);
+
+// 슬롯 인덱스, 없으면 -1
+int  acc_table_find(const acc_table_t *t, uint64_t accident_id);
+// 찾거나 새로 등록 (새 항목은 inactive, cold 0). 가득 차서 못 넣으면 -1
+int  acc_table_insert(acc_table_t *t, uint64_t accident_id);
+void acc_table_remove(acc_table_t *t, int idx);
+
+void acc_table_set_active(acc_table_t *t, int idx, bool active);
+
+// 캐시된 프레임 참조 반환 (last_rsu3 변경 시)
+void acc_table_drop_frame(acc_table_t *t, int idx);
+
+// 재전파 예약 (기존 예약은 무효화). 메모리 부족 시 -1
+int  acc_table_schedule(acc_table_t *t, int idx, uint64_t due_ms);
+// now_ms 까지 만료된 유효 예약 하나를 꺼냄 (예약은 해제됨). 없으면 -1
+int  acc_table_pop_due(acc_table_t *t, uint64_t now_ms, uint64_t *due_ms);
+// 가장 이른 예약 시각 (지난 항목일 수 있음), 없으면 UINT64_MAX
+uint64_t acc_table_next_due(const acc_table_t *t);
@@ -0,0 +1,32 @@
+// app/bcast_frame.h
+#pragma once
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
+
+/*
+ * 재전파용 완성 프레임 (wrap까지 끝난 wl1_packet_t) + 참조 카운트
+ * - SM의 사고 테이블이 1개 참조를 캐시로 보유, Q_air에 넣을 때마다 +1
+ * - wireless TX가 송신 후 bcast_frame_put (0이 되면 풀로 반환)
+ * - 캐시 보유자만 남았을 때(refs == 1)만 제자리 수정 가능
+ */
+
+typedef struct {
+  _Atomic uint32_t refs;
+  wl1_packet_t pkt;
+} bcast_frame_t;
+
+// refs = 1 로 할당 (g_pools.bframe)
+bcast_frame_t* bcast_frame_new(void);
+
+static inline void bcast_frame_get(bcast_frame_t *f) {
+  atomic_fetch_add_explicit(&f->refs, 1, memory_order_relaxed);
+}
+
+void bcast_frame_put(bcast_frame_t *f);
+
+// 캐시 외에 아직 송신 중인 참조가 있는지
+static inline bool bcast_frame_shared(bcast_frame_t *f) {
+  return atomic_load_explicit(&f->refs, memory_order_acquire) > 1;
+}
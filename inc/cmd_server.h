@@ -0,0 +1,105 @@
+// app/cmd_server.h
+#pragma once
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "queue.h"
+#include "types.h"
+
+/*
+ * 명령 수신 서버 (Server -> RSU, local_port)
+ * - epoll 스레드 하나가 listen 소켓과 모든 연결을 처리 (non-blocking)
+ * - 연결은 유지됨: 한 연결에서 rsu3_packet_t(64B)를 연속으로 보내면 순서대로 잘라 처리
+ *   (명령마다 TCP handshake 불필요, 반쯤 온 프레임은 연결별 버퍼에 보관)
+ * - 느린 peer가 있어도 다른 연결의 명령은 막히지 않음
+ * - 검증(sec_wired_rx_strip) 통과한 명령은 rsu3_out_q로 (-> state manager)
+ * - rsu3_out_q가 가득 차면 그 연결만 읽기를 멈춤 (epoll에서 빼고 TCP 흐름 제어로 peer를 늦춤)
+ *   못 넣은 프레임은 연결 버퍼에 남겨 CMD_RESUME_US 뒤 다시 시도 (버리지 않음, IO 스레드도 안 막힘)
+ * - 지연 = 프레임 마지막 바이트를 읽은 recv 직후 ~ 큐 push 완료 (검증 + 전달)
+ */
+
+#define CMD_LAT_BUCKETS 32   // log2(ns) 구간, 분위수 근사용
+
+#ifndef CMD_RECV_BUF
+#define CMD_RECV_BUF 4096    // 연결별 수신 버퍼 = recv 1회로 읽는 양 (프레임 64개)
+#endif
+#ifndef CMD_RESUME_US
+#define CMD_RESUME_US 1000   // 큐가 차서 멈춘 연결을 다시 읽어 보는 간격
+#endif
+
+typedef struct {
+  uint64_t count;
+  uint64_t sum_ns;
+  uint64_t max_ns;
+} cmd_lat_t;
+
+// 연결 하나 (IO 스레드만 접근)
+typedef struct {
+  int fd;                 // -1 = 빈 슬롯
+  uint32_t peer_ip;       // network order
+  uint16_t peer_port;
+  uint8_t  buf[CMD_RECV_BUF];
+  uint32_t len;           // buf에 모인 바이트 (아직 큐로 못 넘긴 프레임 + 경계 전 조각)
+  bool     paused;        // 큐가 가득 차 epoll에서 뺌 (resume 타이머가 다시 넣음)
+  uint64_t t_rx;          // buf 앞 프레임을 읽은 시각 (지연 측정)
+  uint32_t bad_run;       // 연속 검증 실패
+  uint64_t opened_us;
+  uint64_t last_rx_us;
+  uint64_t frames;
+  uint64_t bad_frames;
+  uint64_t bytes;
+  cmd_lat_t lat;
+} cmd_conn_t;
+
+// 전체 통계 (IO 스레드만 갱신, 다른 스레드에서 읽으면 근사치)
+typedef struct {
+  uint64_t accepts;
+  uint64_t refused;       // cmd_max_conns 초과로 바로 닫은 연결
+  uint64_t closes;
+  uint64_t idle_closes;   // cmd_idle_timeout_ms 초과
+  uint32_t active;
+  uint32_t active_max;
+  uint64_t frames;        // 완성된 프레임
+  uint64_t bad_frames;    // 검증 실패
+  uint64_t dropped;       // 풀 부족으로 전달 못 함
+  uint64_t pauses;        // rsu3_out_q가 가득 차 연결 읽기를 멈춘 횟수
+  uint64_t bytes;
+  cmd_lat_t lat;
+  uint64_t lat_hist[CMD_LAT_BUCKETS];
+} cmd_server_stats_t;
+
+typedef struct {
+  const app_config_t *cfg;
+  bq_t *out_q;            // rsu3_payload_t*
+
+  int listen_fd;
+  int ep_fd;
+  int ev_fd;              // stop 통지
+  int tm_fd;              // idle 검사 주기 (timerfd, cmd_idle_timeout_ms = 0이면 -1)
+  int rs_fd;              // 멈춘 연결 재개 (timerfd one-shot, 멈춘 연결이 있을 때만 걸림)
+  pthread_t th;
+  bool started;
+  _Atomic bool running;
+
+  cmd_conn_t *conns;      // cmd_max_conns개 슬롯
+  uint32_t *free_slots;   // 빈 슬롯 스택
+  uint32_t n_free;
+  uint32_t max_conns;
+  uint32_t n_paused;
+
+  cmd_server_stats_t stats;
+} cmd_server_t;
+
+// listen 소켓 bind 실패 시 -1 (나머지 파이프라인은 계속 동작 가능)
+int  cmd_server_start(cmd_server_t *s, const app_config_t *cfg, bq_t *out_q);
+void cmd_server_stop(cmd_server_t *s);
+// 스레드 없이 구동 (event loop): open 후 cmd_server_fd(epoll fd)가 읽기 가능해지면 poll
+int  cmd_server_open(cmd_server_t *s, const app_config_t *cfg, bq_t *out_q);
+int  cmd_server_fd(const cmd_server_t *s);
+int  cmd_server_poll(cmd_server_t *s);   // 대기 없이 1회, 반환: 처리한 epoll 이벤트 수
+void cmd_server_get_stats(const cmd_server_t *s, cmd_server_stats_t *out);
+// hist에서 분위수 근사 (q: 0~1, 구간 상한 ns)
+uint64_t cmd_server_lat_quantile(const cmd_server_stats_t *st, double q);
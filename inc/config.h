@@ -2,21 +2,72 @@
 #pragma once
 #include <stdint.h>
 
+// 실행 구조 (pipeline_start)
+typedef enum {
+  RUNTIME_THREADS = 0,  // 스테이지마다 전용 스레드 (큐 condvar/futex로 깨움)
+  RUNTIME_EVLOOP,       // epoll 루프 스레드 1개가 소켓/큐/타이머를 readiness 기준으로 처리
+} runtime_mode_t;
+
 typedef struct {
   uint32_t rsu_id;
+  runtime_mode_t runtime_mode;
+  unsigned int trace_enable;    // 1: 패킷 단계별 지연 추적 (trace.h, 실행 중 SIGUSR1로 전환)
+  const char *stats_shm_name;   // 실행 중 카운터 공유 메모리 이름 (NULL: 끔, stats_shm.h / rsu-top)
+  int32_t rsu_lat;              // RSU 위치 (1e-6도, 사고-RSU 거리 기준점, RSU_LAT/RSU_LON)
+  int32_t rsu_lon;
+  const char *zones_path;       // 담당영역 파일 (NULL: 영역 판정 없이 통과, 형식은 filter.h)
+  const char *filter_rules_path; // light filter 규칙 파일 (NULL: 기본 규칙, 문법은 filter.h)
+  const char *replay_path;      // WL-1 캡처 재생 후 종료 (NULL: 일반 실행, pcap/raw 형식은 replay.h)
+  double replay_speed;          // 재생 속도 (0: 최대 속도, 1: 캡처 시각 그대로, 2: 2배속 ...)
+  unsigned int replay_tx;       // 1: 재생 중에도 RSU-1 송신/서버 보고를 실제로 내보냄 (0: 세고 버림)
 
   // UDP 수신
   uint16_t wl1_listen_port;     // 예: 30000 (네 환경에 맞게)
   const char *wl1_bind_ip;      // "0.0.0.0"
+  unsigned int wl1_rx_batch;      // recvmmsg 1회당 최대 datagram 수 (<=1: recvfrom 단건 모드)
+  unsigned int wl1_rx_timeout_ms; // 수신 대기 상한 (트래픽 없을 때 running 재확인 주기)
+  unsigned int wl1_workers;       // WL-1 워커 수 (accident_id로 샤딩, 1..WL1_MAX_WORKERS)
+  unsigned int wl1_sig_cache;     // 서명 검증 결과 캐시 (0: 끔, 매 패킷 검증)
+  unsigned int wl1_dedup_window_ms; // RX 중복 억제 창 (0: 끔)
+  unsigned int wl1_dedup_sets;      // RX 중복 억제 set 수 (x4 way)
+
+  // UDP 송신 (RSU-1 브로드캐스트)
+  const char *wl1_tx_ip;        // "255.255.255.255" (루프백 벤치마크 시 "127.0.0.1")
+  uint16_t wl1_tx_port;         // 30001
+  unsigned int wl1_tx_batch;    // sendmmsg 1회당 최대 패킷 수 (<=1: sendto 단건 모드)
 
   // TCP (D3-G client -> Server PC)
   const char *server_ip;        // 예: "192.168.0.10"
   uint16_t server_port;         // 20615
   uint16_t local_port;          // 20905
+  unsigned int wired_tx_batch;    // 한 번에 내보내는 최대 보고 수 (writev 1회)
+  unsigned int wired_tx_delay_us; // 첫 보고 이후 더 모으며 기다리는 상한 (0: 쌓인 것만 즉시)
+  unsigned int wired_tx_cork;     // 1: flush 사이 TCP_CORK로 세그먼트를 꽉 채움 (기본은 TCP_NODELAY만)
+  unsigned int wired_tx_buf;      // 송신 버퍼 (보고 수). 연결이 끊긴 동안에도 여기까지 보관, 넘치면 새 보고 버림
+  unsigned int wired_connect_timeout_ms;
+  unsigned int wired_reconnect_min_ms; // 재접속 backoff (실패마다 2배, +-25% jitter)
+  unsigned int wired_reconnect_max_ms;
+  unsigned int cmd_max_conns;       // 명령 서버 동시 연결 상한 (넘으면 accept 후 바로 닫음)
+  unsigned int cmd_backlog;         // listen backlog
+  unsigned int cmd_idle_timeout_ms; // 이 시간 동안 아무것도 안 온 연결은 닫음 (0 = 끄기)
+
+  // 사고 테이블 (state manager)
+  uint32_t acc_table_cap;       // 초기 슬롯 수 (2의 거듭제곱으로 올림)
+  uint32_t acc_table_max;       // grow 상한
 
   // GPIO (libgpiod)
   const char *gpiochip;         // 예: "gpiochip0"
   unsigned int led_line;        // 라인 번호
 } app_config_t;
 
+// 배포마다 다른 항목은 환경변수로 덮어씀 (재빌드 불필요)
+//   RSU_ZONES -> zones_path, RSU_LAT/RSU_LON (도 단위 소수) -> rsu_lat/rsu_lon,
+//   RSU_FILTER_RULES -> filter_rules_path
+//   RSU_RUNTIME=evloop|threads -> runtime_mode
+//   RSU_TRACE=1 -> trace_enable
+//   RSU_STATS_SHM=/name|off -> stats_shm_name
+//   RSU_SERVER_IP -> server_ip (예: 127.0.0.1 + rsu-load 스텁 서버)
+//   RSU_WL1_TX_IP, RSU_WL1_TX_PORT -> wl1_tx_ip, wl1_tx_port
+//   RSU_REPLAY=file.pcap|file.raw -> replay_path, RSU_REPLAY_SPEED -> replay_speed,
+//   RSU_REPLAY_TX=1 -> replay_tx
 int load_default_config(app_config_t *cfg);
@@ -1,6 +1,8 @@
 #ifndef DEBUG_H
 #define DEBUG_H
 
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <sys/time.h>
 #include <time.h>
@@ -14,13 +16,79 @@ typedef enum {
 
 extern log_level_t g_log_level;
 
+/*
+ * 비동기 로거
+ * - 호출 스레드는 자기 전용 링(SPSC, lock-free)에 포맷된 레코드를 넣고 끝 (I/O, 락 없음)
+ * - flusher 스레드 하나가 모든 링을 시각 순으로 모아 stdout/stderr에 write
+ *   (줄 단위로 한 번에 쓰므로 스레드 간 출력이 섞이지 않음)
+ * - 시각 "HH:MM:SS"는 flusher가 초가 바뀔 때만 다시 계산
+ * - 링이 가득 차면 버리고 개수만 셈 (flusher가 1초마다 보고)
+ * - 호출 위치(callsite)별로 초당 LOG_RL_PER_SEC줄까지만, 넘친 줄 수는 다음 줄 끝에 표시
+ * - LOG_COMPILE_LEVEL 보다 상세한 레벨의 매크로는 컴파일 시 제거 (make LOG_LEVEL=1 등)
+ */
+
+// 0=ERROR 1=WARN 2=INFO 3=DEBUG
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 3
+#endif
+
+// callsite별 초당 상한 (0 = 제한 없음)
+#ifndef LOG_RL_PER_SEC
+#define LOG_RL_PER_SEC 200
+#endif
+
+// callsite 상태 (매크로가 호출 위치마다 static으로 하나씩 만듦)
+typedef struct {
+    _Atomic uint64_t sec;
+    _Atomic uint32_t count;
+    _Atomic uint32_t suppressed;
+} log_site_t;
+
 void debug_init();
-void debug_log(const char *level, const char *file, int line, const char *fmt, ...);
+void debug_log(const char *level, const char *file, int line, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+// file != NULL: "[HH:MM:SS.mmm][tag][file:line] msg", file == NULL: "[tag] msg"
+// fd: 1(stdout) 또는 2(stderr). site = NULL이면 rate limit 없음
+void log_emit(log_site_t *site, int fd, const char *tag, const char *file, int line,
+              const char *fmt, ...) __attribute__((format(printf, 6, 7)));
+
+// 지금까지 넣은 레코드가 모두 write될 때까지 대기 (최대 1초, stdout 전환 전 등)
+void log_flush(void);
+// flusher 종료 + 남은 레코드 출력, 이후 로그는 호출 스레드에서 직접 write (exit 시 자동 호출)
+void log_shutdown(void);
+// 링이 가득 차 버린 줄 수 (전체 누적)
+uint64_t log_dropped(void);
+
+#define LOG_SITE_EMIT_(fd, tag, file, line, fmt, ...)                     \
+    do {                                                                  \
+        static log_site_t log_site_;                                      \
+        log_emit(&log_site_, fd, tag, file, line, fmt, ##__VA_ARGS__);    \
+    } while (0)
+
+// 제거된 레벨: 포맷 검사만 하고 코드는 남기지 않음
+#define LOG_ELIDED_(fmt, ...) \
+    do { if (0) printf(fmt, ##__VA_ARGS__); } while (0)
 
 // 매크로: 파일명, 라인번호, 가변인자 전달
-#define DBG_ERR(fmt, ...)   debug_log("ERROR", __FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define DBG_WARN(fmt, ...)  do { if (g_log_level >= LOG_WARN)  debug_log("WARN ", __FILE__, __LINE__, fmt, ##__VA_ARGS__); } while(0)
-#define DBG_INFO(fmt, ...)  do { if (g_log_level >= LOG_INFO)  debug_log("INFO ", __FILE__, __LINE__, fmt, ##__VA_ARGS__); } while(0)
-#define DBG_DEBUG(fmt, ...) do { if (g_log_level >= LOG_DEBUG) debug_log("DEBUG", __FILE__, __LINE__, fmt, ##__VA_ARGS__); } while(0)
+#define DBG_ERR(fmt, ...)   LOG_SITE_EMIT_(1, "ERROR", __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+
+#if LOG_COMPILE_LEVEL >= 1
+#define DBG_WARN(fmt, ...)  do { if (g_log_level >= LOG_WARN)  LOG_SITE_EMIT_(1, "WARN ", __FILE__, __LINE__, fmt, ##__VA_ARGS__); } while(0)
+#else
+#define DBG_WARN(fmt, ...)  LOG_ELIDED_(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= 2
+#define DBG_INFO(fmt, ...)  do { if (g_log_level >= LOG_INFO)  LOG_SITE_EMIT_(1, "INFO ", __FILE__, __LINE__, fmt, ##__VA_ARGS__); } while(0)
+#else
+#define DBG_INFO(fmt, ...)  LOG_ELIDED_(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= 3
+#define DBG_DEBUG(fmt, ...) do { if (g_log_level >= LOG_DEBUG) LOG_SITE_EMIT_(1, "DEBUG", __FILE__, __LINE__, fmt, ##__VA_ARGS__); } while(0)
+#else
+#define DBG_DEBUG(fmt, ...) LOG_ELIDED_(fmt, ##__VA_ARGS__)
+#endif
 
-#endif
\ No newline at end of file
+#endif
@@ -1,23 +1,133 @@
 #pragma once
 #include <stdbool.h>
 #include <stdint.h>
+#include "config.h"
 #include "types.h"
 
 /*
- * filter.c는 light+heavy filter를 묶은 모듈.
- * - light: length/ttl/ver/msg_type 같은 빠른 컷
- * - heavy: 담당영역/방향/심각도 등 상대적으로 무거운 판정
+ * filter.c / filter_rules.c는 light+heavy filter를 묶은 모듈.
+ * - light: header/accident 필드 규칙 (ttl/ver/msg_type/severity 같은 빠른 컷, filter_rules.c)
+ *          규칙은 시작 시 술어 프로그램으로 컴파일, 관측된 탈락률 순으로 재배치
+ *          wireless RX가 수신 배치 단위로 filter_light_batch (SIMD, 런타임 선택)
+ *          규칙 프로그램과 규칙별 통계는 프로세스 전역 (ctx 없이 호출, filter_rules.c)
+ * - heavy: 담당영역(geo-fence)/진행 방향 판정 + 사고-RSU 거리 (WL-1 worker, filter_ctx_t)
+ *
+ * 좌표는 패킷과 같은 int32 1e-6도 (37000000 = 37.0도)
+ * 담당영역은 cfg->zones_path 파일에서 읽고 격자 인덱스로 조회 (영역 수와 무관한 비용)
+ * 거리는 RSU 위도 기준 equirectangular 근사를 고정소수점 정수 연산으로 (패킷당 libm 없음)
  */
 
+#define GEO_UNITS_PER_DEG 1000000
+
+typedef struct {
+  int32_t lat, lon;
+} geo_pt_t;
+
+typedef enum {
+  ZONE_RECT = 0,
+  ZONE_POLY,
+} zone_kind_t;
+
+typedef struct {
+  uint8_t kind;          // zone_kind_t
+  bool dir_any;          // 방향 무관
+  uint16_t dir_deg;      // 진행 방향 중심 (0..359, 북=0 시계방향)
+  uint16_t dir_tol;      // 허용 오차 (도)
+  int32_t lat_min, lon_min, lat_max, lon_max;  // bbox (rect는 영역 그 자체)
+  uint32_t v_off, n_v;   // poly 꼭짓점 (ctx->verts[v_off..v_off+n_v))
+} geo_zone_t;
+
 typedef struct {
   uint32_t rsu_id;
-  // TODO: rsu lat/lon, 직사각 담당영역 파라미터, direction 등 필요 시 추가
+
+  // 거리 계산 (RSU 위치 기준, 1e-6도 -> mm, Q16)
+  int32_t rsu_lat, rsu_lon;
+  int64_t k_lat_q16, k_lon_q16;
+
+  // 담당영역 (0개면 영역 판정 없이 통과)
+  geo_zone_t *zones;
+  uint32_t n_zones, cap_zones;
+  geo_pt_t *verts;
+  uint32_t n_verts, cap_verts;
+
+  // 격자 인덱스 (filter_build_index), 셀별 영역 목록은 CSR
+  int32_t g_lat0, g_lon0;
+  int32_t g_cell_lat, g_cell_lon;
+  uint32_t g_rows, g_cols;
+  uint32_t *g_start;     // g_rows*g_cols + 1
+  uint32_t *g_zone;
 } filter_ctx_t;
 
-void filter_init(filter_ctx_t *ctx, uint32_t rsu_id);
+// cfg의 RSU 위치로 초기화하고 cfg->zones_path가 있으면 읽어서 인덱스까지 생성
+int  filter_init(filter_ctx_t *ctx, const app_config_t *cfg);
+void filter_destroy(filter_ctx_t *ctx);
+
+/*
+ * 영역 파일 (한 줄에 하나, '#' 이후 주석, 좌표는 도 단위 소수, 위도 ±90 경도 ±180):
+ *   rect <lat1> <lon1> <lat2> <lon2>               [dir <deg> <tol>]
+ *   poly <lat1> <lon1> <lat2> <lon2> <lat3> <lon3> ... [dir <deg> <tol>]
+ */
+int  filter_load_zones(filter_ctx_t *ctx, const char *path);
+int  filter_add_rect(filter_ctx_t *ctx, geo_pt_t a, geo_pt_t b, int dir_deg, int dir_tol);
+int  filter_add_poly(filter_ctx_t *ctx, const geo_pt_t *v, uint32_t n, int dir_deg, int dir_tol);
+int  filter_build_index(filter_ctx_t *ctx);   // 영역 추가 후 호출
+
+// (lat, lon, 진행 방향)을 포함하는 영역 번호, 없으면 -1
+int  filter_find_zone(const filter_ctx_t *ctx, int32_t lat, int32_t lon, uint16_t dir);
+int  filter_find_zone_linear(const filter_ctx_t *ctx, int32_t lat, int32_t lon, uint16_t dir); // 검증/벤치용
+uint32_t filter_distance_m(const filter_ctx_t *ctx, int32_t lat, int32_t lon);
 
 /*
  * light + heavy 모두 통과하면 true.
- * out_dist_m: (필요시) 사고-현재RSU 거리 산출 (지금은 스텁)
+ * out_dist_m: 사고-현재RSU 거리 (m)
+ */
+bool filter_pass_all(const filter_ctx_t *ctx, const void *raw_pkt, uint32_t *out_dist_m);
+
+// 단계별 (light는 RX, heavy는 WL-1 worker)
+bool filter_pass_light(const void *raw_pkt);
+bool filter_pass_heavy(const filter_ctx_t *ctx, const void *raw_pkt, uint32_t *out_dist_m);
+
+/*
+ * light 규칙 (';' 또는 줄바꿈으로 구분, '#' 이후 주석)
+ *   <field> ==|!=|<|<=|>|>= <int>
+ *   <field> [not] in <lo>..<hi>
+ *   <field> [not] in {a, b, ...}
+ * field: version msg_type ttl / sender_id send_time sender_lat sender_lon sender_alt /
+ *        direction lane severity accident_time accident_id lat lon alt (8바이트 필드는 int64 비교)
+ * 모든 규칙을 통과해야 light 통과. 기본값은 msg_type != 1; ttl == 3; version == 1; severity >= 2
+ * 규칙 교체는 filter 호출 스레드들이 돌기 전에 (실패하면 기존 규칙 유지)
+ */
+#ifndef FILTER_RULES_MAX
+#define FILTER_RULES_MAX 16   // 평가 순서를 4bit x 16 워드 하나에 담음
+#endif
+#define FILTER_SET_MAX   16
+#define FILTER_RULE_TEXT 48
+
+typedef struct {
+  char text[FILTER_RULE_TEXT];
+  uint64_t evals;     // 이 규칙까지 온 패킷 수
+  uint64_t rejects;   // 이 규칙에서 탈락한 패킷 수
+} filter_rule_stats_t;
+
+int  filter_set_rules(const char *text);          // NULL: 기본 규칙
+int  filter_load_rules(const char *path);
+void filter_set_rule_reorder(bool on);            // 탈락률 기반 순서 재배치 (기본 켬)
+int  filter_get_rule_stats(filter_rule_stats_t *out, int max);  // 현재 평가 순서대로, 반환: 규칙 수
+uint64_t filter_rule_reorders(void);
+void filter_reset_rule_stats(void);
+
+/*
+ * batch light filter: pkts[0..n) 중 light 통과한 것의 비트 마스크 (bit i = pkts[i], n <= 64)
+ * 구현은 첫 호출 시 CPU에 맞춰 선택 (AVX2 > NEON > SSE2 > scalar)
  */
-bool filter_pass_all(const void *raw_pkt, uint32_t rsu_id, uint32_t *out_dist_m);
+typedef enum {
+  FILTER_IMPL_AUTO = 0,
+  FILTER_IMPL_SCALAR,
+  FILTER_IMPL_SSE2,
+  FILTER_IMPL_AVX2,
+  FILTER_IMPL_NEON,
+} filter_impl_t;
+
+uint64_t filter_light_batch(const wl1_packet_t *const *pkts, int n);
+int  filter_set_batch_impl(filter_impl_t impl);   // 이 CPU/빌드에서 미지원이면 -1
+const char* filter_batch_impl_name(void);
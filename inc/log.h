@@ -1,6 +1,19 @@
 #pragma once
 #include <stdio.h>
 
-#define LOGI(fmt, ...) fprintf(stdout, "[I] " fmt "\n", ##__VA_ARGS__)
-#define LOGW(fmt, ...) fprintf(stdout, "[W] " fmt "\n", ##__VA_ARGS__)
-#define LOGE(fmt, ...) fprintf(stderr, "[E] " fmt "\n", ##__VA_ARGS__)
+#include "debug.h"
+
+// 출력 형식은 "[I] msg" 그대로, 비동기 로거(debug.h)를 거침
+#if LOG_COMPILE_LEVEL >= 2
+#define LOGI(fmt, ...) LOG_SITE_EMIT_(1, "I", NULL, 0, fmt, ##__VA_ARGS__)
+#else
+#define LOGI(fmt, ...) LOG_ELIDED_(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= 1
+#define LOGW(fmt, ...) LOG_SITE_EMIT_(1, "W", NULL, 0, fmt, ##__VA_ARGS__)
+#else
+#define LOGW(fmt, ...) LOG_ELIDED_(fmt, ##__VA_ARGS__)
+#endif
+
+#define LOGE(fmt, ...) LOG_SITE_EMIT_(2, "E", NULL, 0, fmt, ##__VA_ARGS__)
@@ -0,0 +1,50 @@
+// common/mempool.h
+#pragma once
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * 고정크기 객체 풀 (lock-free)
+ * - init 시점에 count개 슬롯을 한 번에 선할당, 이후 malloc/free 없음
+ * - free-list는 tag 붙은 Treiber stack (ABA 방지)
+ * - 풀이 바닥나면 calloc으로 fallback 하고 exhausted 카운트 증가 (mempool_try_alloc은 NULL)
+ *   (mempool_free는 풀 밖 주소면 free()로 넘기므로 섞여도 안전)
+ */
+
+typedef struct {
+  const char *name;
+  size_t obj_size;            // 정렬 반영된 슬롯 크기
+  uint32_t count;
+  uint8_t *base;
+  _Atomic uint32_t *next;     // 슬롯별 free-list 링크 (idx+1, 0 = 끝)
+  _Atomic uint64_t head;      // [tag:32 | idx+1:32]
+
+  _Atomic uint32_t in_use;
+  _Atomic uint32_t high_water;
+  _Atomic uint64_t exhausted;
+} mempool_t;
+
+typedef struct {
+  uint32_t capacity;
+  uint32_t in_use;
+  uint32_t high_water;
+  uint64_t exhausted;
+} mempool_stats_t;
+
+int   mempool_init(mempool_t *mp, const char *name, size_t obj_size, uint32_t count);
+void  mempool_destroy(mempool_t *mp);
+
+void* mempool_alloc(mempool_t *mp);          // 0으로 초기화된 객체
+// fallback 없이 풀 슬롯만 (바닥나면 NULL, exhausted도 안 셈). 반환될 때까지 기다리려는 쪽용
+void* mempool_try_alloc(mempool_t *mp);
+void  mempool_free(mempool_t *mp, void *obj);
+
+void  mempool_get_stats(mempool_t *mp, mempool_stats_t *st);
+
+// 풀 슬롯 번호 [0, count), 풀 밖(fallback calloc) 객체면 UINT32_MAX
+static inline uint32_t mempool_index(const mempool_t *mp, const void *obj) {
+  uintptr_t off = (uintptr_t)obj - (uintptr_t)mp->base;
+  if (!mp->base || off >= (uintptr_t)mp->obj_size * mp->count) return UINT32_MAX;
+  return (uint32_t)(off / mp->obj_size);
+}
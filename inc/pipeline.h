@@ -10,20 +10,31 @@
 #include "wired_client.h"
 #include "state_manager.h"
 #include "led.h"
+#include "wl1_worker.h"
+#include "filter.h"
 
 typedef struct {
   app_config_t cfg;
 
   // Queues
-  bq_t Q_wl1_raw;     // wl1_msg_t*
+  bq_t Q_wl1_raw[WL1_MAX_WORKERS]; // wl1_packet_t* (워커별 샤드, accident_id 기준)
+  int  n_wl1_workers;
   bq_t Q_sm_events;   // sm_event_t*
   bq_t Q_tx_cmd;      // tx_cmd_t*
   bq_t Q_rsu3_in;     // rsu3p_msg_t*
-  bq_t Q_air;         // uint8_t[256]*
+  bq_t Q_air;         // bcast_frame_t*
+
+  // WL-1 RX 중복 억제 (wireless/worker/SM 공유, lock-free)
+  rx_dedup_t dedup;
+
+  // heavy filter 컨텍스트 (담당영역 + RSU 위치)
+  filter_ctx_t filter;
 
   // Scheduler thread
   scheduler_t sched;
   pthread_t th_sched;
+  bool sched_started;
+  sched_timer_id_t stats_timer;   // 공유 메모리 통계 발행 (STATS_PUBLISH_MS 주기)
 
   // HW
   led_handle_t *led;
@@ -31,16 +42,31 @@ typedef struct {
   // IO
   wireless_t wireless;      // UDP RX/TX 묶음
   wired_client_t wc;        // TCP + TxManager
+  bool wc_ready;
 
   // State machine
   state_manager_t sm;
 
   // Workers
-  pthread_t th_wl1_worker;
+  wl1_worker_t wl1_workers[WL1_MAX_WORKERS];
   pthread_t th_rsu3_dispatch;
 
+  // Event loop (RUNTIME_EVLOOP): 위 스테이지를 스레드 없이 이 루프 하나가 구동
+  pthread_t th_loop;
+  bool loop_started;
+  int loop_ep_fd;
+  int loop_ev_fd;           // stop + Q_sm_events 통지 (루프 밖에서 넣은 이벤트)
+  int loop_tm_fd;           // 스케줄러 다음 마감 (timerfd, 절대시각)
+  uint64_t loop_armed_ms;   // loop_tm_fd에 걸린 tick (UINT64_MAX = 해제)
+  struct {
+    uint64_t wakeups, rx, wired, timer, moved;
+  } loop_stats;
+
   bool running;
 } pipeline_t;
 
+// 기본 설정(load_default_config)으로 시작
 int  pipeline_start(pipeline_t *p);
+// 설정을 지정해 시작 (cfg는 복사됨, runtime_mode로 스레드/이벤트 루프 선택)
+int  pipeline_start_with(pipeline_t *p, const app_config_t *cfg);
 void pipeline_stop(pipeline_t *p);
\ No newline at end of file
@@ -0,0 +1,24 @@
+// app/pools.h
+#pragma once
+#include "mempool.h"
+
+/*
+ * 핫패스 고정크기 객체 풀 모음
+ * - pipeline_start에서 선할당, pipeline_stop에서 해제
+ * - 각 모듈은 calloc/free 대신 g_pools의 해당 풀을 사용
+ */
+
+typedef struct {
+  mempool_t wl1_pkt;   // wl1_packet_t  (wireless RX -> WL-1 worker)
+  mempool_t rsu2p;     // rsu2_payload_t (WL-1 worker -> SM -> wired TX)
+  mempool_t rsu3p;     // rsu3_payload_t (wired RX -> SM)
+  mempool_t sm_ev;     // sm_event_t
+  mempool_t tx_cmd;    // tx_cmd_wired_t
+  mempool_t bframe;    // bcast_frame_t (사고별 재전파 캐시, Q_air)
+} pkt_pools_t;
+
+extern pkt_pools_t g_pools;
+
+int  pools_init(void);
+void pools_destroy(void);
+void pools_log_stats(void);
@@ -1,6 +1,7 @@
 // common/queue.h
 #pragma once
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -10,20 +11,90 @@ typedef enum {
   Q_DROP_HEAD
 } q_full_policy_t;
 
+/*
+ * 큐 구현 방식 (push/pop 계약과 full 정책은 동일)
+ * - BQ_MUTEX: mutex + condvar. 생산자/소비자 수 제한 없음
+ * - BQ_RING : lock-free bounded ring (Vyukov 방식 시퀀스 셀).
+ *             SPSC/MPSC 링크(Q_wl1_raw, Q_air 등)용. 비어있을 때만 소비자가
+ *             futex로 잠들고, 생산자는 잠든 쪽이 있을 때만 wake syscall.
+ *             cap은 2의 거듭제곱으로 올림.
+ */
+typedef enum {
+  BQ_MUTEX = 0,
+  BQ_RING
+} bq_backend_t;
+
+// Q_DROP_HEAD로 밀려난 item 처리 (ex. 풀 반환). BQ_MUTEX에선 큐 잠금 상태에서 호출됨
+typedef void (*bq_drop_fn_t)(void *ctx, void *item);
+
 typedef struct {
-  void **buf;
-  int cap, head, tail, size;
+  _Atomic uint64_t seq;
+  void *item;
+} bq_cell_t;
+
+typedef struct {
+  bq_backend_t backend;
   q_full_policy_t policy;
+  int cap;
+
+  // BQ_MUTEX
+  void **buf;
+  int head, tail, size;
   pthread_mutex_t mtx;
   pthread_cond_t not_empty;
   pthread_cond_t not_full;
-  uint64_t drop_cnt;
-  bool stop;
+
+  // BQ_RING
+  bq_cell_t *cells;
+  uint64_t mask;
+  _Alignas(64) _Atomic uint64_t enq_pos;
+  _Alignas(64) _Atomic uint64_t deq_pos;
+  _Alignas(64) _Atomic uint32_t ne_futex;   // 1 = 비어서 잠든 소비자 있음 (futex word)
+  _Atomic uint32_t nf_futex;                // 1 = 가득 차서 잠든 생산자 있음 (futex word)
+
+  // 배치 통계 (평균 배치 크기 = items / calls)
+  _Alignas(64) _Atomic uint64_t push_calls, push_items;
+  _Alignas(64) _Atomic uint64_t pop_calls, pop_items;
+
+  _Atomic uint64_t drop_cnt;
+  _Atomic uint32_t depth_pub;   // BQ_MUTEX: 잠금 안에서 갱신한 size (잠금 없이 읽기용)
+  _Atomic uint32_t high_water;  // 최고 깊이 (push 시 갱신)
+  bq_drop_fn_t drop_fn;
+  void *drop_ctx;
+  int notify_fd;      // BQ_MUTEX: 비어 있다가 들어오면 eventfd에 1 (-1 = 없음)
+  _Atomic bool stop;
 } bq_t;
 
 int  bq_init(bq_t *q, int cap, q_full_policy_t policy);
+int  bq_init_ring(bq_t *q, int cap, q_full_policy_t policy);
+void bq_set_drop_fn(bq_t *q, bq_drop_fn_t fn, void *ctx);
+// epoll 루프 소비자용: 빈 큐에 item이 들어오거나 stop되면 fd(eventfd)에 1을 씀
+// 소비자는 fd를 읽은 뒤 bq_try_pop_many로 빌 때까지 꺼내야 함. BQ_MUTEX만 (-1: 미지원)
+int  bq_set_notify_fd(bq_t *q, int fd);
 void bq_stop(bq_t *q);
 void bq_destroy(bq_t *q);
 bool bq_push(bq_t *q, void *item);
+// 정책과 무관하게 대기/버림 없이 1개 (가득 찼거나 stop이면 false, item은 호출자 소유, drop으로 안 셈)
+// 가득 차면 생산자가 스스로 물러나야 하는 IO 루프용
+bool bq_try_push(bq_t *q, void *item);
+// items[0..n) 를 한 번의 임계구역으로 push. 반환값 = 들어간 개수 (나머지 items[ret..n)은 호출자 소유)
+int  bq_push_many(bq_t *q, void **items, int n);
 void* bq_pop(bq_t *q);
+// 최소 1개가 들어올 때까지 대기한 뒤, 그 시점에 쌓여 있는 것을 최대 max개까지 꺼냄. 0 = stop
+int   bq_pop_many(bq_t *q, void **out, int max);
+// bq_pop_many + 대기 상한 (timeout_us 안에 아무것도 없으면 0, stop이어도 0, 0us = 대기 없이)
+int   bq_pop_many_timed(bq_t *q, void **out, int max, uint32_t timeout_us);
+// 대기 없이 지금 쌓인 것만 최대 max개 (event loop용, 빈 큐면 0, spin/syscall 없음)
+int   bq_try_pop_many(bq_t *q, void **out, int max);
 uint64_t bq_drop_count(bq_t *q);
+// 현재 깊이 (잠금 없이, 근사치)
+uint32_t bq_depth(bq_t *q);
+
+typedef struct {
+  uint64_t push_calls, push_items;
+  uint64_t pop_calls, pop_items;
+  uint64_t drops;
+  uint32_t cap, depth, high_water;
+} bq_stats_t;
+
+void bq_get_stats(bq_t *q, bq_stats_t *st);
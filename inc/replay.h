@@ -0,0 +1,22 @@
+// app/replay.h
+#pragma once
+#include "pipeline.h"
+
+/*
+ * WL-1 캡처 재생 (WL-1 수신 포트를 열지 않고 Q_wl1_raw 샤드로 직접 주입 -> 오프라인 처리량/프로파일링)
+ * - 입력 (파일 앞 4바이트로 구분)
+ *   pcap : Ethernet(VLAN) / Linux cooked v1,v2 / raw IPv4 / BSD loopback, us/ns 타임스탬프
+ *          IPv4 UDP 중 dst port == wl1_listen_port인 payload만 (나머지는 skipped)
+ *          pcapng는 미지원 (editcap -F pcap in.pcapng out.pcap)
+ *   raw  : 256B WL-1 패킷을 그대로 이어 붙인 파일 (타임스탬프 없음 -> 항상 최대 속도)
+ * - speed 0  : 최대 속도. 패킷 버퍼/샤드 큐가 차면 기다림 (drop 없이 처리 경로 한계를 봄)
+ *   speed > 0: 캡처 시각 간격을 1/speed로 줄여 재생 (1 = 실시간), 큐가 차면 실제 수신처럼 drop
+ * - 주입 이후는 실제 수신과 같음: 크기 검사 -> light -> RX dedup -> worker -> SM -> wired
+ * - 송신은 기본으로 막음: RSU-1 브로드캐스트와 서버 보고(명령 서버 포함)를 열지 않고 세고 버림
+ *   (현장 캡처를 재생해도 사고 경보가 방송/상위 보고되지 않음). RSU_REPLAY_TX=1이면 실제로 보냄
+ * - 끝나면 파이프라인이 빌 때까지 기다린 뒤 처리량과 단계별 통과/탈락, 큐 drop을 LOGI
+ * - 스레드 모드 전용 (event loop는 주입된 샤드 큐를 깨워 줄 통지가 없음)
+ */
+
+// stop: 0이 아니게 되면 재생 중단 (SIGINT 플래그). 반환: 0 = 성공, -1 = 파일/모드 오류
+int replay_run(pipeline_t *p, const char *path, double speed, volatile int *stop);
@@ -0,0 +1,50 @@
+// app/rx_dedup.h
+#pragma once
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * WL-1 RX 중복 억제: 최근 SM으로 넘긴 (sender_id, accident_id) 집합
+ * - wireless RX가 조회만 함 -> 적중하면 할당/큐 전달 없이 버림
+ * - 등록은 WL-1 worker가 filter/서명 검증/SM 큐 push까지 성공한 뒤에만
+ *   (검증 실패한 위조 패킷이 정상 보고를 막지 못하도록)
+ * - 항목은 window_ms 동안만 유효 -> 창마다 1개는 SM까지 가서 재확인됨
+ * - SM이 사고를 해제(OFF)하면 rx_dedup_forget으로 해당 사고의 항목을 무효화
+ *   (accident_id 해시별 epoch 증가, 같은 epoch 칸을 쓰는 다른 사고는 한 번 더 통과할 뿐)
+ * - 4-way set associative, 항목 = 64bit 워드 하나 [fp:40 | epoch:8 | tick:16]
+ *   (tick = ms >> 6), 모든 접근은 relaxed atomic (잠금 없음)
+ */
+
+#define RX_DEDUP_WAYS   4
+#define RX_DEDUP_EPOCHS 1024
+
+typedef struct {
+  _Atomic uint64_t *slots;   // n_sets * RX_DEDUP_WAYS
+  uint32_t set_mask;
+  uint32_t window_ticks;
+  _Atomic uint8_t epoch[RX_DEDUP_EPOCHS];
+
+  _Alignas(64) _Atomic uint64_t suppressed;  // RX에서 버린 수
+  _Atomic uint64_t passed;                   // RX 조회 후 통과
+  _Alignas(64) _Atomic uint64_t inserted;    // worker 등록
+  _Atomic uint64_t forgets;                  // SM 해제 통지
+} rx_dedup_t;
+
+typedef struct {
+  uint64_t suppressed;
+  uint64_t passed;
+  uint64_t inserted;
+  uint64_t forgets;
+} rx_dedup_stats_t;
+
+// n_sets는 2의 거듭제곱으로 올림. window_ms == 0 이면 비활성 (모든 호출이 no-op)
+int  rx_dedup_init(rx_dedup_t *d, uint32_t n_sets, uint32_t window_ms);
+void rx_dedup_destroy(rx_dedup_t *d);
+
+// 창 안에 이미 넘긴 보고면 true (호출 측이 버림)
+bool rx_dedup_seen(rx_dedup_t *d, uint32_t sender_id, uint64_t accident_id, uint64_t now_ms);
+void rx_dedup_insert(rx_dedup_t *d, uint32_t sender_id, uint64_t accident_id, uint64_t now_ms);
+void rx_dedup_forget(rx_dedup_t *d, uint64_t accident_id);
+
+void rx_dedup_get_stats(rx_dedup_t *d, rx_dedup_stats_t *st);
@@ -2,27 +2,74 @@
 #pragma once
 #include <pthread.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+/*
+ * 타이머 스케줄러 (hierarchical timing wheel)
+ * - 1 tick = 1ms (now_ms_monotonic 기준), 256 슬롯 x 4 레벨 (~49일 범위, 그 이상은 재배치)
+ * - 등록/취소 O(1), 타이머 수 상한 없음 (노드 배열은 필요 시 2배로 grow)
+ * - 주기 타이머는 콜백 후 위상 유지하며 자동 재등록
+ * - 대기는 CLOCK_MONOTONIC condvar (벽시계 변경에 영향 없음)
+ * - 콜백은 scheduler_thread(또는 scheduler_run_due 호출자)에서 잠금 없이 호출됨
+ */
+
 typedef void (*timer_cb_t)(void *arg);
 
+// 타이머 핸들 (0 = 무효). 재사용된 슬롯과 구분되도록 세대 번호 포함
+typedef uint64_t sched_timer_id_t;
+
 typedef struct {
-  uint64_t due_ms;
+  uint64_t expires;   // tick(ms)
+  uint64_t period;    // 0 = 1회성
   timer_cb_t cb;
   void *arg;
-} timer_item_t;
+  uint32_t next, prev; // 슬롯 리스트 링크 (idx+1, 0 = 없음)
+  uint32_t gen;
+  uint16_t list;       // 속한 리스트 (휠 슬롯 번호 또는 fire 리스트)
+  uint8_t state;
+} sched_node_t;
+
+#define SCHED_LEVELS     4
+#define SCHED_SLOT_BITS  8
+#define SCHED_SLOTS      (1u << SCHED_SLOT_BITS)
 
 typedef struct {
-  timer_item_t *heap;
-  size_t size, cap;
+  sched_node_t *nodes;
+  uint32_t n_nodes;      // 할당된 노드 수
+  uint32_t free_head;    // 빈 노드 리스트 (idx+1)
+
+  // heads[level * SCHED_SLOTS + slot], 마지막 하나는 만료되어 실행 대기 중인 fire 리스트
+  uint32_t heads[SCHED_LEVELS * SCHED_SLOTS + 1];
+  uint64_t occupied[SCHED_LEVELS][SCHED_SLOTS / 64];
+
+  uint64_t base;         // 다음에 처리할 tick
+  uint64_t wake_at;      // 스케줄러 스레드가 깨어날 예정 tick (UINT64_MAX = 무기한)
+  size_t size;           // 대기 중인 타이머 수 (fire 리스트 포함)
+
   pthread_mutex_t mtx;
-  pthread_cond_t cv;
+  pthread_cond_t cv;     // CLOCK_MONOTONIC
   bool stop;
 } scheduler_t;
 
-int  scheduler_init(scheduler_t *s, size_t cap);
+int  scheduler_init(scheduler_t *s, size_t cap); // cap: 초기 노드 수 (상한 아님)
 void scheduler_stop(scheduler_t *s);
 void scheduler_destroy(scheduler_t *s);
 
+// 1회성 타이머 (due_ms: now_ms_monotonic 기준 절대시각)
 bool scheduler_add(scheduler_t *s, uint64_t due_ms, timer_cb_t cb, void *arg);
+
+// period_ms > 0 이면 due_ms부터 period_ms 간격으로 반복
+sched_timer_id_t scheduler_add_timer(scheduler_t *s, uint64_t due_ms, uint64_t period_ms,
+                                     timer_cb_t cb, void *arg);
+
+// 대기 중이면 제거하고 true. 콜백 실행 중이면 재등록만 막고 true
+bool scheduler_cancel(scheduler_t *s, sched_timer_id_t id);
+
+size_t scheduler_pending(scheduler_t *s);
+
 void* scheduler_thread(void *arg);
+
+// 스레드 없이 구동 (event loop): 만료된 타이머 콜백을 호출자 스레드에서 실행하고
+// 다음 마감 tick을 반환 (UINT64_MAX = 없음). 호출자가 timerfd를 그 시각에 맞춤
+uint64_t scheduler_run_due(scheduler_t *s);
@@ -3,12 +3,34 @@
 #include <stdint.h>
 #include "types.h"
 
+// 서명 검증 스텁의 CPU 비용 에뮬레이션 (ns, 0 = 없음)
+// 실제 검증이 붙기 전 워커 수/캐시 등의 효과를 벤치마크하기 위한 용도
+void sec_set_stub_verify_cost_ns(uint32_t ns);
+
+// 무선 RX 서명 검증 결과 캐시 (lock-free, 고정 크기 SEC_VCACHE_SLOTS)
+// - 키: (payload, security) 256B 전체의 64bit digest, 적중 시 전체 바이트 비교까지 해서
+//   digest 충돌로 검증을 건너뛰는 일은 없음
+// - 성공/실패 결과 모두 기록 (잘못된 패킷 반복도 재검증하지 않음)
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;     // 다른 패킷이 슬롯을 덮어씀
+    uint64_t busy_skips;    // 다른 스레드가 같은 슬롯을 쓰는 중이라 기록 생략
+} sec_vcache_stats_t;
+
+void sec_vcache_set_enabled(bool on);
+void sec_vcache_reset(void);     // 항목/카운터 초기화 (검증 스레드가 없을 때만)
+void sec_vcache_get_stats(sec_vcache_stats_t *st);
+
 // 무선: RX Strip (Packet -> Payload)
 bool sec_wireless_rx_strip(const wl1_packet_t *pkt, wl1_payload_t *out_payload);
 
 // 무선: TX Wrap (Payload -> Packet)
 bool sec_wireless_tx_wrap(const wl1_payload_t *in_payload, wl1_packet_t *out_pkt);
 
+// 무선: 이미 Wrap된 패킷의 가변 필드(send_time 등)를 고친 뒤 서명만 갱신
+bool sec_wireless_tx_refresh(wl1_packet_t *pkt);
+
 // 유선: RX Strip (RSU-3 Packet -> Payload)
 bool sec_wired_rx_strip(const rsu3_packet_t *pkt, rsu3_payload_t *out_payload);
 
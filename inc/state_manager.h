@@ -1,14 +1,32 @@
 #pragma once
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "config.h"
 #include "queue.h"
 #include "scheduler.h"
 #include "led.h"
+#include "rx_dedup.h"
+#include "acc_table.h"
+
+#ifndef SM_BATCH_MAX
+#define SM_BATCH_MAX 32   // 한 번에 꺼내는 이벤트 / 모아서 내보내는 출력 개수
+#endif
+
+// 이벤트 배치 처리 중 생긴 출력 (배치 끝이나 가득 찼을 때 한 번에 push)
+typedef struct {
+  void *tx_cmd[SM_BATCH_MAX];
+  int n_tx_cmd;
+  void *air[SM_BATCH_MAX];
+  int n_air;
+  uint32_t n_new;      // 새 사고 보고 (공유 통계용)
+  uint32_t n_dup;      // 이미 active라 무시한 보고
+} sm_out_t;
 
 typedef struct {
   pthread_t th;
+  bool th_started;
   bool running;
 
   const app_config_t *cfg;
@@ -19,6 +37,14 @@ typedef struct {
   bq_t *to_air_q;      // uint8_t[256]*
 
   scheduler_t *sched;
+  rx_dedup_t *dedup;            // 해제(OFF) 시 RX 중복 억제 항목 무효화 (NULL 가능)
+  sched_timer_id_t tick_timer;  // SM_TICK_MS 주기 타이머
+  sched_timer_id_t bcast_timer; // 가장 이른 재전파 마감용 1회성 타이머
+  uint64_t bcast_armed_ms;      // bcast_timer 예정 시각 (UINT64_MAX = 없음)
+
+  acc_table_t table;            // SM 스레드(또는 poll 호출자)만 접근
+  bool table_ready;
+  sm_out_t out;
 } state_manager_t;
 
 int  state_manager_start(state_manager_t *sm,
@@ -27,6 +53,19 @@ int  state_manager_start(state_manager_t *sm,
                          bq_t *to_tx_cmd_q,
                          bq_t *to_air_q,
                          scheduler_t *sched,
-                         led_handle_t *led);
+                         led_handle_t *led,
+                         rx_dedup_t *dedup);
 
 void state_manager_stop(state_manager_t *sm);
+
+// 스레드 없이 구동 (event loop): init 후 in_ev_q에 쌓인 이벤트를 poll로 비움
+// (반환: 처리한 이벤트 수). 정리는 state_manager_stop
+int  state_manager_init(state_manager_t *sm,
+                        const app_config_t *cfg,
+                        bq_t *in_ev_q,
+                        bq_t *to_tx_cmd_q,
+                        bq_t *to_air_q,
+                        scheduler_t *sched,
+                        led_handle_t *led,
+                        rx_dedup_t *dedup);
+int  state_manager_poll(state_manager_t *sm);
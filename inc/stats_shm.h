@@ -0,0 +1,132 @@
+// app/stats_shm.h
+#pragma once
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*
+ * 실행 중 카운터 공유 메모리 (shm_open + mmap, 기본 이름 "/rsu_stats")
+ * - 각 스레드가 자기 카운터를 relaxed atomic으로 직접 갱신 (잠금 없음, 배치당 1회)
+ * - 큐 깊이/최고 수위/drop, dedup, 스케줄러 대기 수, light 규칙별 통계는 발행 타이머가 주기적으로 복사
+ *   (STATS_PUBLISH_MS, heartbeat 증가)
+ * - 외부 프로세스(rsu-top)는 읽기 전용으로 mmap해서 보기만 함
+ *   (디버거 연결/stdout 파싱 불필요, 재시작은 pid/started_ms로 구분)
+ * - 배치가 바뀌면 RSU_STATS_VERSION 증가 (rsu-top이 다르면 거부)
+ */
+
+#define RSU_STATS_SHM_DEFAULT "/rsu_stats"
+#define RSU_STATS_MAGIC       0x53555352u   // "RSUS"
+#define RSU_STATS_VERSION     2u
+
+#ifndef STATS_PUBLISH_MS
+#define STATS_PUBLISH_MS 250
+#endif
+
+typedef enum {
+  STQ_WL1_RAW = 0,   // 샤드 합 (depth/drops 합, high_water는 샤드 중 최대)
+  STQ_SM_EVENTS,
+  STQ_TX_CMD,
+  STQ_RSU3_IN,
+  STQ_AIR,
+  STQ_N
+} stats_queue_id_t;
+
+// 필터 단계 (WL-1 보고 경로 순서)
+typedef enum {
+  STF_LIGHT = 0,     // wireless RX light filter
+  STF_RX_DEDUP,      // RX 반복 억제 (reject = 억제)
+  STF_HEAVY,         // worker heavy filter (담당영역/거리)
+  STF_STRIP,         // 서명 검증/strip
+  STF_SM_DEDUP,      // SM: 새 사고(pass) / 이미 active(reject)
+  STF_N
+} stats_filter_id_t;
+
+typedef struct {
+  _Atomic uint64_t cap;
+  _Atomic uint64_t depth;
+  _Atomic uint64_t high_water;
+  _Atomic uint64_t drops;
+  _Atomic uint64_t push_items;
+  _Atomic uint64_t pop_items;
+} stats_queue_t;
+
+typedef struct {
+  _Atomic uint64_t pass;
+  _Atomic uint64_t reject;
+} stats_filter_t;
+
+#define STATS_RULES_MAX 16   // filter.h의 FILTER_RULES_MAX / FILTER_RULE_TEXT와 같게
+#define STATS_RULE_TEXT 48
+
+// light 규칙 1개 (현재 평가 순서의 자리 기준, 재배치 직후 한 주기는 text와 값이 어긋날 수 있음)
+typedef struct {
+  char text[STATS_RULE_TEXT];
+  _Atomic uint64_t evals;     // 이 규칙까지 온 패킷 수
+  _Atomic uint64_t rejects;   // 이 규칙에서 탈락한 패킷 수
+} stats_rule_t;
+
+typedef struct {
+  // 헤더 (open 시 한 번 기록)
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;              // sizeof(rsu_stats_t)
+  uint32_t pid;
+  uint64_t started_ms;        // CLOCK_REALTIME ms
+  _Atomic uint64_t heartbeat; // 발행 타이머마다 +1
+  _Atomic uint64_t updated_ms;// 마지막 발행 (CLOCK_REALTIME ms)
+
+  // WL-1 -> 서버
+  _Atomic uint64_t rx_datagrams;   // UDP 수신 (크기 불일치 포함)
+  stats_filter_t filter[STF_N];
+  _Atomic uint64_t reports_sent;   // 서버로 보낸 RSU-2 보고 (소켓에 다 써진 것)
+
+  // 서버 -> RSU
+  _Atomic uint64_t cmd_frames;     // 명령 서버가 받은 RSU-3 프레임
+  _Atomic uint64_t cmd_bad_frames;
+  _Atomic uint64_t cmd_conns;      // 현재 명령 연결 수
+  _Atomic uint64_t air_sent;       // 무선 재전파 송신
+
+  stats_queue_t queue[STQ_N];
+
+  // 스케줄러 / 사고 테이블
+  _Atomic uint64_t sched_pending;
+  _Atomic uint64_t acc_count;
+  _Atomic uint64_t acc_active;
+  _Atomic uint64_t acc_cap;
+
+  // 유선 연결 (wc_conn_state_t 값)
+  _Atomic uint64_t wired_state;
+  _Atomic uint64_t wired_connects;
+  _Atomic uint64_t wired_disconnects;
+  _Atomic uint64_t wired_buffered;
+
+  // light 규칙별 (filter_get_rule_stats, 평가 순서대로 rule_count개)
+  _Atomic uint64_t rule_count;
+  _Atomic uint64_t rule_reorders;
+  stats_rule_t rule[STATS_RULES_MAX];
+} rsu_stats_t;
+
+static inline const char* stats_queue_name(int i) {
+  static const char *const n[STQ_N] = { "Q_wl1_raw", "Q_sm_events", "Q_tx_cmd", "Q_rsu3_in", "Q_air" };
+  return (i >= 0 && i < STQ_N) ? n[i] : "?";
+}
+
+static inline const char* stats_filter_name(int i) {
+  static const char *const n[STF_N] = { "light", "rx_dedup", "heavy", "strip", "sm_dedup" };
+  return (i >= 0 && i < STF_N) ? n[i] : "?";
+}
+
+// ---- rsu 프로세스 쪽 ----
+// 항상 유효한 포인터 (공유 메모리가 없으면 프로세스 내부 구조체) -> 갱신 쪽은 NULL 검사 불필요
+extern rsu_stats_t *g_stats;
+
+static inline void stats_add(_Atomic uint64_t *c, uint64_t v) {
+  if (v) atomic_fetch_add_explicit(c, v, memory_order_relaxed);
+}
+
+static inline void stats_set(_Atomic uint64_t *c, uint64_t v) {
+  atomic_store_explicit(c, v, memory_order_relaxed);
+}
+
+// name == NULL/"": 공유 메모리 없이 내부 구조체만 (실패해도 -1, 파이프라인은 계속)
+int  stats_shm_open(const char *name);
+void stats_shm_close(void);   // 모든 갱신 스레드가 끝난 뒤 (shm_unlink)
@@ -0,0 +1,105 @@
+// app/trace.h
+#pragma once
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * 패킷 단계별 시각 추적 (WL-1 보고 경로)
+ * - 이벤트/명령에 32B 기록(pkt_trace_t)이 따라다니며 단계마다 ns 시각을 찍음
+ *   UDP RX -> Q_wl1_raw pop -> filter/strip 완료 -> Q_sm_events pop -> SM 처리 완료
+ *   -> Q_tx_cmd pop -> TCP 송신 완료
+ * - 단계를 찍을 때마다 직전 단계와의 차이를 구간 히스토그램에 누적 (lock-free, 원자 증가)
+ *   짝수 구간 = 큐 대기, 홀수 구간 = 처리 (+ 종단 UDP RX ~ TCP 송신)
+ * - 히스토그램: HDR 방식 log-linear (2배 구간마다 32칸, 상대 오차 ~3%)
+ * - 런타임 on/off (trace_set_enabled, RSU_TRACE=1, SIGUSR1)
+ *   끄면 단계마다 분기 1개 + RX에서 슬롯별 시각 0 쓰기만 남음
+ * - 배치 단위로 trace_now()를 한 번만 부르고 배치 안 모든 패킷에 같은 시각을 씀
+ */
+
+typedef enum {
+  TR_UDP_RX = 0,   // recvmmsg 반환 직후
+  TR_WL1_POP,      // worker가 Q_wl1_raw에서 꺼냄
+  TR_WL1_DONE,     // heavy filter/strip/변환 끝, Q_sm_events push 직전
+  TR_SM_POP,       // state manager가 Q_sm_events에서 꺼냄
+  TR_SM_DONE,      // Q_tx_cmd push 직전
+  TR_TXQ_POP,      // wired client가 Q_tx_cmd에서 꺼내 송신 버퍼에 wrap
+  TR_TCP_SEND,     // 보고 전체가 소켓에 써짐 (묶음 대기 포함)
+  TR_N_STAGES
+} trace_stage_t;
+
+typedef enum {
+  TR_SPAN_WL1_QUEUE = 0,  // UDP RX -> worker pop
+  TR_SPAN_WL1_PROC,       // worker 처리
+  TR_SPAN_SM_QUEUE,       // Q_sm_events 대기
+  TR_SPAN_SM_PROC,        // SM 처리 (배치 끝 push까지)
+  TR_SPAN_TX_QUEUE,       // Q_tx_cmd 대기
+  TR_SPAN_TX_SEND,        // 송신 버퍼 -> 소켓 (묶음 대기 + send)
+  TR_SPAN_E2E,            // UDP RX -> TCP 송신
+  TR_N_SPANS
+} trace_span_t;
+
+// 단계 시각은 base 기준 ns 차이 (0 = 아직 안 찍음, 4.29초에서 포화)
+typedef struct {
+  uint64_t base_ns;                 // TR_UDP_RX 시각 (0 = 추적 안 하는 패킷)
+  uint32_t at[TR_N_STAGES - 1];     // TR_WL1_POP.. 시각 - base_ns
+} pkt_trace_t;
+
+typedef struct {
+  uint64_t count;
+  uint64_t mean_ns;
+  uint64_t p50_ns;       // 구간 상한 (max로 제한)
+  uint64_t p99_ns;
+  uint64_t p999_ns;
+  uint64_t max_ns;
+} trace_span_stats_t;
+
+extern _Atomic bool g_trace_on;
+
+static inline bool trace_enabled(void) {
+  return atomic_load_explicit(&g_trace_on, memory_order_relaxed);
+}
+
+static inline uint64_t trace_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// 꺼져 있으면 0 (단계 함수들은 now == 0이면 아무것도 안 함)
+static inline uint64_t trace_now_if(void) {
+  return trace_enabled() ? trace_now() : 0;
+}
+
+void trace_record(trace_span_t sp, uint64_t ns);
+
+static inline void trace_begin(pkt_trace_t *t, uint64_t rx_ns) {
+  t->base_ns = rx_ns;
+  for (int i = 0; i < TR_N_STAGES - 1; i++) t->at[i] = 0;
+}
+
+// 단계 시각 기록 + 직전 단계와의 구간 누적 (직전 단계가 빠졌으면 구간은 버림)
+static inline void trace_stamp(pkt_trace_t *t, trace_stage_t st, uint64_t now) {
+  if (!now || !t->base_ns || st == TR_UDP_RX) return;
+  uint64_t d = (now > t->base_ns) ? now - t->base_ns : 1;
+  if (d > UINT32_MAX) d = UINT32_MAX;
+  uint32_t prev = (st == TR_WL1_POP) ? 0 : t->at[st - 2];
+  t->at[st - 1] = (uint32_t)d;
+  if (st != TR_WL1_POP && prev == 0) return;
+  trace_record((trace_span_t)(st - 1), d > prev ? d - prev : 0);
+  if (st == TR_TCP_SEND) trace_record(TR_SPAN_E2E, d);
+}
+
+// WL-1 패킷 버퍼(g_pools.wl1_pkt)는 유선 형식 그대로라 RX 시각을 풀 슬롯별 배열에 둠
+// RX는 항상 기록(꺼져 있으면 0), worker가 꺼낼 때 take
+int  trace_init(void);      // pools_init 이후
+void trace_destroy(void);
+void trace_wl1_rx_mark(const void *pkt, uint64_t now);
+uint64_t trace_wl1_rx_take(const void *pkt);
+
+void trace_set_enabled(bool on);
+void trace_reset(void);
+const char* trace_span_name(trace_span_t sp);
+void trace_get_span_stats(trace_span_t sp, trace_span_stats_t *out);
+void trace_log_stats(void);   // 샘플이 있는 구간만 LOGI
@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include <stdbool.h>
+#include "trace.h"
 
 #pragma pack(push, 1)
 
@@ -96,7 +97,8 @@ typedef struct {
 typedef enum {
     EV_WL1_RX,       // 무선 수신 -> 필터/보안 거쳐 RSU-2'로 변환됨
     EV_RSU3_RX,      // 서버 수신 -> 보안 거쳐 RSU-3'로 변환됨
-    EV_TIMER_TICK    // 2초 타이머
+    EV_TIMER_TICK,   // 2초 타이머 (LED 동기화 안전장치)
+    EV_BCAST_DUE     // 가장 이른 재전파 시각 도달
 } sm_event_type_t;
 
 typedef struct {
@@ -105,9 +107,11 @@ typedef struct {
         rsu2_payload_t *rsu2p;
         rsu3_payload_t *rsu3p;
     } u;
+    pkt_trace_t trace;     // EV_WL1_RX만 (base_ns = 0이면 추적 안 함)
 } sm_event_t;
 
 // [TX Command: StateManager -> WiredClient]
 typedef struct {
     rsu2_payload_t *rsu2p; // 아직 Token 안 붙은 것
+    pkt_trace_t trace;
 } tx_cmd_wired_t;
\ No newline at end of file
@@ -1,26 +1,105 @@
 #pragma once
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cmd_server.h"
 #include "config.h"
 #include "queue.h"
 #include "types.h"
 
+/*
+ * Wired client
+ * - Outgoing (RSU -> Server): epoll 스레드 하나가 non-blocking 연결 상태 머신을 돌림
+ *   DISCONNECTED --(backoff 만료)--> CONNECTING --(connect 완료)--> CONNECTED
+ *        ^-----------(실패/timeout/끊김, backoff 2배)-----------------'
+ *   보고 송신(Q_tx_cmd, eventfd 통지)과 즉시 응답(ACK) 수신을 같은 루프에서 처리
+ *   연결이 없어도 tx 버퍼(wired_tx_buf)까지 보관했다가 재접속 시 이어서 전송
+ *   서버가 느리거나 없어도 Q_tx_cmd 소비는 멈추지 않음 (버퍼가 차면 새 보고를 버리고 셈)
+ * - Incoming (Server -> RSU): 명령 수신 서버 (cmd_server.h, 연결 유지 + 다중 peer)
+ */
+
+typedef enum {
+  WC_DISCONNECTED = 0,
+  WC_CONNECTING,
+  WC_CONNECTED,
+} wc_conn_state_t;
+
+// 서버 방향 TX 통계 (IO 스레드만 갱신)
+typedef struct {
+  uint64_t reports;     // 보낸 보고 수
+  uint64_t flushes;     // 새 묶음을 내보낸 횟수 (보고 묶음 1개 = writev 1회 + partial write 재시도)
+  uint64_t resumes;     // EAGAIN 뒤 EPOLLOUT으로 같은 묶음을 이어 보낸 횟수 (flushes에 안 셈)
+  uint64_t syscalls;    // sendmsg 호출 수
+  uint64_t partial;     // 일부만 써진 횟수
+  uint64_t bytes;
+  uint64_t dropped;     // 송신 버퍼가 가득 차거나 wrap(sec_wired_tx_wrap)에 실패해 버린 보고
+  uint64_t discarded;   // 재생 모드(muted)에서 보내지 않고 버린 보고
+} wc_tx_stats_t;
+
+// 연결 상태 지표 (IO 스레드만 갱신, 다른 스레드에서 읽으면 근사치)
+typedef struct {
+  uint64_t connects;          // 성공한 연결 수
+  uint64_t connect_fails;     // 실패/timeout
+  uint64_t disconnects;       // 연결 후 끊김
+  uint64_t connect_us_last;   // connect 시작 ~ 완료
+  uint64_t connect_us_max;
+  uint64_t connect_us_sum;
+  uint64_t offline_ms_total;  // 연결 없이 보낸 시간 (현재 끊김 포함)
+  uint64_t buffered;          // 송신 버퍼에 남은 보고
+  uint64_t buffered_max;
+  bool connected;
+} wc_health_t;
+
 typedef struct {
-  bool running;
+  _Atomic bool running;   // stop(다른 스레드)이 내리고 IO 스레드가 봄
   const app_config_t *cfg;
+  bool muted;             // 재생 모드 + replay_tx 0: 서버 연결/명령 서버 없이 보고를 세고 버림
 
   // Outgoing (RSU -> Server)
   int sock_out;
-  pthread_t th_tx;
-  pthread_t th_rx_ack; // 즉시 응답 수신용
+  int ep_fd;            // epoll
+  int ev_fd;            // Q_tx_cmd 통지 + stop
+  int tm_fd;            // timerfd (재접속/connect timeout/flush 마감 중 가장 이른 것)
+  pthread_t th_io;
+  bool io_started;
+
+  wc_conn_state_t state;
+  uint32_t backoff_ms;
+  uint64_t next_connect_us;   // DISCONNECTED: 다음 시도 시각
+  uint64_t connect_start_us;
+  uint64_t offline_since_us;
+  uint64_t flush_at_us;       // CONNECTED: 모으기 마감 (0 = 없음)
+  uint64_t armed_us;          // timerfd에 걸린 시각
+  bool want_out;              // EAGAIN으로 EPOLLOUT 대기 중
+
+  // 송신 버퍼: 보고 단위 링 (head 보고는 head_off 바이트까지 보냄)
+  rsu2_packet_t *txbuf;
+  pkt_trace_t *tx_trace;      // txbuf 슬롯별 단계 시각 (TCP 송신 완료 시 기록)
+  uint32_t tx_cap, tx_head, tx_len;
+  size_t head_off;
+
+  // ACK 수신 (rsu3_packet_t 단위 프레이밍)
+  uint8_t ack_buf[sizeof(rsu3_packet_t)];
+  size_t ack_len;
+
+  wc_tx_stats_t tx_stats;
+  wc_health_t health;
 
   // Incoming (Server -> RSU)
-  int sock_in_listen;
-  pthread_t th_cmd_srv; // 명령 수신 서버용
+  cmd_server_t cmd;
 
-  bq_t *tx_cmd_q;   // tx_cmd_t*
+  bq_t *tx_cmd_q;   // tx_cmd_t* (BQ_MUTEX, notify fd 사용)
   bq_t *rsu3_out_q; // rsu3p_msg_t* (rx -> pipeline/state)
 } wired_client_t;
 
 int wired_client_start(wired_client_t *wc, const app_config_t *cfg, bq_t *tx_cmd_q, bq_t *rsu3_out_q);
-void wired_client_stop(wired_client_t *wc);
\ No newline at end of file
+void wired_client_stop(wired_client_t *wc);
+void wired_client_get_health(const wired_client_t *wc, wc_health_t *out);
+
+// 스레드 없이 구동 (event loop): 송신 상태 머신과 명령 서버를 epoll fd 하나로 묶음
+// 호출자는 wired_client_fd가 읽기 가능해지면 wired_client_poll (대기 없음). 정리는 stop
+int  wired_client_open_loop(wired_client_t *wc, const app_config_t *cfg, bq_t *tx_cmd_q, bq_t *rsu3_out_q);
+int  wired_client_fd(const wired_client_t *wc);
+void wired_client_poll(wired_client_t *wc);
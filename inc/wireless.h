@@ -1,28 +1,75 @@
 #pragma once
+#include <netinet/in.h>
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "config.h"
 #include "queue.h"
+#include "rx_dedup.h"
+#include "types.h"
 
 /*
  * wireless.c는 wireless_rx + wireless_tx를 묶은 모듈.
- * - RX: UDP recvfrom(256B) -> wl1_msg_t* 생성 -> out_rx_q로 push
- * - TX: in_tx_q에서 uint8_t[256]* pop -> UDP sendto (브로드캐스트)
+ * - RX: UDP recvmmsg(256B x N, wl1_rx_batch) -> accident_id로 샤드를 골라
+ *       wl1_packet_t*를 샤드별 배치로 out_rx_q[shard]에 push
+ *       light filter(배치 SIMD) 탈락분과 최근 넘긴 (sender_id, accident_id)는
+ *       할당/큐 전달 전에 버림
+ * - TX: in_tx_q에 쌓인 bcast_frame_t*를 한 번에 pop -> UDP sendmmsg (cfg의 wl1_tx_ip:wl1_tx_port)
+ *       송신 후 bcast_frame_put (SM 캐시가 같은 프레임을 계속 보유할 수 있음)
  */
 
+#ifndef WL1_RX_BATCH_MAX
+#define WL1_RX_BATCH_MAX 64
+#endif
+
 typedef struct {
   pthread_t th_rx;
   pthread_t th_tx;
+  bool th_started;
+  bool rx_started;   // 재생 모드(cfg->replay_path)는 RX 소켓/스레드 없음
+  bool tx_muted;     // 재생 모드 + replay_tx 0: TX 소켓 없이 프레임을 세고 버림
   bool running;
 
   int sock_rx;
   int sock_tx;
+  struct sockaddr_in tx_dst;   // wl1_tx_ip:wl1_tx_port
+
+  // 수신 버퍼 (배치 모드): 큐로 넘어간 칸만 다음 배치 전에 새로 할당
+  wl1_packet_t *rx_slot[WL1_RX_BATCH_MAX];
 
   const app_config_t *cfg;
 
-  bq_t *out_rx_q;  // wl1_msg_t*
-  bq_t *in_tx_q;   // uint8_t[256]*
+  bq_t *out_rx_q;  // wl1_packet_t* 샤드 큐 배열 (WL-1 워커당 1개)
+  int n_rx_q;
+  bq_t *in_tx_q;   // bcast_frame_t*
+  rx_dedup_t *dedup; // NULL 가능
+
+  // RX 통계 (RX 스레드만 갱신)
+  uint64_t rx_filtered;    // light filter 탈락
+
+  // TX 통계 (TX 스레드만 갱신)
+  uint64_t tx_sent;
+  uint64_t tx_failed;
+  uint64_t tx_discarded;   // tx_muted로 버린 프레임
 } wireless_t;
 
-int  wireless_start(wireless_t *w, const app_config_t *cfg, bq_t *out_rx_q, bq_t *in_tx_q);
+int  wireless_start(wireless_t *w, const app_config_t *cfg,
+                    bq_t *out_rx_q, int n_rx_q, bq_t *in_tx_q, rx_dedup_t *dedup);
 void wireless_stop(wireless_t *w);
+
+// 스레드 없이 구동 (event loop): 소켓만 열고, 호출자가 sock_rx 읽기 가능 시 rx_poll,
+// in_tx_q에 쌓였을 때 tx_poll (둘 다 대기 없음). 정리는 wireless_stop
+int  wireless_open(wireless_t *w, const app_config_t *cfg,
+                   bq_t *out_rx_q, int n_rx_q, bq_t *in_tx_q, rx_dedup_t *dedup);
+int  wireless_rx_poll(wireless_t *w);   // recvmmsg 1회 (MSG_DONTWAIT), 받은 datagram 수
+int  wireless_tx_poll(wireless_t *w);   // in_tx_q를 비울 때까지 sendmmsg, 보낸 프레임 수
+
+// 파일 재생(replay.h)용: UDP 수신 대신 frames[i](len[i] 바이트, n <= WL1_RX_BATCH_MAX)를
+// 수신 경로와 같이 처리 (크기 검사 -> light filter -> RX dedup -> 샤드 큐)
+// wait_stop: NULL이면 실제 수신처럼 모자란 만큼 버림. 아니면 패킷 버퍼/샤드 큐에 자리가 날 때까지
+//            기다림 (최대 속도 재생, 하류가 막혀도 *wait_stop이 서면 나머지를 버리고 반환)
+// cfg->replay_path가 있으면 RX 소켓/스레드를 안 띄우므로 호출 스레드가 유일한 샤드 생산자
+// (대기 모드의 남은 자리 계산과 rx_filtered 갱신이 이 가정에 기댐)
+// 반환: 큐로 넘긴 수
+int  wireless_inject(wireless_t *w, const uint8_t *const *frames, const uint32_t *len, int n,
+                     volatile int *wait_stop);
@@ -0,0 +1,44 @@
+#pragma once
+#include <pthread.h>
+#include <stdint.h>
+#include "queue.h"
+#include "types.h"
+#include "rx_dedup.h"
+#include "filter.h"
+
+/*
+ * WL-1 Worker: [샤드 Q] -> [Heavy Filter] -> [Strip] -> [Packet Conv] -> [SM Event Q]
+ * - 워커마다 전용 입력 큐(샤드)를 가지고, wireless RX가 accident_id로 샤드를 고름
+ * - 같은 사고는 항상 같은 워커 -> 사고별 보고 순서 유지
+ *   서로 다른 사고는 여러 코어에서 병렬 처리
+ * - SM 큐에 넘긴 보고는 dedup에 등록 (이후 같은 보고는 RX에서 억제)
+ */
+
+#ifndef WL1_MAX_WORKERS
+#define WL1_MAX_WORKERS 8
+#endif
+
+typedef struct {
+  pthread_t th;
+  bq_t *in_q;      // wl1_packet_t* (이 워커 전용 샤드)
+  bq_t *out_q;     // sm_event_t*   (Q_sm_events, 워커 공용)
+  uint32_t rsu_id;
+  const filter_ctx_t *filter; // heavy filter (담당영역/거리), 워커 간 읽기 전용 공유
+  rx_dedup_t *dedup; // NULL 가능
+} wl1_worker_t;
+
+int  wl1_worker_start(wl1_worker_t *w, bq_t *in_q, bq_t *out_q, uint32_t rsu_id,
+                      const filter_ctx_t *filter, rx_dedup_t *dedup);
+void wl1_worker_join(wl1_worker_t *w); // in_q가 stop 된 뒤 호출
+
+// 스레드 없이 구동 (event loop): init 후 in_q에 쌓인 것을 poll로 비움 (반환: 처리한 패킷 수)
+void wl1_worker_init(wl1_worker_t *w, bq_t *in_q, bq_t *out_q, uint32_t rsu_id,
+                     const filter_ctx_t *filter, rx_dedup_t *dedup);
+int  wl1_worker_poll(wl1_worker_t *w);
+
+// accident_id -> 샤드 번호 [0, n)
+static inline int wl1_shard_of(const wl1_packet_t *pkt, int n) {
+  if (n <= 1) return 0;
+  uint64_t h = pkt->payload.accident.accident_id * 0x9E3779B97F4A7C15ull;
+  return (int)((h >> 32) % (uint64_t)n);
+}
@@ -0,0 +1,225 @@
+#include "acc_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+static inline uint32_t acc_hash(uint64_t id, uint32_t mask) {
+  id ^= id >> 33;
+  id *= 0xff51afd7ed558ccdull;
+  id ^= id >> 33;
+  return (uint32_t)id & mask;
+}
+
+static uint32_t round_pow2(uint32_t v) {
+  uint32_t c = 16;
+  while (c < v && c < (1u << 30)) c <<= 1;
+  return c;
+}
+
+static int alloc_arrays(acc_table_t *t, uint32_t cap) {
+  t->hot = (acc_hot_t*)calloc(cap, sizeof(acc_hot_t));
+  t->cold = (rsu3_payload_t*)calloc(cap, sizeof(rsu3_payload_t));
+  t->frame = (bcast_frame_t**)calloc(cap, sizeof(bcast_frame_t*));
+  if (!t->hot || !t->cold || !t->frame) {
+    free(t->hot);
+    free(t->cold);
+    free(t->frame);
+    t->hot = NULL;
+    t->cold = NULL;
+    t->frame = NULL;
+    return -1;
+  }
+  t->cap = cap;
+  t->mask = cap - 1;
+  return 0;
+}
+
+int acc_table_init(acc_table_t *t, uint32_t init_cap, uint32_t max_cap) {
+  memset(t, 0, sizeof(*t));
+  init_cap = round_pow2(init_cap);
+  max_cap = round_pow2(max_cap);
+  if (max_cap < init_cap) max_cap = init_cap;
+  t->max_cap = max_cap;
+  return alloc_arrays(t, init_cap);
+}
+
+void acc_table_destroy(acc_table_t *t) {
+  if (!t) return;
+  if (t->frame) {
+    for (uint32_t i = 0; i < t->cap; i++) bcast_frame_put(t->frame[i]);
+  }
+  free(t->hot);
+  free(t->cold);
+  free(t->frame);
+  free(t->due);
+  memset(t, 0, sizeof(*t));
+}
+
+int acc_table_find(const acc_table_t *t, uint64_t accident_id) {
+  uint32_t i = acc_hash(accident_id, t->mask);
+  for (;;) {
+    const acc_hot_t *h = &t->hot[i];
+    if (!h->used) return -1;
+    if (h->accident_id == accident_id) return (int)i;
+    i = (i + 1) & t->mask;
+  }
+}
+
+// 빈 칸 보장된 상태에서 새 슬롯 자리 찾기
+static uint32_t probe_empty(const acc_table_t *t, uint64_t accident_id) {
+  uint32_t i = acc_hash(accident_id, t->mask);
+  while (t->hot[i].used) i = (i + 1) & t->mask;
+  return i;
+}
+
+static int grow(acc_table_t *t) {
+  acc_table_t old = *t;
+  if (alloc_arrays(t, old.cap * 2) != 0) {
+    *t = old;
+    return -1;
+  }
+  for (uint32_t i = 0; i < old.cap; i++) {
+    if (!old.hot[i].used) continue;
+    uint32_t j = probe_empty(t, old.hot[i].accident_id);
+    t->hot[j] = old.hot[i];
+    t->cold[j] = old.cold[i];
+    t->frame[j] = old.frame[i];
+  }
+  free(old.hot);
+  free(old.cold);
+  free(old.frame);
+  return 0;
+}
+
+int acc_table_insert(acc_table_t *t, uint64_t accident_id) {
+  int idx = acc_table_find(t, accident_id);
+  if (idx >= 0) return idx;
+
+  if ((uint64_t)(t->count + 1) * 4 > (uint64_t)t->cap * 3) {
+    // max_cap에서는 grow 대신 15/16까지만 채움 (probe 길이 제한)
+    if (t->cap >= t->max_cap || grow(t) != 0) {
+      if ((uint64_t)(t->count + 1) * 16 > (uint64_t)t->cap * 15) return -1;
+    }
+  }
+
+  uint32_t i = probe_empty(t, accident_id);
+  memset(&t->hot[i], 0, sizeof(t->hot[i]));
+  memset(&t->cold[i], 0, sizeof(t->cold[i]));
+  t->hot[i].used = true;
+  t->hot[i].accident_id = accident_id;
+  t->count++;
+  return (int)i;
+}
+
+void acc_table_remove(acc_table_t *t, int idx) {
+  if (idx < 0 || (uint32_t)idx >= t->cap || !t->hot[idx].used) return;
+  if (t->hot[idx].active) t->active_count--;
+  t->count--;
+  acc_table_drop_frame(t, idx);
+
+  // backward shift: 뒤따르는 클러스터 원소 중 제자리(home)에서 밀려난 것을 당겨옴
+  uint32_t hole = (uint32_t)idx;
+  uint32_t j = hole;
+  for (;;) {
+    j = (j + 1) & t->mask;
+    if (!t->hot[j].used) break;
+    uint32_t home = acc_hash(t->hot[j].accident_id, t->mask);
+    // home이 (hole, j] 구간 밖이면 hole로 옮겨도 탐색 경로가 유지됨
+    bool in_range = (hole <= j) ? (home > hole && home <= j)
+                                : (home > hole || home <= j);
+    if (in_range) continue;
+    t->hot[hole] = t->hot[j];
+    t->cold[hole] = t->cold[j];
+    t->frame[hole] = t->frame[j];
+    hole = j;
+  }
+  memset(&t->hot[hole], 0, sizeof(t->hot[hole]));
+  t->frame[hole] = NULL;
+}
+
+void acc_table_set_active(acc_table_t *t, int idx, bool active) {
+  acc_hot_t *h = &t->hot[idx];
+  if (h->active == active) return;
+  h->active = active;
+  if (active) t->active_count++;
+  else        t->active_count--;
+}
+
+void acc_table_drop_frame(acc_table_t *t, int idx) {
+  bcast_frame_put(t->frame[idx]);
+  t->frame[idx] = NULL;
+}
+
+// ---- 재전파 min-heap ----
+static void due_up(acc_due_t *h, uint32_t i) {
+  acc_due_t x = h[i];
+  while (i > 0) {
+    uint32_t p = (i - 1) / 2;
+    if (h[p].due_ms <= x.due_ms) break;
+    h[i] = h[p];
+    i = p;
+  }
+  h[i] = x;
+}
+
+static void due_down(acc_due_t *h, uint32_t n, uint32_t i) {
+  acc_due_t x = h[i];
+  for (;;) {
+    uint32_t c = i * 2 + 1;
+    if (c >= n) break;
+    if (c + 1 < n && h[c + 1].due_ms < h[c].due_ms) c++;
+    if (x.due_ms <= h[c].due_ms) break;
+    h[i] = h[c];
+    i = c;
+  }
+  h[i] = x;
+}
+
+// 지난 항목이 쌓이면 테이블 기준으로 heap 재구성
+static void due_compact(acc_table_t *t) {
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < t->cap; i++) {
+    if (!t->hot[i].used || !t->hot[i].bcast_due) continue;
+    t->due[n].due_ms = t->hot[i].bcast_due;
+    t->due[n].accident_id = t->hot[i].accident_id;
+    n++;
+  }
+  t->due_n = n;
+  for (uint32_t i = n / 2; i-- > 0;) due_down(t->due, n, i);
+}
+
+int acc_table_schedule(acc_table_t *t, int idx, uint64_t due_ms) {
+  if (t->due_n >= 2 * t->count + 64) due_compact(t);
+  if (t->due_n == t->due_cap) {
+    uint32_t nc = t->due_cap ? t->due_cap * 2 : 64;
+    acc_due_t *nd = (acc_due_t*)realloc(t->due, (size_t)nc * sizeof(acc_due_t));
+    if (!nd) return -1;
+    t->due = nd;
+    t->due_cap = nc;
+  }
+  if (due_ms == 0) due_ms = 1;  // 0은 "예약 없음"
+  t->hot[idx].bcast_due = due_ms;
+  t->due[t->due_n].due_ms = due_ms;
+  t->due[t->due_n].accident_id = t->hot[idx].accident_id;
+  due_up(t->due, t->due_n);
+  t->due_n++;
+  return 0;
+}
+
+int acc_table_pop_due(acc_table_t *t, uint64_t now_ms, uint64_t *due_ms) {
+  while (t->due_n > 0 && t->due[0].due_ms <= now_ms) {
+    acc_due_t top = t->due[0];
+    t->due[0] = t->due[--t->due_n];
+    if (t->due_n) due_down(t->due, t->due_n, 0);
+
+    int idx = acc_table_find(t, top.accident_id);
+    if (idx < 0 || t->hot[idx].bcast_due != top.due_ms) continue; // 삭제/재예약된 항목
+    t->hot[idx].bcast_due = 0;
+    if (due_ms) *due_ms = top.due_ms;
+    return idx;
+  }
+  return -1;
+}
+
+uint64_t acc_table_next_due(const acc_table_t *t) {
+  return t->due_n ? t->due[0].due_ms : UINT64_MAX;
+}
@@ -0,0 +1,18 @@
+// app/bcast_frame.c
+#include "bcast_frame.h"
+#include "pools.h"
+
+bcast_frame_t* bcast_frame_new(void) {
+  bcast_frame_t *f = (bcast_frame_t*)mempool_alloc(&g_pools.bframe);
+  if (!f) return NULL;
+  atomic_store_explicit(&f->refs, 1, memory_order_relaxed);
+  return f;
+}
+
+void bcast_frame_put(bcast_frame_t *f) {
+  if (!f) return;
+  // release: 송신 측의 읽기가 끝난 뒤에야 캐시 측이 제자리 수정하도록
+  if (atomic_fetch_sub_explicit(&f->refs, 1, memory_order_acq_rel) == 1) {
+    mempool_free(&g_pools.bframe, f);
+  }
+}
@@ -0,0 +1,444 @@
+// app/cmd_server.c
+#define _GNU_SOURCE // accept4
+#include "cmd_server.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "debug.h"
+#include "log.h"
+#include "pools.h"
+#include "security.h"
+#include "stats_shm.h"
+
+#ifndef CMD_BAD_RUN_MAX
+#define CMD_BAD_RUN_MAX 8        // 연속 검증 실패가 이만큼이면 프레임이 어긋난 것으로 보고 끊음
+#endif
+#ifndef CMD_EPOLL_EVENTS
+#define CMD_EPOLL_EVENTS 64
+#endif
+
+#define CMD_TAG_LISTEN UINT64_MAX
+#define CMD_TAG_STOP   (UINT64_MAX - 1)
+#define CMD_TAG_SWEEP  (UINT64_MAX - 2)
+#define CMD_TAG_RESUME (UINT64_MAX - 3)
+
+typedef enum {
+  FRAME_OK = 0,
+  FRAME_FULL,    // rsu3_out_q가 가득 참 -> 프레임을 버퍼에 두고 연결을 멈춤
+  FRAME_CLOSE,   // 연속 검증 실패 -> 연결 끊음
+} frame_rc_t;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void lat_add(cmd_lat_t *l, uint64_t ns) {
+  l->count++;
+  l->sum_ns += ns;
+  if (ns > l->max_ns) l->max_ns = ns;
+}
+
+static unsigned lat_bucket(uint64_t ns) {
+  unsigned b = ns ? 64u - (unsigned)__builtin_clzll(ns) : 0;
+  return b < CMD_LAT_BUCKETS ? b : CMD_LAT_BUCKETS - 1;
+}
+
+uint64_t cmd_server_lat_quantile(const cmd_server_stats_t *st, double q) {
+  uint64_t total = 0;
+  for (int i = 0; i < CMD_LAT_BUCKETS; i++) total += st->lat_hist[i];
+  if (!total) return 0;
+  uint64_t want = (uint64_t)(q * (double)total);
+  if (want >= total) want = total - 1;
+  uint64_t acc = 0;
+  for (int i = 0; i < CMD_LAT_BUCKETS; i++) {
+    acc += st->lat_hist[i];
+    if (acc > want) {
+      uint64_t hi = i ? (1ull << i) - 1 : 0;
+      return hi < st->lat.max_ns ? hi : st->lat.max_ns;
+    }
+  }
+  return st->lat.max_ns;
+}
+
+static void conn_close(cmd_server_t *s, uint32_t idx, const char *why) {
+  cmd_conn_t *c = &s->conns[idx];
+  char ip[INET_ADDRSTRLEN];
+  struct in_addr a = { .s_addr = c->peer_ip };
+  inet_ntop(AF_INET, &a, ip, sizeof(ip));
+  uint64_t up_ms = (now_ns() / 1000ull - c->opened_us) / 1000ull;
+  LOGI("cmd: %s:%u closed (%s) after %llu ms: %llu frames (%llu bad, %u B pending), lat avg %llu ns max %llu ns",
+       ip, c->peer_port, why, (unsigned long long)up_ms, (unsigned long long)c->frames,
+       (unsigned long long)c->bad_frames, c->len,
+       (unsigned long long)(c->lat.count ? c->lat.sum_ns / c->lat.count : 0),
+       (unsigned long long)c->lat.max_ns);
+
+  close(c->fd);   // epoll 등록도 같이 빠짐
+  c->fd = -1;
+  if (c->paused) s->n_paused--;
+  c->paused = false;
+  s->free_slots[s->n_free++] = idx;
+  s->stats.closes++;
+  s->stats.active--;
+}
+
+static void accept_all(cmd_server_t *s) {
+  for (;;) {
+    struct sockaddr_in peer;
+    socklen_t plen = sizeof(peer);
+    int fd = accept4(s->listen_fd, (struct sockaddr*)&peer, &plen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK) LOGW("cmd: accept failed: %d", errno);
+      return;
+    }
+    if (s->n_free == 0) {
+      s->stats.refused++;
+      DBG_WARN("cmd: connection limit (%u) reached, refusing", s->max_conns);
+      close(fd);
+      continue;
+    }
+
+    uint32_t idx = s->free_slots[--s->n_free];
+    cmd_conn_t *c = &s->conns[idx];
+    memset(c, 0, sizeof(*c));
+    c->fd = fd;
+    c->peer_ip = peer.sin_addr.s_addr;
+    c->peer_port = ntohs(peer.sin_port);
+    c->opened_us = c->last_rx_us = now_ns() / 1000ull;
+
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLRDHUP, .data.u64 = idx };
+    if (epoll_ctl(s->ep_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+      close(fd);
+      c->fd = -1;
+      s->free_slots[s->n_free++] = idx;
+      continue;
+    }
+    s->stats.accepts++;
+    if (++s->stats.active > s->stats.active_max) s->stats.active_max = s->stats.active;
+    DBG_INFO("cmd: connection from %s:%u (%u active)", inet_ntoa(peer.sin_addr), c->peer_port,
+             s->stats.active);
+  }
+}
+
+// 완성된 프레임 하나: 검증 -> state manager로
+// 큐가 가득 차면 기다리지 않고 FRAME_FULL (호출자가 프레임을 남겨 두고 나중에 다시, 재검증은 싸므로 결과는 안 보관)
+static frame_rc_t handle_frame(cmd_server_t *s, cmd_conn_t *c, const uint8_t *frame, uint64_t t_rx) {
+  rsu3_payload_t *payload = (rsu3_payload_t*)mempool_alloc(&g_pools.rsu3p);
+  if (!payload) {
+    s->stats.dropped++;
+    return FRAME_OK;
+  }
+  rsu3_packet_t pkt;
+  memcpy(&pkt, frame, sizeof(pkt));   // frame은 recv 버퍼 중간일 수 있음 (정렬 X)
+  if (!sec_wired_rx_strip(&pkt, payload)) {
+    mempool_free(&g_pools.rsu3p, payload);
+    c->bad_frames++;
+    s->stats.bad_frames++;
+    return ++c->bad_run < CMD_BAD_RUN_MAX ? FRAME_OK : FRAME_CLOSE;
+  }
+  c->bad_run = 0;
+
+  uint16_t flag = payload->server_info.acc_flag;
+  // State Manager에게 전달 -> 여기서 LED 꺼짐!
+  if (!bq_try_push(s->out_q, payload)) {
+    mempool_free(&g_pools.rsu3p, payload);
+    return FRAME_FULL;
+  }
+  // 명령마다 stdout을 쓰면 같은 recv의 뒤 프레임 지연이 늘어남 -> DBG 레벨
+  DBG_INFO("[CMD] Received Command from Server (Flag: 0x%04X)", flag);
+
+  uint64_t ns = now_ns() - t_rx;
+  c->frames++;
+  s->stats.frames++;
+  lat_add(&c->lat, ns);
+  lat_add(&s->stats.lat, ns);
+  s->stats.lat_hist[lat_bucket(ns)]++;
+  return FRAME_OK;
+}
+
+static void arm_resume(cmd_server_t *s) {
+  struct itimerspec its;
+  memset(&its, 0, sizeof(its));
+  its.it_value.tv_sec = (time_t)(CMD_RESUME_US / 1000000);
+  its.it_value.tv_nsec = (long)(CMD_RESUME_US % 1000000) * 1000l;
+  timerfd_settime(s->rs_fd, 0, &its, NULL);
+}
+
+// 큐가 가득 참: epoll에서 빼서 더 읽지 않음 (소켓 수신 버퍼가 차면 peer 쪽 송신이 느려짐)
+// level-triggered라 등록을 남겨 두면 EPOLLIN/HUP이 계속 떠서 DEL
+static void conn_pause(cmd_server_t *s, uint32_t idx) {
+  cmd_conn_t *c = &s->conns[idx];
+  if (c->paused) return;
+  epoll_ctl(s->ep_fd, EPOLL_CTL_DEL, c->fd, NULL);
+  c->paused = true;
+  s->stats.pauses++;
+  if (s->n_paused++ == 0) arm_resume(s);
+  DBG_WARN("cmd: command queue full, pausing %s:%u (%u B buffered)",
+           inet_ntoa((struct in_addr){ .s_addr = c->peer_ip }), c->peer_port, c->len);
+}
+
+// buf에 모인 완성 프레임을 순서대로 큐로 (반환 1 = 다 넘김, 0 = 멈춤, -1 = 닫힘)
+static int conn_drain(cmd_server_t *s, uint32_t idx) {
+  cmd_conn_t *c = &s->conns[idx];
+  const uint32_t fsz = sizeof(rsu3_packet_t);
+  uint32_t off = 0;
+  int rc = 1;
+  for (; c->len - off >= fsz; off += fsz) {
+    frame_rc_t r = handle_frame(s, c, c->buf + off, c->t_rx);
+    if (r == FRAME_CLOSE) {
+      conn_close(s, idx, "bad frames");
+      return -1;
+    }
+    if (r == FRAME_FULL) {
+      conn_pause(s, idx);
+      rc = 0;
+      break;
+    }
+  }
+  if (off) {
+    memmove(c->buf, c->buf + off, c->len - off);
+    c->len -= off;
+  }
+  return rc;
+}
+
+// 읽을 수 있는 만큼 읽어 64B 단위로 처리 (반환 false = 닫힘)
+static bool conn_read(cmd_server_t *s, uint32_t idx) {
+  cmd_conn_t *c = &s->conns[idx];
+
+  for (;;) {
+    int rc = conn_drain(s, idx);
+    if (rc <= 0) return rc == 0;
+
+    size_t space = sizeof(c->buf) - c->len;
+    ssize_t n = recv(c->fd, c->buf + c->len, space, MSG_DONTWAIT);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+      conn_close(s, idx, strerror(errno));
+      return false;
+    }
+    if (n == 0) {
+      conn_close(s, idx, "eof");
+      return false;
+    }
+
+    c->t_rx = now_ns();
+    c->last_rx_us = c->t_rx / 1000ull;
+    c->bytes += (uint64_t)n;
+    s->stats.bytes += (uint64_t)n;
+    c->len += (uint32_t)n;
+    if ((size_t)n < space) return conn_drain(s, idx) >= 0;   // 소켓 버퍼를 비움
+  }
+}
+
+// 멈춘 연결을 다시 epoll에 넣고 남은 프레임부터 (또 가득 차면 다시 멈추고 타이머 재설정)
+static void resume_paused(cmd_server_t *s) {
+  uint32_t n = s->n_paused;
+  for (uint32_t i = 0; i < s->max_conns && n; i++) {
+    cmd_conn_t *c = &s->conns[i];
+    if (c->fd < 0 || !c->paused) continue;
+    n--;
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLRDHUP, .data.u64 = i };
+    if (epoll_ctl(s->ep_fd, EPOLL_CTL_ADD, c->fd, &ev) != 0) {
+      conn_close(s, i, "epoll");
+      continue;
+    }
+    c->paused = false;
+    s->n_paused--;
+    conn_read(s, i);
+  }
+}
+
+static void sweep_idle(cmd_server_t *s) {
+  uint64_t idle_us = (uint64_t)s->cfg->cmd_idle_timeout_ms * 1000ull;
+  uint64_t now = now_ns() / 1000ull;
+  for (uint32_t i = 0; i < s->max_conns; i++) {
+    if (s->conns[i].fd >= 0 && now - s->conns[i].last_rx_us > idle_us) {
+      s->stats.idle_closes++;
+      conn_close(s, i, "idle");
+    }
+  }
+}
+
+// epoll 1회분 처리 (timeout_ms: -1 = 무기한, 0 = 대기 없음). 반환: 처리한 이벤트 수, -1 = 오류
+static int cmd_server_once(cmd_server_t *s, int timeout_ms) {
+  struct epoll_event evs[CMD_EPOLL_EVENTS];
+  int n = epoll_wait(s->ep_fd, evs, CMD_EPOLL_EVENTS, timeout_ms);
+  if (n < 0) {
+    if (errno == EINTR) return 0;
+    LOGE("cmd: epoll_wait failed: %d", errno);
+    return -1;
+  }
+  for (int i = 0; i < n; i++) {
+    uint64_t tag = evs[i].data.u64;
+    uint64_t v;
+    if (tag == CMD_TAG_LISTEN) {
+      accept_all(s);
+    } else if (tag == CMD_TAG_STOP) {
+      if (read(s->ev_fd, &v, sizeof(v)) < 0) { /* running을 다시 봄 */ }
+    } else if (tag == CMD_TAG_SWEEP) {
+      if (read(s->tm_fd, &v, sizeof(v)) > 0) sweep_idle(s);
+    } else if (tag == CMD_TAG_RESUME) {
+      if (read(s->rs_fd, &v, sizeof(v)) > 0) resume_paused(s);
+    } else {
+      uint32_t idx = (uint32_t)tag;
+      // 이번 배치에서 이미 닫혔거나 멈춤
+      if (s->conns[idx].fd < 0 || s->conns[idx].paused) continue;
+      // 에러/HUP도 recv가 eof/errno로 알려줌
+      conn_read(s, idx);
+    }
+  }
+  stats_set(&g_stats->cmd_frames, s->stats.frames);
+  stats_set(&g_stats->cmd_bad_frames, s->stats.bad_frames);
+  stats_set(&g_stats->cmd_conns, s->stats.active);
+  return n;
+}
+
+static void* cmd_server_thread(void *arg) {
+  cmd_server_t *s = (cmd_server_t*)arg;
+  while (atomic_load_explicit(&s->running, memory_order_relaxed)) {
+    if (cmd_server_once(s, -1) < 0) break;
+  }
+  return NULL;
+}
+
+int cmd_server_poll(cmd_server_t *s) {
+  return cmd_server_once(s, 0);
+}
+
+int cmd_server_fd(const cmd_server_t *s) {
+  return s->ep_fd;
+}
+
+int cmd_server_open(cmd_server_t *s, const app_config_t *cfg, bq_t *out_q) {
+  memset(s, 0, sizeof(*s));
+  s->cfg = cfg;
+  s->out_q = out_q;
+  s->listen_fd = s->ep_fd = s->ev_fd = s->tm_fd = s->rs_fd = -1;
+  s->max_conns = cfg->cmd_max_conns ? cfg->cmd_max_conns : 1;
+
+  s->conns = (cmd_conn_t*)calloc(s->max_conns, sizeof(*s->conns));
+  s->free_slots = (uint32_t*)malloc(s->max_conns * sizeof(*s->free_slots));
+  if (!s->conns || !s->free_slots) goto fail;
+  // 낮은 번호 슬롯부터 쓰도록 역순으로 쌓음
+  for (uint32_t i = 0; i < s->max_conns; i++) {
+    s->conns[i].fd = -1;
+    s->free_slots[i] = s->max_conns - 1 - i;
+  }
+  s->n_free = s->max_conns;
+
+  s->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (s->listen_fd < 0) goto fail;
+  int yes = 1;
+  setsockopt(s->listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(cfg->local_port); // 20905
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(s->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+    LOGE("Command Server Bind Failed (Port %d): %d", cfg->local_port, errno);
+    goto fail;
+  }
+  if (listen(s->listen_fd, (int)cfg->cmd_backlog) < 0) goto fail;
+
+  s->ep_fd = epoll_create1(EPOLL_CLOEXEC);
+  s->ev_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (s->ep_fd < 0 || s->ev_fd < 0) goto fail;
+  struct epoll_event ev = { .events = EPOLLIN, .data.u64 = CMD_TAG_LISTEN };
+  if (epoll_ctl(s->ep_fd, EPOLL_CTL_ADD, s->listen_fd, &ev) != 0) goto fail;
+  ev.data.u64 = CMD_TAG_STOP;
+  if (epoll_ctl(s->ep_fd, EPOLL_CTL_ADD, s->ev_fd, &ev) != 0) goto fail;
+  s->rs_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (s->rs_fd < 0) goto fail;
+  ev.data.u64 = CMD_TAG_RESUME;
+  if (epoll_ctl(s->ep_fd, EPOLL_CTL_ADD, s->rs_fd, &ev) != 0) goto fail;
+
+  // idle 검사 주기 (timeout의 1/4, 최소 100ms). epoll timeout 대신 timerfd라서
+  // 상위 event loop에 ep_fd를 넣어도 그대로 동작
+  if (cfg->cmd_idle_timeout_ms) {
+    uint32_t tick_ms = cfg->cmd_idle_timeout_ms / 4;
+    if (tick_ms < 100) tick_ms = 100;
+    s->tm_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (s->tm_fd < 0) goto fail;
+    struct itimerspec its;
+    its.it_interval.tv_sec = (time_t)(tick_ms / 1000);
+    its.it_interval.tv_nsec = (long)(tick_ms % 1000) * 1000000l;
+    its.it_value = its.it_interval;
+    timerfd_settime(s->tm_fd, 0, &its, NULL);
+    ev.data.u64 = CMD_TAG_SWEEP;
+    if (epoll_ctl(s->ep_fd, EPOLL_CTL_ADD, s->tm_fd, &ev) != 0) goto fail;
+  }
+
+  atomic_store(&s->running, true);
+  LOGI("Command Server Listening on Port %d (persistent, up to %u peers)", cfg->local_port,
+       s->max_conns);
+  return 0;
+
+fail:
+  cmd_server_stop(s);
+  return -1;
+}
+
+int cmd_server_start(cmd_server_t *s, const app_config_t *cfg, bq_t *out_q) {
+  if (cmd_server_open(s, cfg, out_q) != 0) return -1;
+  if (pthread_create(&s->th, NULL, cmd_server_thread, s) != 0) {
+    cmd_server_stop(s);
+    return -1;
+  }
+  s->started = true;
+  return 0;
+}
+
+void cmd_server_get_stats(const cmd_server_t *s, cmd_server_stats_t *out) {
+  *out = s->stats;
+}
+
+void cmd_server_stop(cmd_server_t *s) {
+  if (!s || !s->cfg) return;   // 시작한 적 없음
+  bool was_running = atomic_exchange(&s->running, false);
+  if (s->started) {
+    uint64_t one = 1;
+    if (write(s->ev_fd, &one, sizeof(one)) < 0) { /* 스레드가 running을 다시 봄 */ }
+    pthread_join(s->th, NULL);
+    s->started = false;
+  }
+  if (was_running) {
+    for (uint32_t i = 0; i < s->max_conns; i++) {
+      if (s->conns[i].fd >= 0) conn_close(s, i, "shutdown");
+    }
+    const cmd_server_stats_t *st = &s->stats;
+    LOGI("cmd server: %llu accepts (%llu refused, peak %u), %llu frames (%llu bad, %llu dropped, %llu queue-full pauses), lat avg %llu ns p50 <=%llu ns p99 <=%llu ns max %llu ns",
+         (unsigned long long)st->accepts, (unsigned long long)st->refused, st->active_max,
+         (unsigned long long)st->frames, (unsigned long long)st->bad_frames,
+         (unsigned long long)st->dropped, (unsigned long long)st->pauses,
+         (unsigned long long)(st->lat.count ? st->lat.sum_ns / st->lat.count : 0),
+         (unsigned long long)cmd_server_lat_quantile(st, 0.50),
+         (unsigned long long)cmd_server_lat_quantile(st, 0.99),
+         (unsigned long long)st->lat.max_ns);
+  }
+  if (s->listen_fd >= 0) close(s->listen_fd);
+  if (s->ep_fd >= 0) close(s->ep_fd);
+  if (s->ev_fd >= 0) close(s->ev_fd);
+  if (s->tm_fd >= 0) close(s->tm_fd);
+  if (s->rs_fd >= 0) close(s->rs_fd);
+  s->listen_fd = s->ep_fd = s->ev_fd = s->tm_fd = s->rs_fd = -1;
+  free(s->conns);
+  free(s->free_slots);
+  s->conns = NULL;
+  s->free_slots = NULL;
+}
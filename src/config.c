@@ -1,13 +1,46 @@
 // app/config.c
 #include "config.h"
+#include "stats_shm.h"
+#include <stdlib.h>
 #include <string.h>
 
+// 도 단위 소수 -> 1e-6도 (범위 밖/형식 오류면 기본값 유지)
+static void env_deg(const char *name, double lim, int32_t *out) {
+  const char *env = getenv(name);
+  if (!env || !*env) return;
+  char *end;
+  double deg = strtod(env, &end);
+  if (end == env || *end != '\0' || deg < -lim || deg > lim) return;
+  *out = (int32_t)(deg * 1000000.0 + (deg < 0 ? -0.5 : 0.5));
+}
+
 int load_default_config(app_config_t *cfg) {
   memset(cfg, 0, sizeof(*cfg));
   cfg->rsu_id = 200; // RSU ID (원하는 대로 변경 가능)
+  cfg->runtime_mode = RUNTIME_THREADS;
+  cfg->trace_enable = 0;
+  cfg->stats_shm_name = RSU_STATS_SHM_DEFAULT;
+  cfg->rsu_lat = 37000000;  // 37.0N
+  cfg->rsu_lon = 127000000; // 127.0E
+  cfg->zones_path = NULL;   // 예: "zones.conf"
+  cfg->filter_rules_path = NULL;
+  cfg->replay_path = NULL;
+  cfg->replay_speed = 0;
+  cfg->replay_tx = 0;
 
   cfg->wl1_listen_port = 30000;
   cfg->wl1_bind_ip = "0.0.0.0";
+  cfg->wl1_rx_batch = 32;
+  cfg->wl1_rx_timeout_ms = 100;
+  cfg->wl1_workers = 2;
+  cfg->wl1_sig_cache = 1;
+  cfg->wl1_dedup_window_ms = 2000;
+  cfg->wl1_dedup_sets = 4096;
+
+  // RSU-1 브로드캐스트 목적지 (현장마다 다르면 RSU_WL1_TX_IP/RSU_WL1_TX_PORT)
+  cfg->wl1_tx_ip = "255.255.255.255";
+  cfg->wl1_tx_port = 30001;
+  cfg->wl1_tx_batch = 32;
 
   // 서버(PC)의 IP 주소
   cfg->server_ip = "192.168.137.1"; 
@@ -15,8 +48,40 @@ int load_default_config(app_config_t *cfg) {
   // 포트는 서버 코드와 일치해야 함 (기본 20615)
   cfg->server_port = 20615;
   cfg->local_port = 20905;  // RSU가 사용할 포트
+  cfg->wired_tx_batch = 64;
+  cfg->wired_tx_delay_us = 500;
+  cfg->wired_tx_cork = 0;
+  cfg->wired_tx_buf = 1024;
+  cfg->wired_connect_timeout_ms = 3000;
+  cfg->wired_reconnect_min_ms = 200;
+  cfg->wired_reconnect_max_ms = 10000;
+  cfg->cmd_max_conns = 64;
+  cfg->cmd_backlog = 64;
+  cfg->cmd_idle_timeout_ms = 300000;
+
+  cfg->acc_table_cap = 256;
+  cfg->acc_table_max = 1u << 18;  // ~196k 사고까지 (load 3/4)
 
   cfg->gpiochip = "gpiochip2";
   cfg->led_line = 22;
+
+  const char *env;
+  if ((env = getenv("RSU_ZONES")) && *env) cfg->zones_path = env;
+  env_deg("RSU_LAT", 90.0, &cfg->rsu_lat);
+  env_deg("RSU_LON", 180.0, &cfg->rsu_lon);
+  if ((env = getenv("RSU_FILTER_RULES")) && *env) cfg->filter_rules_path = env;
+  if ((env = getenv("RSU_RUNTIME")) && *env) {
+    cfg->runtime_mode = strcmp(env, "evloop") == 0 ? RUNTIME_EVLOOP : RUNTIME_THREADS;
+  }
+  if ((env = getenv("RSU_TRACE")) && *env) cfg->trace_enable = (unsigned)atoi(env);
+  if ((env = getenv("RSU_SERVER_IP")) && *env) cfg->server_ip = env;
+  if ((env = getenv("RSU_WL1_TX_IP")) && *env) cfg->wl1_tx_ip = env;
+  if ((env = getenv("RSU_WL1_TX_PORT")) && *env) cfg->wl1_tx_port = (uint16_t)atoi(env);
+  if ((env = getenv("RSU_REPLAY")) && *env) cfg->replay_path = env;
+  if ((env = getenv("RSU_REPLAY_SPEED")) && *env) cfg->replay_speed = atof(env);
+  if ((env = getenv("RSU_REPLAY_TX")) && *env) cfg->replay_tx = (unsigned)atoi(env);
+  if ((env = getenv("RSU_STATS_SHM")) && *env) {
+    cfg->stats_shm_name = strcmp(env, "off") == 0 ? NULL : env;
+  }
   return 0;
 }
\ No newline at end of file
@@ -1,39 +1,371 @@
 #include "debug.h"
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/eventfd.h>
 #include <sys/time.h>
+#include <unistd.h>
 
 log_level_t g_log_level = LOG_DEBUG; // DEBUG 레벨까지 모두 출력
 
+// ===== 레코드 / 스레드별 링 =====
+#define LOG_REC_SIZE   256            // 레코드 하나 (본문이 길면 잘림)
+#define LOG_RING_SLOTS 1024           // 스레드당 256KB
+#define LOG_OUT_BUF    (64 * 1024)    // flusher 출력 버퍼 (fd별)
+
+typedef struct {
+    uint64_t ts_ns;          // CLOCK_REALTIME
+    const char *tag;         // 문자열 상수 (포인터만 보관)
+    const char *file;        // __FILE__ 또는 NULL
+    uint32_t line;
+    uint32_t suppressed;     // 이 줄 직전에 rate limit으로 버린 수
+    uint16_t len;
+    uint8_t  fd;
+    char text[LOG_REC_SIZE - 40];
+} log_rec_t;
+
+_Static_assert(sizeof(log_rec_t) == LOG_REC_SIZE, "log_rec_t size");
+
+typedef struct log_ring {
+    _Alignas(64) _Atomic uint32_t head;   // 생산자(소유 스레드)만 증가
+    _Alignas(64) _Atomic uint32_t tail;   // flusher만 증가
+    _Alignas(64) _Atomic uint64_t dropped;
+    _Atomic int orphan;                   // 소유 스레드 종료 -> 다 비면 다른 스레드가 재사용
+    struct log_ring *next;                // 등록 목록 (추가만, 해제는 log_shutdown 이후에도 안 함)
+    log_rec_t rec[LOG_RING_SLOTS];
+} log_ring_t;
+
+typedef enum { LOGGER_OFF = 0, LOGGER_RUNNING, LOGGER_STOPPED } logger_state_t;
+
+static _Atomic(log_ring_t*) g_rings;
+static _Atomic int g_state = LOGGER_OFF;
+static _Atomic int g_sleeping;            // flusher가 eventfd 대기 중
+static _Atomic bool g_stop;
+static int g_ev_fd = -1;
+static pthread_t g_th;
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_ring_key;
+static _Thread_local log_ring_t *t_ring;
+
+static uint64_t now_realtime_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void ring_release(void *arg) {
+    log_ring_t *r = (log_ring_t*)arg;
+    if (r) atomic_store(&r->orphan, 1);
+}
+
+// 종료된 스레드의 빈 링을 먼저 재사용 (스레드를 자주 만들었다 없애도 링 수가 늘지 않게)
+static log_ring_t* ring_acquire(void) {
+    for (log_ring_t *r = atomic_load(&g_rings); r; r = r->next) {
+        int expect = 1;
+        if (atomic_load(&r->orphan) &&
+            atomic_load(&r->head) == atomic_load(&r->tail) &&
+            atomic_compare_exchange_strong(&r->orphan, &expect, 0)) {
+            return r;
+        }
+    }
+    log_ring_t *r = (log_ring_t*)aligned_alloc(64, sizeof(log_ring_t));
+    if (!r) return NULL;
+    memset(r, 0, offsetof(log_ring_t, rec));
+    log_ring_t *head = atomic_load(&g_rings);
+    do {
+        r->next = head;
+    } while (!atomic_compare_exchange_weak(&g_rings, &head, r));
+    return r;
+}
+
+// ===== callsite rate limit =====
+// 반환: false = 이번 줄은 버림, true면 *suppressed에 그동안 버린 수
+static bool site_allow(log_site_t *site, uint64_t now_ns, uint32_t *suppressed) {
+    *suppressed = 0;
+    if (!site || LOG_RL_PER_SEC == 0) return true;
+    uint64_t sec = now_ns / 1000000000ull;
+    uint64_t cur = atomic_load_explicit(&site->sec, memory_order_relaxed);
+    if (cur != sec && atomic_compare_exchange_strong(&site->sec, &cur, sec)) {
+        atomic_store_explicit(&site->count, 0, memory_order_relaxed);
+    }
+    if (atomic_fetch_add_explicit(&site->count, 1, memory_order_relaxed) >= LOG_RL_PER_SEC) {
+        atomic_fetch_add_explicit(&site->suppressed, 1, memory_order_relaxed);
+        return false;
+    }
+    if (atomic_load_explicit(&site->suppressed, memory_order_relaxed)) {
+        *suppressed = atomic_exchange_explicit(&site->suppressed, 0, memory_order_relaxed);
+    }
+    return true;
+}
+
+// ===== 줄 포맷 (flusher / 동기 경로 공용) =====
+// hms: "HH:MM:SS" (호출자가 캐시)
+static size_t format_line(char *out, size_t cap, const char *hms, const log_rec_t *r) {
+    char sfx[32] = "";
+    if (r->suppressed) snprintf(sfx, sizeof(sfx), " (+%u suppressed)", r->suppressed);
+    int n;
+    if (r->file) {
+        n = snprintf(out, cap, "[%s.%03u][%s][%s:%u] %.*s%s\n", hms,
+                     (unsigned)((r->ts_ns / 1000000ull) % 1000), r->tag, r->file, r->line,
+                     (int)r->len, r->text, sfx);
+    } else {
+        n = snprintf(out, cap, "[%s] %.*s%s\n", r->tag, (int)r->len, r->text, sfx);
+    }
+    if (n < 0) return 0;
+    if ((size_t)n >= cap) {   // 잘림: 줄바꿈은 유지
+        out[cap - 2] = '\n';
+        return cap - 1;
+    }
+    return (size_t)n;
+}
+
+static void write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, buf, len);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return;   // 출력 불가 (닫힌 터미널 등) -> 버림
+        }
+        buf += w;
+        len -= (size_t)w;
+    }
+}
+
+// 로거가 없을 때 (시작 전 실패, 종료 후): 한 줄을 한 번의 write로
+static void emit_sync(const log_rec_t *r) {
+    char hms[16];
+    char line[LOG_REC_SIZE + 128];
+    time_t sec = (time_t)(r->ts_ns / 1000000000ull);
+    struct tm tm;
+    localtime_r(&sec, &tm);
+    strftime(hms, sizeof(hms), "%H:%M:%S", &tm);
+    write_all(r->fd, line, format_line(line, sizeof(line), hms, r));
+}
+
+// ===== flusher =====
+typedef struct {
+    char buf[LOG_OUT_BUF];
+    size_t len;
+} out_buf_t;
+
+static out_buf_t g_out[2];    // [0]=stdout [1]=stderr (flusher 전용)
+static time_t g_hms_sec = (time_t)-1;
+static char g_hms[16];
+
+static void out_flush(void) {
+    for (int i = 0; i < 2; i++) {
+        if (g_out[i].len) write_all(i + 1, g_out[i].buf, g_out[i].len);
+        g_out[i].len = 0;
+    }
+}
+
+static void out_rec(const log_rec_t *r) {
+    time_t sec = (time_t)(r->ts_ns / 1000000000ull);
+    if (sec != g_hms_sec) {   // 초가 바뀔 때만 localtime/strftime
+        struct tm tm;
+        localtime_r(&sec, &tm);
+        strftime(g_hms, sizeof(g_hms), "%H:%M:%S", &tm);
+        g_hms_sec = sec;
+    }
+    out_buf_t *o = &g_out[r->fd == 2 ? 1 : 0];
+    if (LOG_OUT_BUF - o->len < LOG_REC_SIZE + 128) out_flush();
+    o->len += format_line(o->buf + o->len, LOG_OUT_BUF - o->len, g_hms, r);
+}
+
+static bool any_pending(void) {
+    for (log_ring_t *r = atomic_load(&g_rings); r; r = r->next) {
+        if (atomic_load_explicit(&r->head, memory_order_acquire) != atomic_load(&r->tail)) return true;
+    }
+    return false;
+}
+
+// 모든 링의 밀린 레코드를 시각 순으로 출력, 반환: 출력한 줄 수
+static uint64_t drain_all(void) {
+    uint64_t total = 0;
+    for (;;) {
+        log_ring_t *best = NULL;
+        uint64_t best_ts = UINT64_MAX;
+        for (log_ring_t *r = atomic_load(&g_rings); r; r = r->next) {
+            uint32_t t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+            if (atomic_load_explicit(&r->head, memory_order_acquire) == t) continue;
+            uint64_t ts = r->rec[t % LOG_RING_SLOTS].ts_ns;
+            if (ts < best_ts) { best_ts = ts; best = r; }
+        }
+        if (!best) break;
+        uint32_t t = atomic_load_explicit(&best->tail, memory_order_relaxed);
+        out_rec(&best->rec[t % LOG_RING_SLOTS]);
+        atomic_store_explicit(&best->tail, t + 1, memory_order_release);
+        total++;
+    }
+    out_flush();
+    return total;
+}
+
+static uint64_t sum_dropped(void) {
+    uint64_t n = 0;
+    for (log_ring_t *r = atomic_load(&g_rings); r; r = r->next) n += atomic_load(&r->dropped);
+    return n;
+}
+
+static void* flusher_thread(void *arg) {
+    (void)arg;
+    uint64_t reported = 0;
+    uint64_t last_report_ns = 0;
+    while (!atomic_load(&g_stop)) {
+        if (drain_all()) continue;
+
+        uint64_t now = now_realtime_ns();
+        if (now - last_report_ns >= 1000000000ull) {
+            uint64_t d = sum_dropped();
+            if (d != reported) {
+                char msg[96];
+                int n = snprintf(msg, sizeof(msg), "[W] log: %llu lines dropped (ring full)\n",
+                                 (unsigned long long)(d - reported));
+                if (n > 0) write_all(1, msg, (size_t)n);
+                reported = d;
+            }
+            last_report_ns = now;
+        }
+
+        // 잠들기 전에 다시 확인 (생산자는 head 갱신 후 g_sleeping을 봄)
+        atomic_store(&g_sleeping, 1);
+        if (any_pending() || atomic_load(&g_stop)) {
+            atomic_store(&g_sleeping, 0);
+            continue;
+        }
+        struct pollfd pfd = { .fd = g_ev_fd, .events = POLLIN };
+        if (poll(&pfd, 1, 1000) > 0) {
+            uint64_t v;
+            ssize_t rr = read(g_ev_fd, &v, sizeof(v));
+            (void)rr;
+        }
+        atomic_store(&g_sleeping, 0);
+    }
+    drain_all();
+    return NULL;
+}
+
+static void wake_flusher(void) {
+    uint64_t one = 1;
+    ssize_t w = write(g_ev_fd, &one, sizeof(one));
+    (void)w;
+}
+
+static void logger_start_once(void) {
+    if (pthread_key_create(&g_ring_key, ring_release) != 0) return;
+    g_ev_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (g_ev_fd < 0) return;
+    if (pthread_create(&g_th, NULL, flusher_thread, NULL) != 0) {
+        close(g_ev_fd);
+        g_ev_fd = -1;
+        return;
+    }
+    atomic_store(&g_state, LOGGER_RUNNING);
+    atexit(log_shutdown);
+}
+
+static void log_vemit(log_site_t *site, int fd, const char *tag, const char *file, int line,
+                      const char *fmt, va_list ap) {
+    uint64_t now = now_realtime_ns();
+    uint32_t suppressed;
+    if (!site_allow(site, now, &suppressed)) return;
+
+    if (atomic_load_explicit(&g_state, memory_order_acquire) == LOGGER_OFF) {
+        pthread_once(&g_once, logger_start_once);
+    }
+
+    log_ring_t *r = NULL;
+    if (atomic_load_explicit(&g_state, memory_order_acquire) == LOGGER_RUNNING) {
+        r = t_ring;
+        if (!r && (r = ring_acquire()) != NULL) {
+            t_ring = r;
+            pthread_setspecific(g_ring_key, r);
+        }
+    }
+
+    log_rec_t tmp;
+    log_rec_t *rec = &tmp;
+    uint32_t h = 0;
+    if (r) {
+        h = atomic_load_explicit(&r->head, memory_order_relaxed);
+        if (h - atomic_load_explicit(&r->tail, memory_order_acquire) >= LOG_RING_SLOTS) {
+            atomic_fetch_add_explicit(&r->dropped, 1, memory_order_relaxed);
+            return;   // 가득 참: 기다리지 않고 버림
+        }
+        rec = &r->rec[h % LOG_RING_SLOTS];
+    }
+
+    rec->ts_ns = now;
+    rec->tag = tag;
+    rec->file = file;
+    rec->line = (uint32_t)line;
+    rec->suppressed = suppressed;
+    rec->fd = (uint8_t)fd;
+    int n = vsnprintf(rec->text, sizeof(rec->text), fmt, ap);
+    if (n < 0) n = 0;
+    rec->len = (uint16_t)(((size_t)n < sizeof(rec->text)) ? (size_t)n : sizeof(rec->text) - 1);
+
+    if (!r) {
+        emit_sync(rec);
+        return;
+    }
+    atomic_store_explicit(&r->head, h + 1, memory_order_release);
+    // head 공개와 g_sleeping 확인 사이 순서 보장 (flusher의 store g_sleeping -> any_pending과 짝)
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&g_sleeping, memory_order_relaxed) && atomic_exchange(&g_sleeping, 0)) {
+        wake_flusher();
+    }
+}
+
+void log_emit(log_site_t *site, int fd, const char *tag, const char *file, int line,
+              const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    log_vemit(site, fd, tag, file, line, fmt, ap);
+    va_end(ap);
+}
+
+void log_flush(void) {
+    if (atomic_load(&g_state) != LOGGER_RUNNING) return;
+    for (int i = 0; i < 1000; i++) {
+        // flusher는 g_sleeping = 1인 동안 링을 건드리지 않음 -> 비어 있고 잠들었으면 다 써진 것
+        if (atomic_load(&g_sleeping) && !any_pending()) return;
+        wake_flusher();
+        struct timespec ts = { 0, 1000000 };
+        nanosleep(&ts, NULL);
+    }
+}
+
+void log_shutdown(void) {
+    int expect = LOGGER_RUNNING;
+    if (!atomic_compare_exchange_strong(&g_state, &expect, LOGGER_STOPPED)) return;
+    atomic_store(&g_stop, true);
+    wake_flusher();
+    pthread_join(g_th, NULL);
+    drain_all();   // stop 직전에 링에 들어간 줄
+}
+
+uint64_t log_dropped(void) {
+    return sum_dropped();
+}
+
 void debug_init() {
     // 인터넷 연결 시 시간 동기화 (필요 없으면 주석 처리)
-    // system("sudo ntpdate -u pool.ntp.org"); 
-    
+    // system("sudo ntpdate -u pool.ntp.org");
+
     setenv("TZ", "KST-9", 1);
     tzset();
-    printf("[DEBUG] System Initialized (KST)\n");
+    log_emit(NULL, 1, "DEBUG", NULL, 0, "System Initialized (KST)");
 }
 
 void debug_log(const char *level, const char *file, int line, const char *fmt, ...) {
-    char time_buf[64];
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    
-    struct tm *tm = localtime(&tv.tv_sec);
-    long millis = tv.tv_usec / 1000;
-    // long micros = tv.tv_usec % 1000; // 마이크로초 단위까지 확인하고 싶다면
-
-    // [HH:MM:SS.ms] 형식
-    strftime(time_buf, sizeof(time_buf), "%H:%M:%S", tm);
-    
-    // 쓰레드 안전성을 위해 printf 한 번에 호출 권장
-    printf("[%s.%03ld][%s][%s:%d] ", time_buf, millis, level, file, line);
-
     va_list ap;
     va_start(ap, fmt);
-    vprintf(fmt, ap);
+    log_vemit(NULL, 1, level, file, line, fmt, ap);
     va_end(ap);
-
-    printf("\n");
-}
\ No newline at end of file
+}
@@ -1,45 +1,390 @@
 #include "filter.h"
 #include "types.h"
 
-static bool light_pass(const wl1_packet_t *pkt) {
-  if (!pkt) return false;
+#include "log.h"
 
-  // 1) msg_type==0x01(RSU)면 drop
-  if (pkt->payload.header.msg_type == 0x01) return false;
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-  // 2) ttl!=1 이면 drop
-  if (pkt->payload.header.ttl != 3) return false;
+// ---- heavy: 담당영역 + 거리 ----
 
-  // 3) header version 체크 (예: 1)
-  if (pkt->payload.header.version != 1) return false;
+// 위도 1e-6도 = 0.111195m (지구 반지름 6371.0088km 기준) -> mm, Q16
+#define GEO_MM_PER_UNIT_Q16 7287275LL
+#define GEO_DIST_MAX_M      0xffffffffu
 
-  return true;
+#ifndef GEO_GRID_MAX_CELLS
+#define GEO_GRID_MAX_CELLS (1u << 20)
+#endif
+#ifndef GEO_POLY_MAX_V
+#define GEO_POLY_MAX_V 64
+#endif
+
+// cos(x) (|x| <= pi/2), 초기화 때 한 번만 쓰므로 테일러 전개로 충분 (libm 미사용)
+static double cos_poly(double x) {
+  double x2 = x * x;
+  return 1.0 - x2 / 2 * (1.0 - x2 / 12 * (1.0 - x2 / 30 * (1.0 - x2 / 56 * (1.0 - x2 / 90))));
 }
 
-static bool heavy_pass(const wl1_packet_t *pkt, uint32_t *out_dist_m) {
-  if (!pkt) return false;
+// 비트 단위 정수 제곱근 (분기 없는 형태, 최대 32회)
+static uint64_t isqrt64(uint64_t v) {
+  if (v == 0) return 0;
+  uint64_t r = 0, bit = 1ull << ((63 - __builtin_clzll(v)) & ~1);
+  while (bit) {
+    uint64_t m = (uint64_t)0 - (uint64_t)(v >= r + bit);
+    v -= (r + bit) & m;
+    r = (r >> 1) + (bit & m);
+    bit >>= 2;
+  }
+  return r;
+}
+
+static void set_origin(filter_ctx_t *ctx, int32_t lat, int32_t lon) {
+  ctx->rsu_lat = lat;
+  ctx->rsu_lon = lon;
+  double rad = (double)lat / GEO_UNITS_PER_DEG * (3.14159265358979323846 / 180.0);
+  double c = cos_poly(rad);
+  if (c < 0) c = 0;
+  ctx->k_lat_q16 = GEO_MM_PER_UNIT_Q16;
+  ctx->k_lon_q16 = (int64_t)((double)GEO_MM_PER_UNIT_Q16 * c + 0.5);
+}
+
+// equirectangular 근사 (수 km 단위 RSU 커버리지에서 오차 무시 가능)
+uint32_t filter_distance_m(const filter_ctx_t *ctx, int32_t lat, int32_t lon) {
+  int64_t dlat = (int64_t)lat - ctx->rsu_lat;
+  int64_t dlon = (int64_t)lon - ctx->rsu_lon;
+  if (dlon > 180LL * GEO_UNITS_PER_DEG) dlon -= 360LL * GEO_UNITS_PER_DEG;
+  if (dlon < -180LL * GEO_UNITS_PER_DEG) dlon += 360LL * GEO_UNITS_PER_DEG;
+  int64_t y = (dlat * ctx->k_lat_q16) >> 16;   // mm
+  int64_t x = (dlon * ctx->k_lon_q16) >> 16;
+  int64_t ym = y / 1000, xm = x / 1000;         // m (제곱이 64bit 안에 들도록)
+  uint64_t d = isqrt64((uint64_t)(ym * ym) + (uint64_t)(xm * xm));
+  return d > GEO_DIST_MAX_M ? GEO_DIST_MAX_M : (uint32_t)d;
+}
+
+static bool dir_match(const geo_zone_t *z, uint16_t dir) {
+  if (z->dir_any) return true;
+  int d = (int)(dir % 360) - (int)z->dir_deg;
+  if (d < 0) d = -d;
+  if (d > 180) d = 360 - d;
+  return d <= (int)z->dir_tol;
+}
+
+// crossing number, 경계 위의 점은 한쪽으로만 계산됨
+static bool poly_contains(const geo_pt_t *v, uint32_t n, int32_t lat, int32_t lon) {
+  bool in = false;
+  for (uint32_t i = 0, j = n - 1; i < n; j = i++) {
+    if ((v[i].lat > lat) != (v[j].lat > lat)) {
+      // lon < v[j].lon + (lat - v[j].lat) * (v[i].lon - v[j].lon) / (v[i].lat - v[j].lat)
+      int64_t dy = (int64_t)v[i].lat - v[j].lat;
+      int64_t lhs = ((int64_t)lon - v[j].lon) * dy;
+      int64_t rhs = ((int64_t)lat - v[j].lat) * ((int64_t)v[i].lon - v[j].lon);
+      if (dy > 0 ? lhs < rhs : lhs > rhs) in = !in;
+    }
+  }
+  return in;
+}
+
+static inline bool zone_match(const filter_ctx_t *ctx, const geo_zone_t *z,
+                              int32_t lat, int32_t lon, uint16_t dir) {
+  if (lat < z->lat_min || lat > z->lat_max || lon < z->lon_min || lon > z->lon_max) return false;
+  if (!dir_match(z, dir)) return false;
+  if (z->kind == ZONE_RECT) return true;
+  return poly_contains(&ctx->verts[z->v_off], z->n_v, lat, lon);
+}
 
-  // severity < 2 drop
-  if (pkt->payload.accident.severity < 2) return false;
+int filter_find_zone_linear(const filter_ctx_t *ctx, int32_t lat, int32_t lon, uint16_t dir) {
+  for (uint32_t i = 0; i < ctx->n_zones; i++) {
+    if (zone_match(ctx, &ctx->zones[i], lat, lon, dir)) return (int)i;
+  }
+  return -1;
+}
+
+int filter_find_zone(const filter_ctx_t *ctx, int32_t lat, int32_t lon, uint16_t dir) {
+  if (!ctx->g_start) return filter_find_zone_linear(ctx, lat, lon, dir);
+  int64_t r = ((int64_t)lat - ctx->g_lat0) / ctx->g_cell_lat;
+  int64_t c = ((int64_t)lon - ctx->g_lon0) / ctx->g_cell_lon;
+  if (lat < ctx->g_lat0 || lon < ctx->g_lon0 || r >= ctx->g_rows || c >= ctx->g_cols) return -1;
+  uint32_t cell = (uint32_t)r * ctx->g_cols + (uint32_t)c;
+  // 셀 목록은 영역 번호 오름차순 -> 선형 탐색과 같은 영역을 돌려줌
+  for (uint32_t k = ctx->g_start[cell]; k < ctx->g_start[cell + 1]; k++) {
+    uint32_t zi = ctx->g_zone[k];
+    if (zone_match(ctx, &ctx->zones[zi], lat, lon, dir)) return (int)zi;
+  }
+  return -1;
+}
+
+static int push_zone(filter_ctx_t *ctx, const geo_zone_t *z) {
+  if (ctx->n_zones == ctx->cap_zones) {
+    uint32_t cap = ctx->cap_zones ? ctx->cap_zones * 2 : 64;
+    geo_zone_t *nz = realloc(ctx->zones, (size_t)cap * sizeof(*nz));
+    if (!nz) return -1;
+    ctx->zones = nz;
+    ctx->cap_zones = cap;
+  }
+  ctx->zones[ctx->n_zones++] = *z;
+  return 0;
+}
+
+static void zone_set_dir(geo_zone_t *z, int dir_deg, int dir_tol) {
+  z->dir_any = dir_deg < 0 || dir_tol >= 180;
+  z->dir_deg = (uint16_t)(dir_deg < 0 ? 0 : dir_deg % 360);
+  z->dir_tol = (uint16_t)(dir_tol < 0 ? 0 : dir_tol);
+}
+
+int filter_add_rect(filter_ctx_t *ctx, geo_pt_t a, geo_pt_t b, int dir_deg, int dir_tol) {
+  geo_zone_t z = { .kind = ZONE_RECT };
+  z.lat_min = a.lat < b.lat ? a.lat : b.lat;
+  z.lat_max = a.lat < b.lat ? b.lat : a.lat;
+  z.lon_min = a.lon < b.lon ? a.lon : b.lon;
+  z.lon_max = a.lon < b.lon ? b.lon : a.lon;
+  zone_set_dir(&z, dir_deg, dir_tol);
+  return push_zone(ctx, &z);
+}
+
+int filter_add_poly(filter_ctx_t *ctx, const geo_pt_t *v, uint32_t n, int dir_deg, int dir_tol) {
+  if (n < 3) return -1;
+  if (ctx->n_verts + n > ctx->cap_verts) {
+    uint32_t cap = ctx->cap_verts ? ctx->cap_verts : 256;
+    while (cap < ctx->n_verts + n) cap *= 2;
+    geo_pt_t *nv = realloc(ctx->verts, (size_t)cap * sizeof(*nv));
+    if (!nv) return -1;
+    ctx->verts = nv;
+    ctx->cap_verts = cap;
+  }
+  geo_zone_t z = { .kind = ZONE_POLY, .v_off = ctx->n_verts, .n_v = n };
+  z.lat_min = z.lat_max = v[0].lat;
+  z.lon_min = z.lon_max = v[0].lon;
+  for (uint32_t i = 0; i < n; i++) {
+    if (v[i].lat < z.lat_min) z.lat_min = v[i].lat;
+    if (v[i].lat > z.lat_max) z.lat_max = v[i].lat;
+    if (v[i].lon < z.lon_min) z.lon_min = v[i].lon;
+    if (v[i].lon > z.lon_max) z.lon_max = v[i].lon;
+  }
+  zone_set_dir(&z, dir_deg, dir_tol);
+  if (push_zone(ctx, &z) != 0) return -1;
+  memcpy(&ctx->verts[ctx->n_verts], v, (size_t)n * sizeof(*v));
+  ctx->n_verts += n;
+  return 0;
+}
+
+static void grid_free(filter_ctx_t *ctx) {
+  free(ctx->g_start);
+  free(ctx->g_zone);
+  ctx->g_start = NULL;
+  ctx->g_zone = NULL;
+  ctx->g_rows = ctx->g_cols = 0;
+}
+
+static void zone_cells(const filter_ctx_t *ctx, const geo_zone_t *z,
+                       uint32_t *r0, uint32_t *r1, uint32_t *c0, uint32_t *c1) {
+  *r0 = (uint32_t)(((int64_t)z->lat_min - ctx->g_lat0) / ctx->g_cell_lat);
+  *r1 = (uint32_t)(((int64_t)z->lat_max - ctx->g_lat0) / ctx->g_cell_lat);
+  *c0 = (uint32_t)(((int64_t)z->lon_min - ctx->g_lon0) / ctx->g_cell_lon);
+  *c1 = (uint32_t)(((int64_t)z->lon_max - ctx->g_lon0) / ctx->g_cell_lon);
+  if (*r1 >= ctx->g_rows) *r1 = ctx->g_rows - 1;
+  if (*c1 >= ctx->g_cols) *c1 = ctx->g_cols - 1;
+}
 
-  // TODO: 직사각 담당영역 판정 + direction 상/하행 일치 판정
-  // 지금은 스텁으로 통과 처리
-  if (out_dist_m) *out_dist_m = 120; // 예시 거리
+/*
+ * 영역 bbox 전체를 덮는 균일 격자 (셀 수 ~ 영역 수 x 4)
+ * 각 셀에 bbox가 겹치는 영역 번호를 CSR로 저장 -> 조회는 셀 1개 + 그 셀의 후보만 검사
+ */
+int filter_build_index(filter_ctx_t *ctx) {
+  grid_free(ctx);
+  if (ctx->n_zones == 0) return 0;
 
+  int32_t lat0 = ctx->zones[0].lat_min, lat1 = ctx->zones[0].lat_max;
+  int32_t lon0 = ctx->zones[0].lon_min, lon1 = ctx->zones[0].lon_max;
+  for (uint32_t i = 1; i < ctx->n_zones; i++) {
+    const geo_zone_t *z = &ctx->zones[i];
+    if (z->lat_min < lat0) lat0 = z->lat_min;
+    if (z->lat_max > lat1) lat1 = z->lat_max;
+    if (z->lon_min < lon0) lon0 = z->lon_min;
+    if (z->lon_max > lon1) lon1 = z->lon_max;
+  }
+  int64_t h = (int64_t)lat1 - lat0 + 1, w = (int64_t)lon1 - lon0 + 1;
+
+  // rows*cols ~ target, 셀 모양은 bbox 비율을 따름
+  uint64_t target = (uint64_t)ctx->n_zones * 4;
+  if (target > GEO_GRID_MAX_CELLS) target = GEO_GRID_MAX_CELLS;
+  uint64_t rows = isqrt64(target * (uint64_t)h / (uint64_t)w);
+  if (rows < 1) rows = 1;
+  if (rows > (uint64_t)h) rows = (uint64_t)h;
+  uint64_t cols = target / rows;
+  if (cols < 1) cols = 1;
+  if (cols > (uint64_t)w) cols = (uint64_t)w;
+
+  ctx->g_lat0 = lat0;
+  ctx->g_lon0 = lon0;
+  ctx->g_cell_lat = (int32_t)((h + (int64_t)rows - 1) / (int64_t)rows);
+  ctx->g_cell_lon = (int32_t)((w + (int64_t)cols - 1) / (int64_t)cols);
+  ctx->g_rows = (uint32_t)((h + ctx->g_cell_lat - 1) / ctx->g_cell_lat);
+  ctx->g_cols = (uint32_t)((w + ctx->g_cell_lon - 1) / ctx->g_cell_lon);
+
+  uint32_t n_cells = ctx->g_rows * ctx->g_cols;
+  ctx->g_start = calloc((size_t)n_cells + 1, sizeof(uint32_t));
+  if (!ctx->g_start) return -1;
+
+  // 1) 셀별 개수
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < ctx->n_zones; i++) {
+    uint32_t r0, r1, c0, c1;
+    zone_cells(ctx, &ctx->zones[i], &r0, &r1, &c0, &c1);
+    for (uint32_t r = r0; r <= r1; r++) {
+      for (uint32_t c = c0; c <= c1; c++) ctx->g_start[r * ctx->g_cols + c + 1]++;
+    }
+    total += (uint64_t)(r1 - r0 + 1) * (c1 - c0 + 1);
+  }
+  if (total > UINT32_MAX) {
+    grid_free(ctx);
+    return -1;
+  }
+  for (uint32_t i = 0; i < n_cells; i++) ctx->g_start[i + 1] += ctx->g_start[i];
+
+  // 2) 채우기 (영역 번호 순서대로 -> 셀 안에서도 오름차순)
+  ctx->g_zone = malloc((size_t)(total ? total : 1) * sizeof(uint32_t));
+  uint32_t *fill = malloc((size_t)n_cells * sizeof(uint32_t));
+  if (!ctx->g_zone || !fill) {
+    free(fill);
+    grid_free(ctx);
+    return -1;
+  }
+  memcpy(fill, ctx->g_start, (size_t)n_cells * sizeof(uint32_t));
+  for (uint32_t i = 0; i < ctx->n_zones; i++) {
+    uint32_t r0, r1, c0, c1;
+    zone_cells(ctx, &ctx->zones[i], &r0, &r1, &c0, &c1);
+    for (uint32_t r = r0; r <= r1; r++) {
+      for (uint32_t c = c0; c <= c1; c++) ctx->g_zone[fill[r * ctx->g_cols + c]++] = i;
+    }
+  }
+  free(fill);
+  return 0;
+}
+
+// lim: 위도 90, 경도 180
+static bool parse_deg(const char *tok, double lim, int32_t *out) {
+  char *end;
+  double deg = strtod(tok, &end);
+  if (end == tok || *end != '\0' || deg < -lim || deg > lim) return false;
+  *out = (int32_t)(deg * GEO_UNITS_PER_DEG + (deg < 0 ? -0.5 : 0.5));
   return true;
 }
 
-void filter_init(filter_ctx_t *ctx, uint32_t rsu_id) {
+static bool parse_lat(const char *tok, int32_t *out) { return parse_deg(tok, 90.0, out); }
+static bool parse_lon(const char *tok, int32_t *out) { return parse_deg(tok, 180.0, out); }
+
+static bool parse_int(const char *tok, long lo, long hi, int *out) {
+  char *end;
+  long v = strtol(tok, &end, 10);
+  if (end == tok || *end != '\0' || v < lo || v > hi) return false;
+  *out = (int)v;
+  return true;
+}
+
+static bool parse_zone_line(filter_ctx_t *ctx, char *line) {
+  char *tok[2 + GEO_POLY_MAX_V * 2 + 3];
+  int nt = 0;
+  char *save;
+  for (char *t = strtok_r(line, " \t\r\n", &save); t; t = strtok_r(NULL, " \t\r\n", &save)) {
+    if (nt == (int)(sizeof(tok) / sizeof(tok[0]))) return false;
+    tok[nt++] = t;
+  }
+  if (nt == 0) return true;   // 빈 줄
+
+  bool is_rect = strcmp(tok[0], "rect") == 0;
+  if (!is_rect && strcmp(tok[0], "poly") != 0) return false;
+
+  // 끝의 "dir <deg> <tol>" (없으면 방향 무관)
+  int dir = -1, tol = 0;
+  int n_coord = nt - 1;
+  if (nt >= 4 && strcmp(tok[nt - 3], "dir") == 0) {
+    if (!parse_int(tok[nt - 2], 0, 359, &dir) || !parse_int(tok[nt - 1], 0, 180, &tol)) return false;
+    n_coord -= 3;
+  }
+  if (n_coord % 2 != 0) return false;
+
+  geo_pt_t v[GEO_POLY_MAX_V];
+  uint32_t n = (uint32_t)(n_coord / 2);
+  if (n > GEO_POLY_MAX_V) return false;
+  for (uint32_t i = 0; i < n; i++) {
+    if (!parse_lat(tok[1 + 2 * i], &v[i].lat) || !parse_lon(tok[2 + 2 * i], &v[i].lon)) return false;
+  }
+  if (is_rect) return n == 2 && filter_add_rect(ctx, v[0], v[1], dir, tol) == 0;
+  return filter_add_poly(ctx, v, n, dir, tol) == 0;
+}
+
+int filter_load_zones(filter_ctx_t *ctx, const char *path) {
+  FILE *fp = fopen(path, "r");
+  if (!fp) {
+    LOGW("filter: zones file %s: %s", path, strerror(errno));
+    return -1;
+  }
+  char line[4096];   // poly 최대 GEO_POLY_MAX_V 꼭짓점
+  int lineno = 0, rc = 0;
+  while (fgets(line, sizeof(line), fp)) {
+    lineno++;
+    char *hash = strchr(line, '#');
+    if (hash) *hash = '\0';
+    if (!parse_zone_line(ctx, line)) {
+      LOGW("filter: %s:%d: bad zone line", path, lineno);
+      rc = -1;
+      break;
+    }
+  }
+  fclose(fp);
+  if (rc != 0) return -1;
+  return filter_build_index(ctx);
+}
+
+int filter_init(filter_ctx_t *ctx, const app_config_t *cfg) {
+  if (!ctx || !cfg) return -1;
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->rsu_id = cfg->rsu_id;
+  set_origin(ctx, cfg->rsu_lat, cfg->rsu_lon);
+  if (cfg->zones_path && cfg->zones_path[0]) {
+    if (filter_load_zones(ctx, cfg->zones_path) != 0) {
+      filter_destroy(ctx);
+      return -1;
+    }
+    LOGI("filter: %u zones from %s (grid %ux%u, %u refs), RSU at %.6f,%.6f", ctx->n_zones, cfg->zones_path,
+         ctx->g_rows, ctx->g_cols, ctx->g_start ? ctx->g_start[ctx->g_rows * ctx->g_cols] : 0,
+         (double)cfg->rsu_lat / GEO_UNITS_PER_DEG, (double)cfg->rsu_lon / GEO_UNITS_PER_DEG);
+  }
+  return 0;
+}
+
+void filter_destroy(filter_ctx_t *ctx) {
   if (!ctx) return;
-  ctx->rsu_id = rsu_id;
+  grid_free(ctx);
+  free(ctx->zones);
+  free(ctx->verts);
+  ctx->zones = NULL;
+  ctx->verts = NULL;
+  ctx->n_zones = ctx->cap_zones = ctx->n_verts = ctx->cap_verts = 0;
+}
+
+static bool heavy_pass(const filter_ctx_t *ctx, const wl1_packet_t *pkt, uint32_t *out_dist_m) {
+  if (!pkt) return false;
+  const acc_info_t *a = &pkt->payload.accident;
+
+  // 담당영역이 설정돼 있으면 위치 + 진행 방향이 맞는 영역이 있어야 통과
+  if (ctx->n_zones && filter_find_zone(ctx, a->lat, a->lon, a->direction) < 0) return false;
+
+  if (out_dist_m) *out_dist_m = filter_distance_m(ctx, a->lat, a->lon);
+  return true;
 }
 
-bool filter_pass_all(const void *raw_pkt, uint32_t rsu_id, uint32_t *out_dist_m) {
-    (void)rsu_id; // 경고 방지
+bool filter_pass_all(const filter_ctx_t *ctx, const void *raw_pkt, uint32_t *out_dist_m) {
     const wl1_packet_t *pkt = (const wl1_packet_t*)raw_pkt;
 
-    if (!light_pass(pkt)) return false;
-    if (!heavy_pass(pkt, out_dist_m)) return false;
+    if (!filter_pass_light(pkt)) return false;
+    if (!heavy_pass(ctx, pkt, out_dist_m)) return false;
 
     return true;
-}
\ No newline at end of file
+}
+
+bool filter_pass_heavy(const filter_ctx_t *ctx, const void *raw_pkt, uint32_t *out_dist_m) {
+    return heavy_pass(ctx, (const wl1_packet_t*)raw_pkt, out_dist_m);
+}
@@ -0,0 +1,737 @@
+#include "filter.h"
+#include "types.h"
+
+#include "log.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FILTER_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FILTER_NEON 1
+#endif
+
+/*
+ * light filter = 규칙 목록을 컴파일한 술어 프로그램
+ * - 규칙마다 필드 폭/종류에 맞춘 전용 함수 (범위 비교는 (v - lo) <= span 하나로, 분기 없음)
+ * - header/severity 바이트 규칙은 패킷별 32bit 키에서 SIMD로 배치 평가
+ * - 규칙별 평가/탈락 수를 세고, 주기적으로 "탈락률 / 비용"이 큰 규칙부터 오도록 순서 재배치
+ */
+
+#ifndef FILTER_REORDER_EVERY
+#define FILTER_REORDER_EVERY 65536u   // 평가한 패킷 수 기준 재배치 주기
+#endif
+
+// 1) msg_type==0x01(RSU)면 drop  2) ttl!=3 drop  3) header version 1  4) severity < 2 drop
+#define FILTER_DEFAULT_RULES "msg_type != 1; ttl == 3; version == 1; severity >= 2"
+
+// ---- 필드 ----
+// 패킷 키 (little endian): [version | msg_type<<8 | ttl<<16 | severity<<24]
+//   = header 워드의 하위 24bit + accident 첫 워드(direction, lane, severity)의 최상위 바이트
+#define ACC_OFF ((int)offsetof(wl1_payload_t, accident))
+
+typedef struct {
+  const char *name;
+  uint16_t off;      // wl1_payload_t 내 오프셋
+  uint8_t width;     // 1/2/4/8
+  bool is_signed;
+  int8_t key_shift;  // 패킷 키 안의 비트 위치 (-1: 키에 없음)
+} field_def_t;
+
+static const field_def_t g_fields[] = {
+  { "version",       offsetof(wl1_payload_t, header.version),        1, false, 0 },
+  { "msg_type",      offsetof(wl1_payload_t, header.msg_type),       1, false, 8 },
+  { "ttl",           offsetof(wl1_payload_t, header.ttl),            1, false, 16 },
+  { "sender_id",     offsetof(wl1_payload_t, sender.sender_id),      4, false, -1 },
+  { "send_time",     offsetof(wl1_payload_t, sender.send_time),      8, false, -1 },
+  { "sender_lat",    offsetof(wl1_payload_t, sender.lat),            4, true,  -1 },
+  { "sender_lon",    offsetof(wl1_payload_t, sender.lon),            4, true,  -1 },
+  { "sender_alt",    offsetof(wl1_payload_t, sender.alt),            4, true,  -1 },
+  { "direction",     offsetof(wl1_payload_t, accident.direction),    2, false, -1 },
+  { "lane",          offsetof(wl1_payload_t, accident.lane),         1, false, -1 },
+  { "severity",      offsetof(wl1_payload_t, accident.severity),     1, false, 24 },
+  { "accident_time", offsetof(wl1_payload_t, accident.accident_time), 8, false, -1 },
+  { "accident_id",   offsetof(wl1_payload_t, accident.accident_id),  8, false, -1 },
+  { "lat",           offsetof(wl1_payload_t, accident.lat),          4, true,  -1 },
+  { "lon",           offsetof(wl1_payload_t, accident.lon),          4, true,  -1 },
+  { "alt",           offsetof(wl1_payload_t, accident.alt),          4, true,  -1 },
+};
+
+static inline uint32_t light_key(const wl1_packet_t *pkt) {
+  uint32_t h, a;
+  memcpy(&h, &pkt->payload.header, sizeof(h));
+  memcpy(&a, &pkt->payload.accident, sizeof(a));
+  return (h & 0x00ffffffu) | (a & 0xff000000u);
+}
+
+// ---- 컴파일된 규칙 ----
+typedef enum {
+  RULE_CONST = 0,  // 항상 통과/탈락 (범위가 비었거나 필드 전체)
+  RULE_RANGE,      // lo <= v <= hi (neg면 반대)
+  RULE_SET,        // v in {..} (neg면 반대)
+} rule_kind_t;
+
+typedef struct flt_rule flt_rule_t;
+typedef bool (*rule_fn_t)(const flt_rule_t *r, const uint8_t *payload);
+
+struct flt_rule {
+  rule_fn_t fn;
+  uint8_t kind;
+  bool neg;
+  int8_t key_shift;
+  uint8_t cost;          // 패킷당 상대 비용 (순서 재배치용)
+  uint16_t off;
+  uint8_t n_set;
+  int64_t lo;
+  uint64_t span;         // hi - lo
+  uint64_t bm[4];        // 1바이트 필드 집합 (256bit)
+  int64_t set[FILTER_SET_MAX];
+  char text[FILTER_RULE_TEXT];
+
+  // 재배치 전까지 누적된 값 (현재 순서의 몫은 g_prog.exits에)
+  _Atomic uint64_t evals;
+  _Atomic uint64_t rejects;
+};
+
+static bool fn_const(const flt_rule_t *r, const uint8_t *p) {
+  (void)p;
+  return !r->neg;
+}
+
+#define RANGE_FN(name, T)                                                   \
+  static bool name(const flt_rule_t *r, const uint8_t *p) {                 \
+    T v;                                                                    \
+    memcpy(&v, p + r->off, sizeof(v));                                      \
+    return ((uint64_t)(int64_t)v - (uint64_t)r->lo <= r->span) != r->neg;   \
+  }
+RANGE_FN(fn_range_u8, uint8_t)
+RANGE_FN(fn_range_u16, uint16_t)
+RANGE_FN(fn_range_u32, uint32_t)
+RANGE_FN(fn_range_i32, int32_t)
+RANGE_FN(fn_range_u64, uint64_t)
+
+static bool fn_set_u8(const flt_rule_t *r, const uint8_t *p) {
+  uint8_t v = p[r->off];
+  return ((r->bm[v >> 6] >> (v & 63)) & 1u) != r->neg;
+}
+
+#define SET_FN(name, T)                                                     \
+  static bool name(const flt_rule_t *r, const uint8_t *p) {                 \
+    T v;                                                                    \
+    memcpy(&v, p + r->off, sizeof(v));                                      \
+    bool in = false;                                                        \
+    for (int i = 0; i < r->n_set; i++) in |= (int64_t)v == r->set[i];       \
+    return in != r->neg;                                                    \
+  }
+SET_FN(fn_set_u16, uint16_t)
+SET_FN(fn_set_u32, uint32_t)
+SET_FN(fn_set_i32, int32_t)
+SET_FN(fn_set_u64, uint64_t)
+
+/*
+ * 프로그램: 규칙 배열 + 평가 순서 (규칙 번호 4bit x 16을 64bit 한 워드에)
+ * 순서 워드는 재배치 때 원자적으로 바꿔치기 -> 평가 쪽은 잠금 없이 배치당 1회 읽음
+ * 규칙 교체(filter_set_rules)는 RX 스레드 시작 전에만
+ * 프로세스 전역 (filter_ctx_t가 아님): light는 ctx 없이 패킷만 받는 wireless RX/replay 주입
+ * 경로(filter_light_batch, filter_pass_light)가 부르고, 규칙 집합과 SIMD 구현 선택도 프로세스에
+ * 하나뿐. 사이트마다 다른 담당영역/RSU 위치만 filter_ctx_t (heavy)
+ */
+static struct {
+  flt_rule_t rules[FILTER_RULES_MAX];
+  int n;
+  _Atomic uint64_t order;
+  _Atomic bool reorder_on;
+  // exits[k]: 현재 순서에서 k번째 규칙에서 탈락한 수 (exits[n] = 전부 통과)
+  // 패킷당 카운터 1개만 갱신 -> 규칙별 평가/탈락 수는 여기서 유도
+  _Alignas(64) _Atomic uint64_t exits[FILTER_RULES_MAX + 1];
+  _Atomic uint64_t since_reorder;
+  _Atomic uint64_t reorders;
+  bool loaded;
+} g_prog = { .reorder_on = true };
+
+// 통계는 light filter를 부르는 스레드(wireless RX) 하나만 갱신한다는 가정 -> RMW 없이 load+store
+// (여러 스레드가 동시에 부르면 일부 카운트가 유실될 수 있음, 판정 결과에는 영향 없음)
+static inline void stat_add(_Atomic uint64_t *c, uint64_t v) {
+  atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + v, memory_order_relaxed);
+}
+
+static inline int order_at(uint64_t order, int k) {
+  return (int)((order >> (4 * k)) & 0xf);
+}
+
+// ---- 파서 ----
+// 규칙은 ';' 또는 줄바꿈으로 구분, '#' 이후 주석
+//   <field> ==|!=|<|<=|>|>= <int>
+//   <field> [not] in <lo>..<hi>
+//   <field> [not] in {a, b, ...}
+static const char* skip_ws(const char *s) {
+  while (*s == ' ' || *s == '\t') s++;
+  return s;
+}
+
+static bool parse_num(const char **s, int64_t *out) {
+  char *end;
+  errno = 0;
+  long long v = strtoll(*s, &end, 0);
+  if (end == *s || errno) return false;
+  *out = (int64_t)v;
+  *s = end;
+  return true;
+}
+
+// 8바이트 필드는 int64로 비교
+static void field_bounds(const field_def_t *f, int64_t *min, int64_t *max) {
+  int bits = f->width * 8;
+  if (bits == 64) {
+    *min = INT64_MIN;
+    *max = INT64_MAX;
+  } else if (f->is_signed) {
+    *min = -(INT64_C(1) << (bits - 1));
+    *max = (INT64_C(1) << (bits - 1)) - 1;
+  } else {
+    *min = 0;
+    *max = (INT64_C(1) << bits) - 1;
+  }
+}
+
+static void rule_set_range(flt_rule_t *r, const field_def_t *f, int64_t lo, int64_t hi, bool neg) {
+  int64_t min, max;
+  field_bounds(f, &min, &max);
+  if (lo < min) lo = min;
+  if (hi > max) hi = max;
+  r->neg = neg;
+  if (lo > hi) {                       // 빈 범위: 항상 거짓
+    r->kind = RULE_CONST;
+    r->neg = !neg;
+    return;
+  }
+  if (lo == min && hi == max) {        // 필드 전체: 항상 참
+    r->kind = RULE_CONST;
+    return;
+  }
+  r->kind = RULE_RANGE;
+  r->lo = lo;
+  r->span = (uint64_t)hi - (uint64_t)lo;
+}
+
+static int compile_rule(flt_rule_t *r, const char *text) {
+  const char *s = skip_ws(text);
+  size_t nl = 0;
+  while (isalnum((unsigned char)s[nl]) || s[nl] == '_') nl++;
+  const field_def_t *f = NULL;
+  for (size_t i = 0; i < sizeof(g_fields) / sizeof(g_fields[0]); i++) {
+    if (strlen(g_fields[i].name) == nl && !strncmp(g_fields[i].name, s, nl)) f = &g_fields[i];
+  }
+  if (!f) return -1;
+  s = skip_ws(s + nl);
+
+  memset(r, 0, offsetof(flt_rule_t, evals));
+  r->off = f->off;
+  r->key_shift = f->key_shift;
+
+  bool neg = false;
+  if (!strncmp(s, "not", 3) && (s[3] == ' ' || s[3] == '\t')) {
+    neg = true;
+    s = skip_ws(s + 3);
+  } else if (s[0] == '!' && s[1] == 'i') {
+    neg = true;
+    s++;
+  }
+
+  if (!strncmp(s, "in", 2) && !isalnum((unsigned char)s[2])) {
+    s = skip_ws(s + 2);
+    if (*s == '{') {
+      s++;
+      r->kind = RULE_SET;
+      r->neg = neg;
+      for (;;) {
+        s = skip_ws(s);
+        if (*s == '}') break;
+        int64_t v;
+        if (r->n_set == FILTER_SET_MAX || !parse_num(&s, &v)) return -1;
+        if (f->width == 1) {
+          if (v < 0 || v > 255) return -1;
+          r->bm[v >> 6] |= 1ull << (v & 63);
+        }
+        r->set[r->n_set++] = v;
+        s = skip_ws(s);
+        if (*s == ',') s++;
+      }
+      s++;
+    } else {
+      int64_t lo, hi;
+      if (!parse_num(&s, &lo) || strncmp(s, "..", 2)) return -1;
+      s += 2;
+      if (!parse_num(&s, &hi)) return -1;
+      rule_set_range(r, f, lo, hi, neg);
+    }
+  } else {
+    if (neg) return -1;
+    int64_t v, min, max;
+    field_bounds(f, &min, &max);
+    size_t ol = (s[0] && s[1] == '=') ? 2 : 1;
+    char op[3] = { s[0], ol == 2 ? s[1] : '\0', '\0' };
+    s = skip_ws(s + ol);
+    if (!parse_num(&s, &v)) return -1;
+    if (!strcmp(op, "=="))      rule_set_range(r, f, v, v, false);
+    else if (!strcmp(op, "!=")) rule_set_range(r, f, v, v, true);
+    else if (!strcmp(op, "<"))  v == INT64_MIN ? rule_set_range(r, f, 1, 0, false) : rule_set_range(r, f, min, v - 1, false);
+    else if (!strcmp(op, "<=")) rule_set_range(r, f, min, v, false);
+    else if (!strcmp(op, ">"))  v == INT64_MAX ? rule_set_range(r, f, 1, 0, false) : rule_set_range(r, f, v + 1, max, false);
+    else if (!strcmp(op, ">=")) rule_set_range(r, f, v, max, false);
+    else return -1;
+  }
+  if (*skip_ws(s) != '\0') return -1;
+
+  // 전용 함수 선택
+  switch (r->kind) {
+  case RULE_CONST:
+    r->fn = fn_const;
+    r->cost = 0;
+    break;
+  case RULE_RANGE:
+    r->fn = f->width == 1 ? fn_range_u8 :
+            f->width == 2 ? fn_range_u16 :
+            f->width == 4 ? (f->is_signed ? fn_range_i32 : fn_range_u32) : fn_range_u64;
+    r->cost = f->key_shift >= 0 ? 1 : 4;
+    break;
+  default:
+    r->fn = f->width == 1 ? fn_set_u8 :
+            f->width == 2 ? fn_set_u16 :
+            f->width == 4 ? (f->is_signed ? fn_set_i32 : fn_set_u32) : fn_set_u64;
+    r->cost = f->width == 1 ? (f->key_shift >= 0 ? 2 : 4) : (uint8_t)(4 + r->n_set);
+    break;
+  }
+
+  // 보고용 원문 (공백 정리)
+  size_t len = strlen(text);
+  while (len && isspace((unsigned char)text[len - 1])) len--;
+  const char *t = skip_ws(text);
+  len -= (size_t)(t - text);
+  if (len >= sizeof(r->text)) len = sizeof(r->text) - 1;
+  memcpy(r->text, t, len);
+  r->text[len] = '\0';
+  return 0;
+}
+
+int filter_set_rules(const char *text) {
+  if (!text) text = FILTER_DEFAULT_RULES;
+
+  static flt_rule_t tmp[FILTER_RULES_MAX];
+  int n = 0, lineno = 0;
+  const char *p = text;
+  char line[256];
+  while (*p) {
+    // 줄 단위로 주석을 먼저 떼고, 남은 부분을 ';'로 나눔
+    size_t len = strcspn(p, "\n");
+    lineno++;
+    if (len >= sizeof(line)) {
+      LOGW("filter rules: line %d too long", lineno);
+      return -1;
+    }
+    memcpy(line, p, len);
+    line[len] = '\0';
+    p += len;
+    if (*p) p++;
+
+    char *hash = strchr(line, '#');
+    if (hash) *hash = '\0';
+    char *save;
+    for (char *rule = strtok_r(line, ";", &save); rule; rule = strtok_r(NULL, ";", &save)) {
+      if (strspn(rule, " \t\r") == strlen(rule)) continue;
+      if (n == FILTER_RULES_MAX) {
+        LOGW("filter rules: more than %d rules", FILTER_RULES_MAX);
+        return -1;
+      }
+      if (compile_rule(&tmp[n], rule) != 0) {
+        LOGW("filter rules: line %d: bad rule '%s'", lineno, rule);
+        return -1;
+      }
+      n++;
+    }
+  }
+
+  for (int i = 0; i < n; i++) {
+    memcpy(&g_prog.rules[i], &tmp[i], offsetof(flt_rule_t, evals));
+    atomic_store(&g_prog.rules[i].evals, 0);
+    atomic_store(&g_prog.rules[i].rejects, 0);
+  }
+  uint64_t order = 0;
+  for (int i = 0; i < n; i++) order |= (uint64_t)i << (4 * i);
+  for (int k = 0; k <= FILTER_RULES_MAX; k++) atomic_store(&g_prog.exits[k], 0);
+  g_prog.n = n;
+  g_prog.loaded = true;
+  atomic_store(&g_prog.order, order);
+  atomic_store(&g_prog.since_reorder, 0);
+  atomic_store(&g_prog.reorders, 0);
+  return 0;
+}
+
+int filter_load_rules(const char *path) {
+  FILE *fp = fopen(path, "r");
+  if (!fp) {
+    LOGW("filter: rules file %s: %s", path, strerror(errno));
+    return -1;
+  }
+  char text[FILTER_RULES_MAX * 128];
+  size_t len = fread(text, 1, sizeof(text) - 1, fp);
+  bool too_big = !feof(fp);
+  fclose(fp);
+  if (too_big) {
+    LOGW("filter: rules file %s too large", path);
+    return -1;
+  }
+  text[len] = '\0';
+  return filter_set_rules(text);
+}
+
+static inline void prog_ensure(void) {
+  if (!g_prog.loaded) (void)filter_set_rules(NULL);
+}
+
+// 현재 순서 기준 위치 카운터 -> 규칙별 (평가, 탈락)
+static void prog_derive(uint64_t order, uint64_t *evals, uint64_t *rejects) {
+  uint64_t reach = 0;
+  for (int k = g_prog.n; k >= 0; k--) {
+    uint64_t e = atomic_load_explicit(&g_prog.exits[k], memory_order_relaxed);
+    reach += e;
+    if (k == g_prog.n) continue;
+    int i = order_at(order, k);
+    const flt_rule_t *r = &g_prog.rules[i];
+    evals[i] = atomic_load_explicit(&r->evals, memory_order_relaxed) + reach;
+    rejects[i] = atomic_load_explicit(&r->rejects, memory_order_relaxed) + e;
+  }
+}
+
+// 탈락률 / 비용 내림차순, 같으면 싼 규칙 먼저 (아직 평가가 적은 규칙은 선언 순서 유지)
+static void prog_reorder(void) {
+  int n = g_prog.n;
+  double score[FILTER_RULES_MAX];
+  int idx[FILTER_RULES_MAX];
+  uint64_t evals[FILTER_RULES_MAX], rejects[FILTER_RULES_MAX];
+  uint64_t cur = atomic_load_explicit(&g_prog.order, memory_order_relaxed);
+  prog_derive(cur, evals, rejects);
+  // 위치 카운터를 규칙별 누적으로 옮김 (순서가 바뀌면 위치의 의미가 달라지므로)
+  for (int k = 0; k <= n; k++) atomic_store_explicit(&g_prog.exits[k], 0, memory_order_relaxed);
+  for (int k = 0; k < n; k++) {
+    int i = order_at(cur, k);
+    flt_rule_t *r = &g_prog.rules[i];
+    atomic_store_explicit(&r->evals, evals[i], memory_order_relaxed);
+    atomic_store_explicit(&r->rejects, rejects[i], memory_order_relaxed);
+  }
+  for (int k = 0; k < n; k++) {
+    int i = order_at(cur, k);
+    const flt_rule_t *r = &g_prog.rules[i];
+    uint64_t ev = evals[i], rj = rejects[i];
+    idx[k] = i;
+    score[i] = ev < 64 ? -1.0 : (double)rj / (double)ev / (double)(r->cost + 1);
+    if (r->kind == RULE_CONST) score[i] = r->neg ? 1e9 : -2.0;  // 항상 거짓은 맨 앞, 항상 참은 맨 뒤
+  }
+  for (int a = 1; a < n; a++) {        // 안정 삽입 정렬 (최대 16개)
+    int v = idx[a], b = a;
+    while (b > 0 && (score[idx[b - 1]] < score[v] ||
+                     (score[idx[b - 1]] == score[v] && g_prog.rules[idx[b - 1]].cost > g_prog.rules[v].cost))) {
+      idx[b] = idx[b - 1];
+      b--;
+    }
+    idx[b] = v;
+  }
+  uint64_t order = 0;
+  for (int k = 0; k < n; k++) order |= (uint64_t)idx[k] << (4 * k);
+  if (order != cur) {
+    atomic_store_explicit(&g_prog.order, order, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_prog.reorders, 1, memory_order_relaxed);
+  }
+}
+
+static inline void prog_account(uint64_t pkts) {
+  if (!atomic_load_explicit(&g_prog.reorder_on, memory_order_relaxed)) return;
+  stat_add(&g_prog.since_reorder, pkts);
+  if (atomic_load_explicit(&g_prog.since_reorder, memory_order_relaxed) >= FILTER_REORDER_EVERY) {
+    atomic_store_explicit(&g_prog.since_reorder, 0, memory_order_relaxed);
+    prog_reorder();
+  }
+}
+
+void filter_set_rule_reorder(bool on) {
+  atomic_store_explicit(&g_prog.reorder_on, on, memory_order_relaxed);
+}
+
+int filter_get_rule_stats(filter_rule_stats_t *out, int max) {
+  prog_ensure();
+  uint64_t order = atomic_load_explicit(&g_prog.order, memory_order_relaxed);
+  uint64_t evals[FILTER_RULES_MAX], rejects[FILTER_RULES_MAX];
+  prog_derive(order, evals, rejects);
+  int n = g_prog.n < max ? g_prog.n : max;
+  for (int k = 0; k < n; k++) {
+    int i = order_at(order, k);
+    memcpy(out[k].text, g_prog.rules[i].text, sizeof(out[k].text));
+    out[k].evals = evals[i];
+    out[k].rejects = rejects[i];
+  }
+  return n;
+}
+
+uint64_t filter_rule_reorders(void) {
+  return atomic_load_explicit(&g_prog.reorders, memory_order_relaxed);
+}
+
+void filter_reset_rule_stats(void) {
+  for (int i = 0; i < g_prog.n; i++) {
+    atomic_store(&g_prog.rules[i].evals, 0);
+    atomic_store(&g_prog.rules[i].rejects, 0);
+  }
+  for (int k = 0; k <= FILTER_RULES_MAX; k++) atomic_store(&g_prog.exits[k], 0);
+  atomic_store(&g_prog.since_reorder, 0);
+}
+
+// ---- 단건 ----
+static inline uint64_t key_range1(uint32_t k, int shift, int lo, int span) {
+  return (uint64_t)((uint32_t)(((k >> shift) & 0xffu) - (uint32_t)lo) <= (uint32_t)span);
+}
+
+bool filter_pass_light(const void *raw_pkt) {
+  const wl1_packet_t *pkt = (const wl1_packet_t*)raw_pkt;
+  if (!pkt) return false;
+  prog_ensure();
+
+  const uint8_t *p = (const uint8_t*)&pkt->payload;
+  uint32_t key = light_key(pkt);
+  uint64_t order = atomic_load_explicit(&g_prog.order, memory_order_relaxed);
+  int k = 0;
+  for (; k < g_prog.n; k++) {
+    const flt_rule_t *r = &g_prog.rules[order_at(order, k)];
+    bool ok = (r->kind == RULE_RANGE && r->key_shift >= 0)
+                  ? (bool)key_range1(key, r->key_shift, (int)r->lo, (int)r->span) != r->neg
+                  : r->fn(r, p);
+    if (!ok) break;
+  }
+  stat_add(&g_prog.exits[k], 1);
+  prog_account(1);
+  return k == g_prog.n;
+}
+
+// ---- 배치 커널 ----
+// keys: 패킷별 키 모으기, range: 키의 한 바이트에 대한 lo <= b <= lo+span 통과 마스크
+typedef void (*keys_fn_t)(const wl1_packet_t *const *pkts, int n, uint32_t *keys);
+typedef uint64_t (*range_fn_t)(const uint32_t *keys, int n, int shift, int lo, int span);
+
+typedef struct {
+  keys_fn_t keys;
+  range_fn_t range;
+} batch_ops_t;
+
+static void keys_scalar(const wl1_packet_t *const *pkts, int n, uint32_t *keys) {
+  for (int i = 0; i < n; i++) keys[i] = light_key(pkts[i]);
+}
+
+static uint64_t range_scalar(const uint32_t *keys, int n, int shift, int lo, int span) {
+  uint64_t mask = 0;
+  for (int i = 0; i < n; i++) mask |= key_range1(keys[i], shift, lo, span) << i;
+  return mask;
+}
+
+#if defined(FILTER_X86)
+__attribute__((target("sse2")))
+static uint64_t range_sse2(const uint32_t *keys, int n, int shift, int lo, int span) {
+  const __m128i sh = _mm_cvtsi32_si128(shift);
+  const __m128i ff = _mm_set1_epi32(0xff);
+  const __m128i vlo = _mm_set1_epi32(lo);
+  const __m128i vspan = _mm_set1_epi32(span);
+  const __m128i zero = _mm_setzero_si128();
+
+  uint64_t mask = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128i k = _mm_loadu_si128((const __m128i*)(const void*)(keys + i));
+    __m128i x = _mm_sub_epi32(_mm_and_si128(_mm_srl_epi32(k, sh), ff), vlo);   // [-255, 255]
+    __m128i fail = _mm_or_si128(_mm_cmpgt_epi32(x, vspan), _mm_cmpgt_epi32(zero, x));
+    mask |= (uint64_t)(~_mm_movemask_ps(_mm_castsi128_ps(fail)) & 0xf) << i;
+  }
+  for (; i < n; i++) mask |= key_range1(keys[i], shift, lo, span) << i;
+  return mask;
+}
+
+#if defined(__x86_64__)
+// 패킷 포인터 4개를 base 기준 오프셋으로 바꿔 header/accident 워드를 gather
+__attribute__((target("avx2")))
+static inline __m128i gather_keys4(const wl1_packet_t *const *pkts, const char *base) {
+  __m256i ptr = _mm256_loadu_si256((const __m256i*)(const void*)pkts);
+  __m256i off = _mm256_sub_epi64(ptr, _mm256_set1_epi64x((long long)(intptr_t)base));
+  __m128i h = _mm256_i64gather_epi32((const int*)(const void*)base, off, 1);
+  __m128i a = _mm256_i64gather_epi32((const int*)(const void*)(base + ACC_OFF), off, 1);
+  return _mm_or_si128(_mm_and_si128(h, _mm_set1_epi32(0x00ffffff)),
+                      _mm_and_si128(a, _mm_set1_epi32((int)0xff000000u)));
+}
+
+__attribute__((target("avx2")))
+static void keys_avx2(const wl1_packet_t *const *pkts, int n, uint32_t *keys) {
+  int i = 0;
+  if (n >= 4) {
+    const char *base = (const char*)pkts[0];
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_si128((__m128i*)(void*)(keys + i), gather_keys4(pkts + i, base));
+    }
+  }
+  for (; i < n; i++) keys[i] = light_key(pkts[i]);
+}
+
+__attribute__((target("avx2")))
+static uint64_t range_avx2(const uint32_t *keys, int n, int shift, int lo, int span) {
+  const __m128i sh = _mm_cvtsi32_si128(shift);
+  const __m256i ff = _mm256_set1_epi32(0xff);
+  const __m256i vlo = _mm256_set1_epi32(lo);
+  const __m256i vspan = _mm256_set1_epi32(span);
+  const __m256i zero = _mm256_setzero_si256();
+
+  uint64_t mask = 0;
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i k = _mm256_loadu_si256((const __m256i*)(const void*)(keys + i));
+    __m256i x = _mm256_sub_epi32(_mm256_and_si256(_mm256_srl_epi32(k, sh), ff), vlo);
+    __m256i fail = _mm256_or_si256(_mm256_cmpgt_epi32(x, vspan), _mm256_cmpgt_epi32(zero, x));
+    mask |= (uint64_t)(~(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(fail)) & 0xffu) << i;
+  }
+  for (; i < n; i++) mask |= key_range1(keys[i], shift, lo, span) << i;
+  return mask;
+}
+#endif
+#endif
+
+#if defined(FILTER_NEON)
+static uint64_t range_neon(const uint32_t *keys, int n, int shift, int lo, int span) {
+  const int32x4_t sh = vdupq_n_s32(-shift);
+  const uint32x4_t ff = vdupq_n_u32(0xff);
+  const uint32x4_t vlo = vdupq_n_u32((uint32_t)lo);
+  const uint32x4_t vspan = vdupq_n_u32((uint32_t)span);
+  const uint32x4_t bits = { 1, 2, 4, 8 };
+
+  uint64_t mask = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    uint32x4_t k = vld1q_u32(keys + i);
+    uint32x4_t x = vsubq_u32(vandq_u32(vshlq_u32(k, sh), ff), vlo);  // 음수는 큰 부호없는 값
+    uint32x4_t pass = vcleq_u32(x, vspan);
+    mask |= (uint64_t)vaddvq_u32(vandq_u32(pass, bits)) << i;
+  }
+  for (; i < n; i++) mask |= key_range1(keys[i], shift, lo, span) << i;
+  return mask;
+}
+#endif
+
+static const char *const g_impl_names[] = { "auto", "scalar", "sse2", "avx2", "neon" };
+static const batch_ops_t g_ops_scalar = { keys_scalar, range_scalar };
+static _Atomic(const batch_ops_t*) g_batch_ops = NULL;
+static _Atomic int g_batch_impl = FILTER_IMPL_AUTO;
+
+static const batch_ops_t* impl_ops(filter_impl_t impl) {
+#if defined(FILTER_X86)
+  static const batch_ops_t ops_sse2 = { keys_scalar, range_sse2 };
+#if defined(__x86_64__)
+  static const batch_ops_t ops_avx2 = { keys_avx2, range_avx2 };
+#endif
+#endif
+#if defined(FILTER_NEON)
+  static const batch_ops_t ops_neon = { keys_scalar, range_neon };
+#endif
+  switch (impl) {
+  case FILTER_IMPL_SCALAR: return &g_ops_scalar;
+#if defined(FILTER_X86)
+  case FILTER_IMPL_SSE2:
+    return __builtin_cpu_supports("sse2") ? &ops_sse2 : NULL;
+#if defined(__x86_64__)
+  case FILTER_IMPL_AVX2:
+    return __builtin_cpu_supports("avx2") ? &ops_avx2 : NULL;
+#endif
+#endif
+#if defined(FILTER_NEON)
+  case FILTER_IMPL_NEON: return &ops_neon;
+#endif
+  default: return NULL;
+  }
+}
+
+int filter_set_batch_impl(filter_impl_t impl) {
+  if (impl == FILTER_IMPL_AUTO) {
+    // 지원되는 것 중 가장 넓은 것
+    static const filter_impl_t order[] = { FILTER_IMPL_AVX2, FILTER_IMPL_NEON, FILTER_IMPL_SSE2 };
+    impl = FILTER_IMPL_SCALAR;
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+      if (impl_ops(order[i])) {
+        impl = order[i];
+        break;
+      }
+    }
+  }
+  const batch_ops_t *ops = impl_ops(impl);
+  if (!ops) return -1;
+  atomic_store_explicit(&g_batch_impl, (int)impl, memory_order_relaxed);
+  atomic_store_explicit(&g_batch_ops, ops, memory_order_release);
+  return 0;
+}
+
+const char* filter_batch_impl_name(void) {
+  if (!atomic_load_explicit(&g_batch_ops, memory_order_acquire)) (void)filter_set_batch_impl(FILTER_IMPL_AUTO);
+  return g_impl_names[atomic_load_explicit(&g_batch_impl, memory_order_relaxed)];
+}
+
+// 규칙 하나를 배치 전체에 적용 -> 통과 마스크 (live 밖의 비트는 무시)
+static uint64_t rule_batch(const batch_ops_t *ops, const flt_rule_t *r,
+                           const wl1_packet_t *const *pkts, const uint32_t *keys, int n, uint64_t live) {
+  if (r->kind == RULE_CONST) return r->neg ? 0 : live;
+  if (r->key_shift >= 0) {
+    if (r->kind == RULE_RANGE) {
+      uint64_t m = ops->range(keys, n, r->key_shift, (int)r->lo, (int)r->span);
+      return r->neg ? ~m : m;
+    }
+    uint64_t m = 0;   // 1바이트 집합: 키에서 비트맵 조회
+    for (uint64_t b = live; b; b &= b - 1) {
+      int i = __builtin_ctzll(b);
+      uint32_t v = (keys[i] >> r->key_shift) & 0xffu;
+      m |= ((r->bm[v >> 6] >> (v & 63)) & 1u) << i;
+    }
+    return r->neg ? ~m : m;
+  }
+  uint64_t m = 0;     // 키에 없는 필드: 살아 있는 패킷만 전용 함수로
+  for (uint64_t b = live; b; b &= b - 1) {
+    int i = __builtin_ctzll(b);
+    m |= (uint64_t)r->fn(r, (const uint8_t*)&pkts[i]->payload) << i;
+  }
+  return m;
+}
+
+uint64_t filter_light_batch(const wl1_packet_t *const *pkts, int n) {
+  if (n <= 0) return 0;
+  if (n > 64) n = 64;
+  const batch_ops_t *ops = atomic_load_explicit(&g_batch_ops, memory_order_acquire);
+  if (!ops) {
+    (void)filter_set_batch_impl(FILTER_IMPL_AUTO);
+    ops = atomic_load_explicit(&g_batch_ops, memory_order_acquire);
+  }
+  prog_ensure();
+
+  uint32_t keys[64];
+  ops->keys(pkts, n, keys);
+
+  uint64_t live = n == 64 ? ~0ull : (1ull << n) - 1;
+  uint64_t order = atomic_load_explicit(&g_prog.order, memory_order_relaxed);
+  int k = 0;
+  for (; k < g_prog.n && live; k++) {
+    const flt_rule_t *r = &g_prog.rules[order_at(order, k)];
+    uint64_t pass = rule_batch(ops, r, pkts, keys, n, live);
+    uint64_t rej = live & ~pass;
+    if (rej) stat_add(&g_prog.exits[k], (uint64_t)__builtin_popcountll(rej));
+    live &= pass;
+  }
+  if (live) stat_add(&g_prog.exits[g_prog.n], (uint64_t)__builtin_popcountll(live));
+  prog_account((uint64_t)n);
+  return live;
+}
@@ -1,17 +1,40 @@
 #include "pipeline.h"
 #include "log.h"
+#include "pools.h"
+#include "replay.h"
+#include "trace.h"
 #include <signal.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <arpa/inet.h> 
 
 static volatile int g_stop = 0;
+static volatile sig_atomic_t g_trace_toggle = 0;
 static void on_sig(int s){ (void)s; g_stop = 1; }
+static void on_usr1(int s){ (void)s; g_trace_toggle = 1; }
+
+// SIGUSR1: 단계별 지연 추적 켜기/끄기 (끌 때 그동안의 구간 통계 출력)
+static void toggle_trace(void) {
+  bool on = !trace_enabled();
+  if (on) {
+    trace_reset();
+  } else {
+    trace_set_enabled(false);
+    trace_log_stats();
+  }
+  trace_set_enabled(on);
+  LOGI("trace %s", on ? "enabled" : "disabled");
+}
 
 // 가짜 패킷을 만들어 큐에 넣는 헬퍼 함수
 void send_fake_packet(pipeline_t *p, uint32_t rsu_id, uint64_t acc_id) {
     tx_cmd_wired_t *cmd = (tx_cmd_wired_t*)calloc(1, sizeof(tx_cmd_wired_t));
-    cmd->rsu2p = (rsu2_payload_t*)calloc(1, sizeof(rsu2_payload_t));
+    if (!cmd) return;
+    cmd->rsu2p = (rsu2_payload_t*)mempool_alloc(&g_pools.rsu2p);
+    if (!cmd->rsu2p) {
+        free(cmd);
+        return;
+    }
   
     // RSU ID & 좌표 (Big Endian)
     cmd->rsu2p->rsu_id = htonl(rsu_id);
@@ -39,18 +62,27 @@ void send_fake_packet(pipeline_t *p, uint32_t rsu_id, uint64_t acc_id) {
     // 하지만 main.c에서는 SM 내부 큐(p->Q_sm_events)에 접근 가능하므로
     // 직접 이벤트를 만들어 넣겠습니다.
     
-    sm_event_t *ev = (sm_event_t*)calloc(1, sizeof(sm_event_t));
+    sm_event_t *ev = (sm_event_t*)mempool_alloc(&g_pools.sm_ev);
+    if (!ev) {
+        mempool_free(&g_pools.rsu2p, cmd->rsu2p);
+        free(cmd);
+        return;
+    }
     ev->type = EV_WL1_RX;
     ev->u.rsu2p = cmd->rsu2p; // Payload만 전달 (cmd 껍데기는 필요 없음)
     
     free(cmd); // cmd 껍데기는 해제, payload는 이벤트가 가짐
     
-    bq_push(&p->Q_sm_events, ev);
+    if (!bq_push(&p->Q_sm_events, ev)) {
+        mempool_free(&g_pools.rsu2p, ev->u.rsu2p);
+        mempool_free(&g_pools.sm_ev, ev);
+    }
 }
 
 int main(void) {
   signal(SIGINT, on_sig);
   signal(SIGTERM, on_sig);
+  signal(SIGUSR1, on_usr1);
 
   pipeline_t p;
   if (pipeline_start(&p) != 0) {
@@ -58,6 +90,13 @@ int main(void) {
     return 1;
   }
 
+  // RSU_REPLAY: 캡처 파일을 재생하고 요약을 남긴 뒤 종료 (테스트 패킷 없음)
+  if (p.cfg.replay_path) {
+    int rc = replay_run(&p, p.cfg.replay_path, p.cfg.replay_speed, &g_stop);
+    pipeline_stop(&p);
+    return rc == 0 ? 0 : 1;
+  }
+
   // ============================================================
   // [중복 전송 테스트]
   // ============================================================
@@ -75,7 +114,13 @@ int main(void) {
 
   // ============================================================
 
-  while (!g_stop) sleep(1);
+  while (!g_stop) {
+    sleep(1);
+    if (g_trace_toggle) {
+      g_trace_toggle = 0;
+      toggle_trace();
+    }
+  }
 
   pipeline_stop(&p);
   return 0;
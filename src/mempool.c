@@ -0,0 +1,106 @@
+// common/mempool.c
+#include "mempool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MP_ALIGN 16u
+
+static inline uint64_t mp_pack(uint32_t tag, uint32_t idx1) {
+  return ((uint64_t)tag << 32) | idx1;
+}
+
+int mempool_init(mempool_t *mp, const char *name, size_t obj_size, uint32_t count) {
+  memset(mp, 0, sizeof(*mp));
+  if (obj_size == 0 || count == 0) return -1;
+
+  mp->name = name;
+  mp->obj_size = (obj_size + MP_ALIGN - 1) & ~(size_t)(MP_ALIGN - 1);
+  mp->count = count;
+
+  mp->base = (uint8_t*)aligned_alloc(MP_ALIGN, mp->obj_size * count);
+  mp->next = (_Atomic uint32_t*)calloc(count, sizeof(*mp->next));
+  if (!mp->base || !mp->next) {
+    free(mp->base);
+    free((void*)mp->next);
+    memset(mp, 0, sizeof(*mp));
+    return -1;
+  }
+
+  // 0 -> 1 -> ... -> count-1 순서로 free-list 구성
+  for (uint32_t i = 0; i < count; i++) {
+    atomic_init(&mp->next[i], (i + 1 < count) ? i + 2 : 0);
+  }
+  atomic_init(&mp->head, mp_pack(0, 1));
+  atomic_init(&mp->in_use, 0);
+  atomic_init(&mp->high_water, 0);
+  atomic_init(&mp->exhausted, 0);
+  return 0;
+}
+
+void mempool_destroy(mempool_t *mp) {
+  if (!mp) return;
+  free(mp->base);
+  free((void*)mp->next);
+  memset(mp, 0, sizeof(*mp));
+}
+
+void* mempool_try_alloc(mempool_t *mp) {
+  // 초기화 전(벤치/테스트 코드 등)에는 그냥 heap 사용
+  if (!mp->base) return calloc(1, mp->obj_size ? mp->obj_size : 1);
+
+  uint64_t old = atomic_load_explicit(&mp->head, memory_order_acquire);
+  for (;;) {
+    uint32_t idx1 = (uint32_t)old;
+    if (idx1 == 0) return NULL;
+    uint32_t nxt = atomic_load_explicit(&mp->next[idx1 - 1], memory_order_relaxed);
+    uint64_t want = mp_pack((uint32_t)(old >> 32) + 1, nxt);
+    if (atomic_compare_exchange_weak_explicit(&mp->head, &old, want,
+                                              memory_order_acquire, memory_order_acquire)) {
+      uint32_t used = atomic_fetch_add_explicit(&mp->in_use, 1, memory_order_relaxed) + 1;
+      uint32_t hw = atomic_load_explicit(&mp->high_water, memory_order_relaxed);
+      while (used > hw &&
+             !atomic_compare_exchange_weak_explicit(&mp->high_water, &hw, used,
+                                                    memory_order_relaxed, memory_order_relaxed)) {
+      }
+      void *obj = mp->base + (size_t)(idx1 - 1) * mp->obj_size;
+      memset(obj, 0, mp->obj_size);
+      return obj;
+    }
+  }
+}
+
+void* mempool_alloc(mempool_t *mp) {
+  void *obj = mempool_try_alloc(mp);
+  if (obj) return obj;
+  atomic_fetch_add_explicit(&mp->exhausted, 1, memory_order_relaxed);
+  return calloc(1, mp->obj_size);
+}
+
+void mempool_free(mempool_t *mp, void *obj) {
+  if (!obj) return;
+
+  uint8_t *p = (uint8_t*)obj;
+  if (!mp->base || p < mp->base || p >= mp->base + mp->obj_size * mp->count) {
+    free(obj); // fallback으로 할당된 객체
+    return;
+  }
+
+  uint32_t idx1 = (uint32_t)((size_t)(p - mp->base) / mp->obj_size) + 1;
+  uint64_t old = atomic_load_explicit(&mp->head, memory_order_relaxed);
+  for (;;) {
+    atomic_store_explicit(&mp->next[idx1 - 1], (uint32_t)old, memory_order_relaxed);
+    uint64_t want = mp_pack((uint32_t)(old >> 32) + 1, idx1);
+    if (atomic_compare_exchange_weak_explicit(&mp->head, &old, want,
+                                              memory_order_release, memory_order_relaxed)) {
+      break;
+    }
+  }
+  atomic_fetch_sub_explicit(&mp->in_use, 1, memory_order_relaxed);
+}
+
+void mempool_get_stats(mempool_t *mp, mempool_stats_t *st) {
+  st->capacity = mp->count;
+  st->in_use = atomic_load_explicit(&mp->in_use, memory_order_relaxed);
+  st->high_water = atomic_load_explicit(&mp->high_water, memory_order_relaxed);
+  st->exhausted = atomic_load_explicit(&mp->exhausted, memory_order_relaxed);
+}
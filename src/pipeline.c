@@ -1,88 +1,339 @@
 #include "pipeline.h"
 
+#include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "log.h"
 #include "types.h"
 
-#include "filter.h"
-#include "security.h"
-#include "packet.h"
 #include "debug.h"
+#include "pools.h"
+#include "bcast_frame.h"
+#include "security.h"
+#include "trace.h"
+#include "stats_shm.h"
+#include "timeutil.h"
 
-// WL-1 Worker: [Raw Q] -> [Filter] -> [Strip] -> [Packet Conv] -> [SM Event Q]
-static void* wl1_worker_thread(void *arg) {
-    pipeline_t *p = (pipeline_t*)arg;
-
-    while (p->running) {
-        wl1_packet_t *pkt = (wl1_packet_t*)bq_pop(&p->Q_wl1_raw);
-        if (!pkt) break;
-
-        uint32_t dist = 0;
-        DBG_INFO("[STEP 2] Worker Pop. Addr: %p", pkt);
-        // 1. Filter (Raw Packet 검사)
-        if (!filter_pass_all(pkt, p->cfg.rsu_id, &dist)) {
-            free(pkt);
-            continue;
-        }
+#ifndef PIPE_BATCH_MAX
+#define PIPE_BATCH_MAX 32   // 스테이지가 한 번에 pop/push 하는 최대 개수
+#endif
 
-        // 2. Wireless RX Strip (Packet -> Payload)
-        wl1_payload_t stripped;
-        if (!sec_wireless_rx_strip(pkt, &stripped)) {
-            free(pkt);
-            continue;
-        }
+// SM 이벤트 배치를 한 번에 push, 못 들어간 건 payload째 반환
+static void push_sm_events(pipeline_t *p, void **evs, int n) {
+    if (n == 0) return;
+    int pushed = bq_push_many(&p->Q_sm_events, evs, n);
+    for (int i = pushed; i < n; i++) {
+        sm_event_t *ev = (sm_event_t*)evs[i];
+        if (ev->type == EV_WL1_RX) mempool_free(&g_pools.rsu2p, ev->u.rsu2p);
+        else if (ev->type == EV_RSU3_RX) mempool_free(&g_pools.rsu3p, ev->u.rsu3p);
+        mempool_free(&g_pools.sm_ev, ev);
+    }
+}
 
-        // 3. Packet Convert (WL-1' -> RSU-2')
-        rsu2_payload_t *rsu2p = calloc(1, sizeof(rsu2_payload_t));
-        if (!packet_wl1_to_rsu2(&stripped, p->cfg.rsu_id, dist, rsu2p)) {
-            free(rsu2p);
-            free(pkt);
+// RSU-3 Dispatch: [RSU-3 Q] -> [SM Event Q]
+static void rsu3_dispatch_batch(pipeline_t *p, void **rs, int n) {
+    void *evs[PIPE_BATCH_MAX];
+    int ne = 0;
+    for (int i = 0; i < n; i++) {
+        sm_event_t *ev = mempool_alloc(&g_pools.sm_ev);
+        if (!ev) {
+            mempool_free(&g_pools.rsu3p, rs[i]);
             continue;
         }
+        ev->type = EV_RSU3_RX;
+        ev->u.rsu3p = (rsu3_payload_t*)rs[i];
+        evs[ne++] = ev;
+    }
+    push_sm_events(p, evs, ne);
+}
 
-        // 4. Send to StateManager
-        sm_event_t *ev = calloc(1, sizeof(sm_event_t));
-        ev->type = EV_WL1_RX;
-        ev->u.rsu2p = rsu2p;
-        DBG_INFO("[STEP 3] Push to SM Queue");
-        bq_push(&p->Q_sm_events, ev);
+static void* rsu3_dispatch_thread(void *arg) {
+    pipeline_t *p = (pipeline_t*)arg;
+    void *rs[PIPE_BATCH_MAX];
 
-        free(pkt);
+    while (p->running) {
+        int n = bq_pop_many(&p->Q_rsu3_in, rs, PIPE_BATCH_MAX);
+        if (n == 0) break;
+        rsu3_dispatch_batch(p, rs, n);
     }
     return NULL;
 }
 
-// RSU-3 Dispatch: [RSU-3 Q] -> [SM Event Q]
-static void* rsu3_dispatch_thread(void *arg) {
+// ---------------------------------------------------------------------------
+// Event loop 모드 (RUNTIME_EVLOOP)
+// - 스레드 1개가 epoll로 wireless RX 소켓, wired(송신 상태 머신 + 명령 서버) epoll fd,
+//   스케줄러 timerfd, stop eventfd를 기다림
+// - 깨어나면 해당 소스를 처리한 뒤 내부 큐가 빌 때까지 스테이지를 순서대로 끝까지 실행
+//   (RX -> WL-1 처리 -> RSU-3 dispatch -> SM -> 무선 TX). 큐는 스테이지 사이 버퍼일 뿐
+//   스레드 간 깨우기가 없음. SM -> wired는 Q_tx_cmd eventfd로 wired fd가 깨어남
+//   루프 밖 스레드가 Q_sm_events에 넣으면 (main의 테스트 이벤트 등) stop eventfd로 깨어남
+// - 모든 소켓은 대기 없이 처리 (MSG_DONTWAIT / non-blocking), 한 소스가 루프를 잡지 않도록
+//   RX는 readiness 1회당 recvmmsg 1회 (level-triggered라 남은 건 다음 바퀴)
+// ---------------------------------------------------------------------------
+enum { LOOP_TAG_STOP = 0, LOOP_TAG_TIMER, LOOP_TAG_RX, LOOP_TAG_WIRED };
+
+static int rsu3_dispatch_poll(pipeline_t *p) {
+    void *rs[PIPE_BATCH_MAX];
+    int total = 0, n;
+    while ((n = bq_try_pop_many(&p->Q_rsu3_in, rs, PIPE_BATCH_MAX)) > 0) {
+        rsu3_dispatch_batch(p, rs, n);
+        total += n;
+    }
+    return total;
+}
+
+// 내부 큐가 모두 빌 때까지 (반환: 옮긴 항목 수)
+static int loop_run_stages(pipeline_t *p) {
+    int total = 0, moved;
+    do {
+        moved = 0;
+        for (int i = 0; i < p->n_wl1_workers; i++) moved += wl1_worker_poll(&p->wl1_workers[i]);
+        moved += rsu3_dispatch_poll(p);
+        moved += state_manager_poll(&p->sm);
+        moved += wireless_tx_poll(&p->wireless);
+        total += moved;
+    } while (moved);
+    return total;
+}
+
+// 스케줄러 마감 실행 -> 그 콜백이 넣은 이벤트 처리 -> (SM이 새 타이머를 걸 수 있으므로) 반복
+static void loop_run_timers(pipeline_t *p) {
+    uint64_t next;
+    do {
+        next = scheduler_run_due(&p->sched);
+    } while (loop_run_stages(p) > 0);
+
+    if (next == p->loop_armed_ms) return;
+    p->loop_armed_ms = next;
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (next != UINT64_MAX) {
+        its.it_value.tv_sec = (time_t)(next / 1000ull);
+        its.it_value.tv_nsec = (long)(next % 1000ull) * 1000000l;
+        if (next == 0) its.it_value.tv_nsec = 1;
+    }
+    timerfd_settime(p->loop_tm_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static void* evloop_thread(void *arg) {
     pipeline_t *p = (pipeline_t*)arg;
-    while (p->running) {
-        rsu3_payload_t *r = (rsu3_payload_t*)bq_pop(&p->Q_rsu3_in);
-        if (!r) break;
+    struct epoll_event evs[8];
+    uint64_t v;
 
-        sm_event_t *ev = calloc(1, sizeof(sm_event_t));
-        ev->type = EV_RSU3_RX;
-        ev->u.rsu3p = r;
-        bq_push(&p->Q_sm_events, ev);
+    while (p->running) {
+        loop_run_timers(p);
+        int n = epoll_wait(p->loop_ep_fd, evs, 8, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            LOGE("evloop: epoll_wait failed: %d", errno);
+            break;
+        }
+        p->loop_stats.wakeups++;
+        for (int i = 0; i < n; i++) {
+            switch (evs[i].data.u32) {
+            case LOOP_TAG_RX:
+                p->loop_stats.rx++;
+                wireless_rx_poll(&p->wireless);
+                break;
+            case LOOP_TAG_WIRED:
+                p->loop_stats.wired++;
+                wired_client_poll(&p->wc);
+                break;
+            case LOOP_TAG_TIMER:
+                p->loop_stats.timer++;
+                if (read(p->loop_tm_fd, &v, sizeof(v)) < 0) { /* 재설정으로 취소됨 */ }
+                p->loop_armed_ms = 0;
+                break;
+            default:
+                if (read(p->loop_ev_fd, &v, sizeof(v)) < 0) { /* running을 다시 봄 */ }
+                break;
+            }
+        }
+        p->loop_stats.moved += (uint64_t)loop_run_stages(p);
     }
     return NULL;
 }
 
+static int loop_add(pipeline_t *p, int fd, uint32_t tag) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.u32 = tag };
+    return epoll_ctl(p->loop_ep_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static int evloop_start(pipeline_t *p) {
+    p->loop_ep_fd = epoll_create1(EPOLL_CLOEXEC);
+    p->loop_ev_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    p->loop_tm_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (p->loop_ep_fd < 0 || p->loop_ev_fd < 0 || p->loop_tm_fd < 0) return -1;
+    p->loop_armed_ms = UINT64_MAX;
+
+    if (loop_add(p, p->loop_ev_fd, LOOP_TAG_STOP) != 0 ||
+        loop_add(p, p->loop_tm_fd, LOOP_TAG_TIMER) != 0 ||
+        loop_add(p, p->wireless.sock_rx, LOOP_TAG_RX) != 0) return -1;
+    if (p->wc_ready && loop_add(p, wired_client_fd(&p->wc), LOOP_TAG_WIRED) != 0) return -1;
+    // 비어 있다가 들어오면 통지 -> 다음 타이머/수신까지 기다리지 않음
+    if (bq_set_notify_fd(&p->Q_sm_events, p->loop_ev_fd) != 0) return -1;
+
+    if (pthread_create(&p->th_loop, NULL, evloop_thread, p) != 0) return -1;
+    p->loop_started = true;
+    return 0;
+}
+
+static void evloop_stop(pipeline_t *p) {
+    if (p->loop_started) {
+        uint64_t one = 1;
+        if (write(p->loop_ev_fd, &one, sizeof(one)) < 0) { /* 루프가 running을 다시 봄 */ }
+        pthread_join(p->th_loop, NULL);
+        p->loop_started = false;
+        LOGI("evloop: %llu wakeups (rx %llu, wired %llu, timer %llu), %llu items moved",
+             (unsigned long long)p->loop_stats.wakeups, (unsigned long long)p->loop_stats.rx,
+             (unsigned long long)p->loop_stats.wired, (unsigned long long)p->loop_stats.timer,
+             (unsigned long long)p->loop_stats.moved);
+    }
+    bq_set_notify_fd(&p->Q_sm_events, -1);   // 아래에서 닫는 fd를 bq_stop이 쓰지 않게
+    if (p->loop_ep_fd > 0) close(p->loop_ep_fd);
+    if (p->loop_ev_fd > 0) close(p->loop_ev_fd);
+    if (p->loop_tm_fd > 0) close(p->loop_tm_fd);
+    p->loop_ep_fd = p->loop_ev_fd = p->loop_tm_fd = -1;
+}
+
+static void stats_put_queue(stats_queue_t *dst, const bq_stats_t *st) {
+  stats_set(&dst->cap, st->cap);
+  stats_set(&dst->depth, st->depth);
+  stats_set(&dst->high_water, st->high_water);
+  stats_set(&dst->drops, st->drops);
+  stats_set(&dst->push_items, st->push_items);
+  stats_set(&dst->pop_items, st->pop_items);
+}
+
+_Static_assert(STATS_RULES_MAX == FILTER_RULES_MAX && STATS_RULE_TEXT == FILTER_RULE_TEXT,
+               "stats_rule_t must hold every filter rule");
+
+// [스케줄러 콜백] 큐/스케줄러/light 규칙 상태를 공유 메모리로 복사 (다른 카운터는 각 스레드가 직접 갱신)
+static void stats_publish(void *arg) {
+  pipeline_t *p = (pipeline_t*)arg;
+  bq_stats_t sum, st;
+  memset(&sum, 0, sizeof(sum));
+  for (int i = 0; i < p->n_wl1_workers; i++) {
+    bq_get_stats(&p->Q_wl1_raw[i], &st);
+    sum.cap += st.cap;
+    sum.depth += st.depth;
+    if (st.high_water > sum.high_water) sum.high_water = st.high_water;
+    sum.drops += st.drops;
+    sum.push_items += st.push_items;
+    sum.pop_items += st.pop_items;
+  }
+  stats_put_queue(&g_stats->queue[STQ_WL1_RAW], &sum);
+
+  bq_t *qs[STQ_N] = { NULL, &p->Q_sm_events, &p->Q_tx_cmd, &p->Q_rsu3_in, &p->Q_air };
+  for (int i = STQ_SM_EVENTS; i < STQ_N; i++) {
+    bq_get_stats(qs[i], &st);
+    stats_put_queue(&g_stats->queue[i], &st);
+  }
+  stats_set(&g_stats->sched_pending, scheduler_pending(&p->sched));
+
+  filter_rule_stats_t rst[STATS_RULES_MAX];
+  int nr = filter_get_rule_stats(rst, STATS_RULES_MAX);
+  for (int i = 0; i < nr; i++) {
+    stats_rule_t *r = &g_stats->rule[i];
+    if (memcmp(r->text, rst[i].text, sizeof(r->text)) != 0) memcpy(r->text, rst[i].text, sizeof(r->text));
+    stats_set(&r->evals, rst[i].evals);
+    stats_set(&r->rejects, rst[i].rejects);
+  }
+  stats_set(&g_stats->rule_count, (uint64_t)nr);
+  stats_set(&g_stats->rule_reorders, filter_rule_reorders());
+
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  stats_set(&g_stats->updated_ms, (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull);
+  atomic_fetch_add_explicit(&g_stats->heartbeat, 1, memory_order_release);
+}
+
+// Q_air(Q_DROP_HEAD)에서 밀려난 프레임은 참조만 반환
+static void drop_frame(void *ctx, void *item) {
+    (void)ctx;
+    bcast_frame_put((bcast_frame_t*)item);
+}
+
 int pipeline_start(pipeline_t *p) {
+  app_config_t cfg;
+  load_default_config(&cfg);
+  return pipeline_start_with(p, &cfg);
+}
+
+int pipeline_start_with(pipeline_t *p, const app_config_t *cfg) {
   memset(p, 0, sizeof(*p));
-  load_default_config(&p->cfg);
+  p->cfg = *cfg;
+  const bool evloop = (p->cfg.runtime_mode == RUNTIME_EVLOOP);
+  // 재생은 RX 소켓 없이 wireless_inject로만 받고, 루프에는 주입을 깨울 통지가 없음 (replay.h)
+  if (evloop && p->cfg.replay_path) {
+    LOGE("replay needs RSU_RUNTIME=threads");
+    return -1;
+  }
+
+  // Object pools (핫패스 calloc/free 제거)
+  if (pools_init() != 0) return -1;
+
+  // 단계별 지연 추적 (꺼져 있어도 SIGUSR1 등으로 켤 수 있게 RX 시각 배열은 항상 준비)
+  if (trace_init() != 0) return -1;
+  trace_reset();
+  if (p->cfg.trace_enable) trace_set_enabled(true);
+
+  // 실행 중 카운터 (실패해도 내부 구조체로 계속, 모든 스레드 시작 전에)
+  (void)stats_shm_open(p->cfg.stats_shm_name);
+
+  sec_vcache_set_enabled(p->cfg.wl1_sig_cache != 0);
+
+  // RX 중복 억제 (wireless RX 조회, WL-1 worker 등록, SM 해제 통지)
+  if (rx_dedup_init(&p->dedup, p->cfg.wl1_dedup_sets, p->cfg.wl1_dedup_window_ms) != 0) return -1;
+
+  // light filter 규칙 (RX 스레드 시작 전에 컴파일)
+  if (filter_set_rules(NULL) != 0 ||
+      (p->cfg.filter_rules_path && filter_load_rules(p->cfg.filter_rules_path) != 0)) {
+    LOGE("filter rules load failed (%s)", p->cfg.filter_rules_path);
+    return -1;
+  }
+
+  // heavy filter (담당영역 격자 인덱스, 워커들이 읽기 전용으로 공유)
+  if (filter_init(&p->filter, &p->cfg) != 0) {
+    LOGE("filter_init failed (zones %s)", p->cfg.zones_path ? p->cfg.zones_path : "-");
+    return -1;
+  }
 
-  // Queues
-  if (bq_init(&p->Q_wl1_raw,   1024, Q_DROP_TAIL) != 0) return -1;
-  if (bq_init(&p->Q_sm_events, 2048, Q_BLOCK)     != 0) return -1;
-  if (bq_init(&p->Q_tx_cmd,    1024, Q_BLOCK)     != 0) return -1;
-  if (bq_init(&p->Q_rsu3_in,   1024, Q_BLOCK)     != 0) return -1;
-  if (bq_init(&p->Q_air,       1024, Q_DROP_HEAD) != 0) return -1;
+  // event loop는 한 스레드에서 모든 샤드를 돌리므로 샤드를 나눌 이유가 없음
+  p->n_wl1_workers = evloop ? 1 : (int)p->cfg.wl1_workers;
+  if (p->n_wl1_workers < 1) p->n_wl1_workers = 1;
+  if (p->n_wl1_workers > WL1_MAX_WORKERS) p->n_wl1_workers = WL1_MAX_WORKERS;
 
-  // Scheduler
+  // Queues (1:1 링크는 lock-free ring, 나머지는 mutex)
+  // WL-1 샤드 큐는 합계 용량이 워커 수와 무관하게 ~1024가 되도록 나눔
+  // event loop는 생산자와 소비자가 같은 스레드 -> Q_BLOCK이면 가득 찼을 때 자기 자신을 기다리므로 DROP_TAIL
+  q_full_policy_t block = evloop ? Q_DROP_TAIL : Q_BLOCK;
+  int shard_cap = 1024 / p->n_wl1_workers;
+  if (shard_cap < 256) shard_cap = 256;
+  for (int i = 0; i < p->n_wl1_workers; i++) {
+    if (bq_init_ring(&p->Q_wl1_raw[i], shard_cap, Q_DROP_TAIL) != 0) return -1; // wireless RX -> WL-1 worker[i]
+  }
+  if (bq_init(&p->Q_sm_events,    2048, block)       != 0) return -1;
+  if (bq_init(&p->Q_tx_cmd,       1024, block)       != 0) return -1;
+  if (bq_init(&p->Q_rsu3_in,      1024, block)       != 0) return -1;
+  if (bq_init_ring(&p->Q_air,     1024, Q_DROP_HEAD) != 0) return -1; // SM -> wireless TX
+  bq_set_drop_fn(&p->Q_air, drop_frame, NULL);
+
+  // Scheduler (event loop에서는 루프가 timerfd로 구동)
   if (scheduler_init(&p->sched, 2048) != 0) return -1;
-  if (pthread_create(&p->th_sched, NULL, scheduler_thread, &p->sched) != 0) return -1;
+  if (!evloop) {
+    if (pthread_create(&p->th_sched, NULL, scheduler_thread, &p->sched) != 0) return -1;
+    p->sched_started = true;
+  }
+  p->stats_timer = scheduler_add_timer(&p->sched, now_ms_monotonic() + STATS_PUBLISH_MS,
+                                       STATS_PUBLISH_MS, stats_publish, p);
 
   // LED (실패해도 계속 진행)
   p->led = led_open(p->cfg.gpiochip, p->cfg.led_line);
@@ -91,38 +342,75 @@ int pipeline_start(pipeline_t *p) {
   p->running = true;
 
   // Wireless (UDP RX/TX)
-  if (wireless_start(&p->wireless, &p->cfg, &p->Q_wl1_raw, &p->Q_air) != 0) {
+  if ((evloop ? wireless_open : wireless_start)(&p->wireless, &p->cfg, p->Q_wl1_raw, p->n_wl1_workers,
+                                                &p->Q_air, &p->dedup) != 0) {
     LOGE("wireless_start failed");
     return -1;
   }
 
   // Wired (TCP to server) - 실패 시에도 “오프라인 모드”로 진행 가능
-  if (wired_client_start(&p->wc, &p->cfg, &p->Q_tx_cmd, &p->Q_rsu3_in) != 0) {
+  if ((evloop ? wired_client_open_loop : wired_client_start)(&p->wc, &p->cfg, &p->Q_tx_cmd,
+                                                             &p->Q_rsu3_in) != 0) {
     LOGW("wired_client_start failed (offline mode)");
+  } else {
+    p->wc_ready = true;
   }
 
   // State manager
-  if (state_manager_start(&p->sm, &p->cfg,
-                          &p->Q_sm_events, &p->Q_tx_cmd, &p->Q_air,
-                          &p->sched, p->led) != 0) {
+  if ((evloop ? state_manager_init : state_manager_start)(&p->sm, &p->cfg,
+                                                          &p->Q_sm_events, &p->Q_tx_cmd, &p->Q_air,
+                                                          &p->sched, p->led, &p->dedup) != 0) {
     LOGE("state_manager_start failed");
     return -1;
   }
 
   // Workers
-  if (pthread_create(&p->th_wl1_worker, NULL, wl1_worker_thread, p) != 0) return -1;
-  if (pthread_create(&p->th_rsu3_dispatch, NULL, rsu3_dispatch_thread, p) != 0) return -1;
+  for (int i = 0; i < p->n_wl1_workers; i++) {
+    if (evloop) {
+      wl1_worker_init(&p->wl1_workers[i], &p->Q_wl1_raw[i], &p->Q_sm_events, p->cfg.rsu_id,
+                      &p->filter, &p->dedup);
+    } else if (wl1_worker_start(&p->wl1_workers[i], &p->Q_wl1_raw[i], &p->Q_sm_events, p->cfg.rsu_id,
+                                &p->filter, &p->dedup) != 0) {
+      return -1;
+    }
+  }
 
-  LOGI("pipeline started");
+  if (evloop) {
+    if (evloop_start(p) != 0) {
+      LOGE("evloop start failed");
+      return -1;
+    }
+    LOGI("pipeline started (event loop)");
+    return 0;
+  }
+
+  if (pthread_create(&p->th_rsu3_dispatch, NULL, rsu3_dispatch_thread, p) != 0) return -1;
+  LOGI("pipeline started (%d WL-1 workers)", p->n_wl1_workers);
   return 0;
 }
 
+static void log_queue_stats(const char *name, bq_t *q) {
+  bq_stats_t st;
+  bq_get_stats(q, &st);
+  LOGI("queue %-13s push %llu items/%llu calls (avg %.2f)  pop %llu items/%llu calls (avg %.2f)  drops %llu",
+       name,
+       (unsigned long long)st.push_items, (unsigned long long)st.push_calls,
+       st.push_calls ? (double)st.push_items / (double)st.push_calls : 0.0,
+       (unsigned long long)st.pop_items, (unsigned long long)st.pop_calls,
+       st.pop_calls ? (double)st.pop_items / (double)st.pop_calls : 0.0,
+       (unsigned long long)st.drops);
+}
+
 void pipeline_stop(pipeline_t *p) {
   if (!p) return;
   p->running = false;
+  const bool evloop = (p->cfg.runtime_mode == RUNTIME_EVLOOP);
+
+  // event loop가 스테이지를 모두 구동하므로 먼저 멈춤 (이후 모듈 정리는 스레드 없이)
+  if (evloop) evloop_stop(p);
 
   // stop queues first to wake blockers
-  bq_stop(&p->Q_wl1_raw);
+  for (int i = 0; i < p->n_wl1_workers; i++) bq_stop(&p->Q_wl1_raw[i]);
   bq_stop(&p->Q_sm_events);
   bq_stop(&p->Q_tx_cmd);
   bq_stop(&p->Q_rsu3_in);
@@ -136,21 +424,65 @@ void pipeline_stop(pipeline_t *p) {
 
   // stop scheduler
   scheduler_stop(&p->sched);
-  pthread_join(p->th_sched, NULL);
+  if (p->sched_started) pthread_join(p->th_sched, NULL);
   scheduler_destroy(&p->sched);
 
   // join workers
-  pthread_join(p->th_wl1_worker, NULL);
-  pthread_join(p->th_rsu3_dispatch, NULL);
+  if (!evloop) {
+    for (int i = 0; i < p->n_wl1_workers; i++) wl1_worker_join(&p->wl1_workers[i]);
+    pthread_join(p->th_rsu3_dispatch, NULL);
+  }
+  filter_destroy(&p->filter);
+
+  // 갱신하던 스레드가 모두 끝난 뒤 (rsu-top은 heartbeat가 멈춘 걸로 종료를 봄)
+  stats_shm_close();
 
   led_close(p->led);
 
+  // 평균 배치 크기 확인용
+  for (int i = 0; i < p->n_wl1_workers; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "Q_wl1_raw[%d]", i);
+    log_queue_stats(name, &p->Q_wl1_raw[i]);
+  }
+  log_queue_stats("Q_sm_events", &p->Q_sm_events);
+  log_queue_stats("Q_tx_cmd",    &p->Q_tx_cmd);
+  log_queue_stats("Q_rsu3_in",   &p->Q_rsu3_in);
+  log_queue_stats("Q_air",       &p->Q_air);
+
   // destroy queues
-  bq_destroy(&p->Q_wl1_raw);
+  for (int i = 0; i < p->n_wl1_workers; i++) bq_destroy(&p->Q_wl1_raw[i]);
   bq_destroy(&p->Q_sm_events);
   bq_destroy(&p->Q_tx_cmd);
   bq_destroy(&p->Q_rsu3_in);
   bq_destroy(&p->Q_air);
 
+  filter_rule_stats_t rst[FILTER_RULES_MAX];
+  int nr = filter_get_rule_stats(rst, FILTER_RULES_MAX);
+  for (int i = 0; i < nr; i++) {
+    LOGI("filter rule [%d] %-24s evals %llu rejects %llu", i, rst[i].text,
+         (unsigned long long)rst[i].evals, (unsigned long long)rst[i].rejects);
+  }
+  LOGI("filter rule reorders %llu", (unsigned long long)filter_rule_reorders());
+
+  rx_dedup_stats_t dst;
+  rx_dedup_get_stats(&p->dedup, &dst);
+  LOGI("rx dedup suppressed %llu passed %llu inserted %llu forgets %llu",
+       (unsigned long long)dst.suppressed, (unsigned long long)dst.passed,
+       (unsigned long long)dst.inserted, (unsigned long long)dst.forgets);
+  rx_dedup_destroy(&p->dedup);
+
+  sec_vcache_stats_t vst;
+  sec_vcache_get_stats(&vst);
+  LOGI("sig cache hits %llu misses %llu evictions %llu busy_skips %llu",
+       (unsigned long long)vst.hits, (unsigned long long)vst.misses,
+       (unsigned long long)vst.evictions, (unsigned long long)vst.busy_skips);
+
+  trace_log_stats();
+  trace_destroy();
+
+  pools_log_stats();
+  pools_destroy();
+
   LOGI("pipeline stopped");
 }
@@ -0,0 +1,68 @@
+// app/pools.c
+#include "pools.h"
+#include "types.h"
+#include "bcast_frame.h"
+#include "log.h"
+
+// 슬롯 수: 해당 객체가 머무를 수 있는 큐 용량 합 + 여유분
+#ifndef POOL_WL1_PKT_COUNT
+#define POOL_WL1_PKT_COUNT 1536   // Q_wl1_raw(1024) + RX 슬롯/여유
+#endif
+#ifndef POOL_RSU2P_COUNT
+#define POOL_RSU2P_COUNT   3328   // Q_sm_events(2048) + Q_tx_cmd(1024) + 여유
+#endif
+#ifndef POOL_RSU3P_COUNT
+#define POOL_RSU3P_COUNT   3328   // Q_rsu3_in(1024) + Q_sm_events(2048) + 여유
+#endif
+#ifndef POOL_SM_EV_COUNT
+#define POOL_SM_EV_COUNT   2304   // Q_sm_events(2048) + 여유
+#endif
+#ifndef POOL_TX_CMD_COUNT
+#define POOL_TX_CMD_COUNT  1280   // Q_tx_cmd(1024) + 여유
+#endif
+#ifndef POOL_BFRAME_COUNT
+#define POOL_BFRAME_COUNT  2048   // 캐시된 active 사고 + Q_air 복사본 (넘치면 heap)
+#endif
+
+pkt_pools_t g_pools;
+
+int pools_init(void) {
+  if (mempool_init(&g_pools.wl1_pkt, "wl1_pkt", sizeof(wl1_packet_t),   POOL_WL1_PKT_COUNT) != 0) goto fail;
+  if (mempool_init(&g_pools.rsu2p,   "rsu2p",   sizeof(rsu2_payload_t), POOL_RSU2P_COUNT)   != 0) goto fail;
+  if (mempool_init(&g_pools.rsu3p,   "rsu3p",   sizeof(rsu3_payload_t), POOL_RSU3P_COUNT)   != 0) goto fail;
+  if (mempool_init(&g_pools.sm_ev,   "sm_ev",   sizeof(sm_event_t),     POOL_SM_EV_COUNT)   != 0) goto fail;
+  if (mempool_init(&g_pools.tx_cmd,  "tx_cmd",  sizeof(tx_cmd_wired_t), POOL_TX_CMD_COUNT)  != 0) goto fail;
+  if (mempool_init(&g_pools.bframe,  "bframe",  sizeof(bcast_frame_t),  POOL_BFRAME_COUNT)  != 0) goto fail;
+  return 0;
+
+fail:
+  LOGE("pools_init failed");
+  pools_destroy();
+  return -1;
+}
+
+void pools_destroy(void) {
+  mempool_destroy(&g_pools.wl1_pkt);
+  mempool_destroy(&g_pools.rsu2p);
+  mempool_destroy(&g_pools.rsu3p);
+  mempool_destroy(&g_pools.sm_ev);
+  mempool_destroy(&g_pools.tx_cmd);
+  mempool_destroy(&g_pools.bframe);
+}
+
+static void log_one(mempool_t *mp) {
+  mempool_stats_t st;
+  mempool_get_stats(mp, &st);
+  LOGI("pool %-8s cap=%u in_use=%u high_water=%u exhausted=%llu",
+       mp->name ? mp->name : "?", st.capacity, st.in_use, st.high_water,
+       (unsigned long long)st.exhausted);
+}
+
+void pools_log_stats(void) {
+  log_one(&g_pools.wl1_pkt);
+  log_one(&g_pools.rsu2p);
+  log_one(&g_pools.rsu3p);
+  log_one(&g_pools.sm_ev);
+  log_one(&g_pools.tx_cmd);
+  log_one(&g_pools.bframe);
+}
@@ -1,44 +1,109 @@
 // common/queue.c
+#define _GNU_SOURCE // syscall(SYS_futex)
 #include "queue.h"
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t mono_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// =============================================================================
+// BQ_MUTEX: mutex + condvar
+// =============================================================================
 
 int bq_init(bq_t *q, int cap, q_full_policy_t policy) {
   memset(q, 0, sizeof(*q));
+  q->backend = BQ_MUTEX;
   q->buf = (void**)calloc((size_t)cap, sizeof(void*));
   if (!q->buf) return -1;
   q->cap = cap;
   q->policy = policy;
+  q->notify_fd = -1;
   pthread_mutex_init(&q->mtx, NULL);
-  pthread_cond_init(&q->not_empty, NULL);
-  pthread_cond_init(&q->not_full, NULL);
+  // bq_pop_many_timed 대기는 CLOCK_MONOTONIC 기준
+  pthread_condattr_t ca;
+  pthread_condattr_init(&ca);
+  pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+  pthread_cond_init(&q->not_empty, &ca);
+  pthread_cond_init(&q->not_full, &ca);
+  pthread_condattr_destroy(&ca);
   return 0;
 }
 
-void bq_stop(bq_t *q) {
+static void mq_notify(int fd) {
+  uint64_t one = 1;
+  ssize_t r = write(fd, &one, sizeof(one));
+  (void)r;
+}
+
+static void mq_stop(bq_t *q) {
   pthread_mutex_lock(&q->mtx);
   q->stop = true;
   pthread_cond_broadcast(&q->not_empty);
   pthread_cond_broadcast(&q->not_full);
+  int nfd = q->notify_fd;
   pthread_mutex_unlock(&q->mtx);
+  if (nfd >= 0) mq_notify(nfd);
 }
 
 void bq_destroy(bq_t *q) {
   if (!q) return;
   free(q->buf);
+  free(q->cells);
   pthread_mutex_destroy(&q->mtx);
   pthread_cond_destroy(&q->not_empty);
   pthread_cond_destroy(&q->not_full);
 }
 
 uint64_t bq_drop_count(bq_t *q) {
-  pthread_mutex_lock(&q->mtx);
-  uint64_t d = q->drop_cnt;
-  pthread_mutex_unlock(&q->mtx);
-  return d;
+  return atomic_load_explicit(&q->drop_cnt, memory_order_relaxed);
 }
 
-bool bq_push(bq_t *q, void *item) {
+uint32_t bq_depth(bq_t *q) {
+  if (q->backend != BQ_RING) return atomic_load_explicit(&q->depth_pub, memory_order_relaxed);
+  // deq를 먼저 읽어야 enq - deq가 음수로 보이지 않음
+  uint64_t deq = atomic_load_explicit(&q->deq_pos, memory_order_relaxed);
+  uint64_t enq = atomic_load_explicit(&q->enq_pos, memory_order_relaxed);
+  uint64_t d = (enq > deq) ? enq - deq : 0;
+  return (uint32_t)((d > (uint64_t)q->cap) ? (uint64_t)q->cap : d);
+}
+
+void bq_get_stats(bq_t *q, bq_stats_t *st) {
+  st->push_calls = atomic_load_explicit(&q->push_calls, memory_order_relaxed);
+  st->push_items = atomic_load_explicit(&q->push_items, memory_order_relaxed);
+  st->pop_calls  = atomic_load_explicit(&q->pop_calls, memory_order_relaxed);
+  st->pop_items  = atomic_load_explicit(&q->pop_items, memory_order_relaxed);
+  st->drops      = atomic_load_explicit(&q->drop_cnt, memory_order_relaxed);
+  st->cap        = (uint32_t)q->cap;
+  st->depth      = bq_depth(q);
+  st->high_water = atomic_load_explicit(&q->high_water, memory_order_relaxed);
+}
+
+static inline void bq_count(_Atomic uint64_t *calls, _Atomic uint64_t *items, int n) {
+  if (n <= 0) return;
+  atomic_fetch_add_explicit(calls, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(items, (uint64_t)n, memory_order_relaxed);
+}
+
+// 깊이 공개 (잠금 안에서 호출, 다른 스레드는 bq_depth로 잠금 없이 읽음)
+static inline void mq_pub(bq_t *q) {
+  uint32_t d = (uint32_t)q->size;
+  atomic_store_explicit(&q->depth_pub, d, memory_order_relaxed);
+  if (d > atomic_load_explicit(&q->high_water, memory_order_relaxed)) {
+    atomic_store_explicit(&q->high_water, d, memory_order_relaxed);
+  }
+}
+
+static bool mq_push(bq_t *q, void *item) {
   pthread_mutex_lock(&q->mtx);
 
   while (!q->stop && q->size == q->cap && q->policy == Q_BLOCK) {
@@ -53,20 +118,44 @@ bool bq_push(bq_t *q, void *item) {
       return false;
     } else if (q->policy == Q_DROP_HEAD) {
       q->drop_cnt++;
+      if (q->drop_fn) q->drop_fn(q->drop_ctx, q->buf[q->head]);
+      q->buf[q->head] = NULL;
       q->head = (q->head + 1) % q->cap;
       q->size--;
     }
   }
 
+  bool was_empty = q->size == 0;
   q->buf[q->tail] = item;
   q->tail = (q->tail + 1) % q->cap;
   q->size++;
+  mq_pub(q);
   pthread_cond_signal(&q->not_empty);
+  int nfd = was_empty ? q->notify_fd : -1;
   pthread_mutex_unlock(&q->mtx);
+  if (nfd >= 0) mq_notify(nfd);
   return true;
 }
 
-void* bq_pop(bq_t *q) {
+static bool mq_try_push(bq_t *q, void *item) {
+  pthread_mutex_lock(&q->mtx);
+  if (q->stop || q->size == q->cap) {
+    pthread_mutex_unlock(&q->mtx);
+    return false;
+  }
+  bool was_empty = q->size == 0;
+  q->buf[q->tail] = item;
+  q->tail = (q->tail + 1) % q->cap;
+  q->size++;
+  mq_pub(q);
+  pthread_cond_signal(&q->not_empty);
+  int nfd = was_empty ? q->notify_fd : -1;
+  pthread_mutex_unlock(&q->mtx);
+  if (nfd >= 0) mq_notify(nfd);
+  return true;
+}
+
+static void* mq_pop(bq_t *q) {
   pthread_mutex_lock(&q->mtx);
   while (!q->stop && q->size == 0) {
     pthread_cond_wait(&q->not_empty, &q->mtx);
@@ -77,7 +166,438 @@ void* bq_pop(bq_t *q) {
   q->buf[q->head] = NULL;
   q->head = (q->head + 1) % q->cap;
   q->size--;
+  mq_pub(q);
   pthread_cond_signal(&q->not_full);
   pthread_mutex_unlock(&q->mtx);
   return item;
 }
+
+static int mq_push_many(bq_t *q, void **items, int n) {
+  pthread_mutex_lock(&q->mtx);
+
+  // 비어 있다가 들어온 적이 있으면 eventfd 통지 (대기 중 소비자가 비운 뒤 다시 넣는 경우 포함)
+  bool need_notify = false;
+  int pushed = 0;
+  while (pushed < n) {
+    if (q->stop) break;
+
+    if (q->size == q->cap) {
+      if (q->policy == Q_BLOCK) {
+        // 이미 넣은 것부터 소비자가 가져가도록 깨운 뒤 대기
+        // (epoll 소비자는 condvar를 안 보므로 여기서 통지하지 않으면 서로 기다림)
+        mq_pub(q);
+        if (pushed > 0) pthread_cond_signal(&q->not_empty);
+        if (need_notify && q->notify_fd >= 0) mq_notify(q->notify_fd);
+        need_notify = false;
+        pthread_cond_wait(&q->not_full, &q->mtx);
+        continue;
+      } else if (q->policy == Q_DROP_TAIL) {
+        q->drop_cnt += (uint64_t)(n - pushed);
+        break;
+      } else if (q->policy == Q_DROP_HEAD) {
+        q->drop_cnt++;
+        if (q->drop_fn) q->drop_fn(q->drop_ctx, q->buf[q->head]);
+        q->buf[q->head] = NULL;
+        q->head = (q->head + 1) % q->cap;
+        q->size--;
+      }
+    }
+
+    if (q->size == 0) need_notify = true;
+    q->buf[q->tail] = items[pushed++];
+    q->tail = (q->tail + 1) % q->cap;
+    q->size++;
+  }
+
+  mq_pub(q);
+  if (pushed > 1) pthread_cond_broadcast(&q->not_empty);
+  else if (pushed == 1) pthread_cond_signal(&q->not_empty);
+  int nfd = need_notify ? q->notify_fd : -1;
+  pthread_mutex_unlock(&q->mtx);
+  if (nfd >= 0) mq_notify(nfd);
+  return pushed;
+}
+
+// deadline_ns == 0: 무기한 대기
+static int mq_pop_many(bq_t *q, void **out, int max, uint64_t deadline_ns) {
+  pthread_mutex_lock(&q->mtx);
+  struct timespec ts = { (time_t)(deadline_ns / 1000000000ull), (long)(deadline_ns % 1000000000ull) };
+  while (!q->stop && q->size == 0) {
+    if (!deadline_ns) {
+      pthread_cond_wait(&q->not_empty, &q->mtx);
+    } else if (pthread_cond_timedwait(&q->not_empty, &q->mtx, &ts) == ETIMEDOUT) {
+      break;
+    }
+  }
+  if (q->size == 0) { pthread_mutex_unlock(&q->mtx); return 0; }
+
+  int n = 0;
+  while (n < max && q->size > 0) {
+    out[n++] = q->buf[q->head];
+    q->buf[q->head] = NULL;
+    q->head = (q->head + 1) % q->cap;
+    q->size--;
+  }
+  mq_pub(q);
+  if (n > 1) pthread_cond_broadcast(&q->not_full);
+  else       pthread_cond_signal(&q->not_full);
+  pthread_mutex_unlock(&q->mtx);
+  return n;
+}
+
+
+// =============================================================================
+// BQ_RING: lock-free bounded ring + futex 대기
+// - 셀마다 시퀀스 번호를 두는 Vyukov 방식. enq/deq 위치는 CAS로 전진하므로
+//   Q_DROP_HEAD에서 생산자가 head를 하나 꺼내 버리는 것도 안전함
+// - 소비자는 비어있을 때만, 생산자는 Q_BLOCK에서 가득 찼을 때만 futex로 잠듦
+// - Q_BLOCK 생산자는 링이 절반 비었을 때 한꺼번에 깨움
+// =============================================================================
+#ifndef BQ_RING_SPIN
+#define BQ_RING_SPIN 64   // futex로 잠들기 전 짧게 재시도하는 횟수
+#endif
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+// 단일 코어에선 스핀이 상대 스레드 실행만 늦추므로 바로 잠듦
+static int ring_spin_limit(void) {
+  static _Atomic int limit = -1;
+  int l = atomic_load_explicit(&limit, memory_order_relaxed);
+  if (l < 0) {
+    l = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? BQ_RING_SPIN : 0;
+    atomic_store_explicit(&limit, l, memory_order_relaxed);
+  }
+  return l;
+}
+
+static void futex_wait(_Atomic uint32_t *addr, uint32_t val, const struct timespec *rel) {
+  syscall(SYS_futex, (uint32_t*)addr, FUTEX_WAIT_PRIVATE, val, rel, NULL, 0);
+}
+
+static void futex_wake(_Atomic uint32_t *addr, int n) {
+  syscall(SYS_futex, (uint32_t*)addr, FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+}
+
+// futex word: 0 = 잠든 쪽 없음, 1 = 누군가 잠들었거나 잠들려는 중
+// 깨우는 쪽은 exchange로 0을 만든 한 번만 syscall (깨어난 소비자가 아직
+// 스케줄되지 않았어도 이후 push는 syscall 없이 지나감)
+static inline void ring_wake(_Atomic uint32_t *word) {
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(word, memory_order_relaxed) == 0) return;
+  if (atomic_exchange_explicit(word, 0, memory_order_acq_rel) != 0) futex_wake(word, INT_MAX);
+}
+
+// 잠들기 전 표시. 이후 조건을 다시 확인하고 그래도 안 되면 ring_sleep
+static inline void ring_prepare_sleep(_Atomic uint32_t *word) {
+  atomic_store_explicit(word, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+}
+
+static inline void ring_sleep(_Atomic uint32_t *word) {
+  futex_wait(word, 1, NULL);
+}
+
+static bool ring_try_enq(bq_t *q, void *item) {
+  uint64_t pos = atomic_load_explicit(&q->enq_pos, memory_order_relaxed);
+  for (;;) {
+    bq_cell_t *c = &q->cells[pos & q->mask];
+    uint64_t seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+    int64_t dif = (int64_t)seq - (int64_t)pos;
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&q->enq_pos, &pos, pos + 1,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        c->item = item;
+        atomic_store_explicit(&c->seq, pos + 1, memory_order_release);
+        return true;
+      }
+    } else if (dif < 0) {
+      return false; // full
+    } else {
+      pos = atomic_load_explicit(&q->enq_pos, memory_order_relaxed);
+    }
+  }
+}
+
+static void* ring_try_deq(bq_t *q) {
+  uint64_t pos = atomic_load_explicit(&q->deq_pos, memory_order_relaxed);
+  for (;;) {
+    bq_cell_t *c = &q->cells[pos & q->mask];
+    uint64_t seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+    int64_t dif = (int64_t)seq - (int64_t)(pos + 1);
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&q->deq_pos, &pos, pos + 1,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        void *item = c->item;
+        atomic_store_explicit(&c->seq, pos + q->mask + 1, memory_order_release);
+        return item;
+      }
+    } else if (dif < 0) {
+      return NULL; // empty
+    } else {
+      pos = atomic_load_explicit(&q->deq_pos, memory_order_relaxed);
+    }
+  }
+}
+
+static inline bool ring_stopped(bq_t *q) {
+  return atomic_load_explicit(&q->stop, memory_order_acquire);
+}
+
+// 정책에 따라 item 1개 넣기. 소비자 깨우기는 호출자가 함
+static bool ring_enq_policy(bq_t *q, void *item) {
+  for (;;) {
+    if (ring_stopped(q)) return false;
+    if (ring_try_enq(q, item)) return true;
+
+    if (q->policy == Q_DROP_TAIL) {
+      atomic_fetch_add_explicit(&q->drop_cnt, 1, memory_order_relaxed);
+      return false;
+    }
+    if (q->policy == Q_DROP_HEAD) {
+      void *old = ring_try_deq(q);
+      if (old) {
+        atomic_fetch_add_explicit(&q->drop_cnt, 1, memory_order_relaxed);
+        if (q->drop_fn) q->drop_fn(q->drop_ctx, old);
+      }
+      continue;
+    }
+
+    // Q_BLOCK: 소비자를 먼저 깨우고 빈 칸이 생길 때까지 대기
+    ring_wake(&q->ne_futex);
+    ring_prepare_sleep(&q->nf_futex);
+    if (ring_stopped(q)) return false;
+    if (ring_try_enq(q, item)) return true;
+    ring_sleep(&q->nf_futex);
+  }
+}
+
+// 최소 1개를 꺼낼 때까지 (stop 또는 deadline_ns 경과면 NULL, 0 = 무기한)
+static void* ring_deq_wait(bq_t *q, uint64_t deadline_ns) {
+  int spin_limit = ring_spin_limit();
+  for (int spin = 0; ; spin++) {
+    void *item = ring_try_deq(q);
+    if (item) return item;
+    if (ring_stopped(q)) return NULL;
+    if (spin < spin_limit) { cpu_relax(); continue; }
+
+    struct timespec rel, *prel = NULL;
+    if (deadline_ns) {
+      uint64_t now = mono_ns();
+      if (now >= deadline_ns) return NULL;
+      rel.tv_sec = (time_t)((deadline_ns - now) / 1000000000ull);
+      rel.tv_nsec = (long)((deadline_ns - now) % 1000000000ull);
+      prel = &rel;
+    }
+    ring_prepare_sleep(&q->ne_futex);
+    item = ring_try_deq(q);
+    if (item) return item;
+    if (ring_stopped(q)) return NULL;
+    futex_wait(&q->ne_futex, 1, prel);
+  }
+}
+
+// 생산자가 push 후 최고 수위 갱신 (생산자 여럿이면 CAS로 max)
+// 깊이는 bq_depth와 같은 순서로 (deq 먼저): 거꾸로 읽으면 enq - deq가 underflow해 cap으로 잘림
+static inline void ring_note_hw(bq_t *q) {
+  uint32_t d = bq_depth(q);
+  uint32_t hw = atomic_load_explicit(&q->high_water, memory_order_relaxed);
+  while (d > hw &&
+         !atomic_compare_exchange_weak_explicit(&q->high_water, &hw, d,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+  }
+}
+
+static bool ring_push(bq_t *q, void *item) {
+  bool ok = ring_enq_policy(q, item);
+  if (ok) {
+    ring_note_hw(q);
+    ring_wake(&q->ne_futex);
+  }
+  return ok;
+}
+
+static bool ring_try_push(bq_t *q, void *item) {
+  if (ring_stopped(q) || !ring_try_enq(q, item)) return false;
+  ring_note_hw(q);
+  ring_wake(&q->ne_futex);
+  return true;
+}
+
+static int ring_push_many(bq_t *q, void **items, int n) {
+  int pushed = 0;
+  while (pushed < n && ring_enq_policy(q, items[pushed])) pushed++;
+  // Q_DROP_TAIL: 첫 실패 이후 나머지도 버림으로 셈 (BQ_MUTEX와 동일)
+  if (pushed < n && q->policy == Q_DROP_TAIL && !ring_stopped(q)) {
+    atomic_fetch_add_explicit(&q->drop_cnt, (uint64_t)(n - pushed - 1), memory_order_relaxed);
+  }
+  if (pushed > 0) {
+    ring_note_hw(q);
+    ring_wake(&q->ne_futex);
+  }
+  return pushed;
+}
+
+// Q_BLOCK에서 막힌 생산자는 절반이 빌 때 한꺼번에 깨움 (pop마다 wake syscall 방지)
+// 생산자는 대기 등록 후 가득 찼는지 다시 보므로, 잠든 시점엔 절반 이상 차 있고
+// 소비자가 비우는 도중 반드시 이 조건을 지나감
+static inline void ring_notify_not_full(bq_t *q) {
+  if (q->policy != Q_BLOCK) return;
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&q->nf_futex, memory_order_relaxed) == 0) return;
+  uint64_t used = atomic_load_explicit(&q->enq_pos, memory_order_relaxed) -
+                  atomic_load_explicit(&q->deq_pos, memory_order_relaxed);
+  if (used > (q->mask + 1) / 2) return;
+  ring_wake(&q->nf_futex);
+}
+
+static void* ring_pop(bq_t *q) {
+  void *item = ring_deq_wait(q, 0);
+  if (item) ring_notify_not_full(q);
+  return item;
+}
+
+static int ring_pop_many(bq_t *q, void **out, int max, uint64_t deadline_ns) {
+  void *first = ring_deq_wait(q, deadline_ns);
+  if (!first) return 0;
+  int n = 0;
+  out[n++] = first;
+  while (n < max) {
+    void *item = ring_try_deq(q);
+    if (!item) break;
+    out[n++] = item;
+  }
+  ring_notify_not_full(q);
+  return n;
+}
+
+static void ring_stop(bq_t *q) {
+  atomic_store_explicit(&q->stop, true, memory_order_seq_cst);
+  atomic_store_explicit(&q->ne_futex, 0, memory_order_seq_cst);
+  atomic_store_explicit(&q->nf_futex, 0, memory_order_seq_cst);
+  futex_wake(&q->ne_futex, INT_MAX);
+  futex_wake(&q->nf_futex, INT_MAX);
+}
+
+int bq_init_ring(bq_t *q, int cap, q_full_policy_t policy) {
+  memset(q, 0, sizeof(*q));
+  if (cap < 2) cap = 2;
+  uint64_t rcap = 1;
+  while (rcap < (uint64_t)cap) rcap <<= 1;
+
+  q->cells = (bq_cell_t*)aligned_alloc(64, ((size_t)rcap * sizeof(bq_cell_t) + 63) & ~(size_t)63);
+  if (!q->cells) return -1;
+  for (uint64_t i = 0; i < rcap; i++) {
+    atomic_init(&q->cells[i].seq, i);
+    q->cells[i].item = NULL;
+  }
+
+  q->backend = BQ_RING;
+  q->cap = (int)rcap;
+  q->mask = rcap - 1;
+  q->policy = policy;
+  q->notify_fd = -1;
+  // 공통 destroy 경로를 위해 초기화만 해 둠
+  pthread_mutex_init(&q->mtx, NULL);
+  pthread_cond_init(&q->not_empty, NULL);
+  pthread_cond_init(&q->not_full, NULL);
+  return 0;
+}
+
+// =============================================================================
+// 공통 API
+// =============================================================================
+void bq_set_drop_fn(bq_t *q, bq_drop_fn_t fn, void *ctx) {
+  pthread_mutex_lock(&q->mtx);
+  q->drop_fn = fn;
+  q->drop_ctx = ctx;
+  pthread_mutex_unlock(&q->mtx);
+}
+
+int bq_set_notify_fd(bq_t *q, int fd) {
+  if (q->backend != BQ_MUTEX) return -1;
+  pthread_mutex_lock(&q->mtx);
+  q->notify_fd = fd;
+  bool pending = q->size > 0 || q->stop;
+  pthread_mutex_unlock(&q->mtx);
+  if (pending && fd >= 0) mq_notify(fd);
+  return 0;
+}
+
+void bq_stop(bq_t *q) {
+  if (q->backend == BQ_RING) ring_stop(q);
+  else mq_stop(q);
+}
+
+bool bq_push(bq_t *q, void *item) {
+  bool ok = (q->backend == BQ_RING) ? ring_push(q, item) : mq_push(q, item);
+  bq_count(&q->push_calls, &q->push_items, ok ? 1 : 0);
+  return ok;
+}
+
+bool bq_try_push(bq_t *q, void *item) {
+  bool ok = (q->backend == BQ_RING) ? ring_try_push(q, item) : mq_try_push(q, item);
+  bq_count(&q->push_calls, &q->push_items, ok ? 1 : 0);
+  return ok;
+}
+
+int bq_push_many(bq_t *q, void **items, int n) {
+  if (n <= 0) return 0;
+  int pushed = (q->backend == BQ_RING) ? ring_push_many(q, items, n) : mq_push_many(q, items, n);
+  bq_count(&q->push_calls, &q->push_items, pushed);
+  return pushed;
+}
+
+void* bq_pop(bq_t *q) {
+  void *item = (q->backend == BQ_RING) ? ring_pop(q) : mq_pop(q);
+  bq_count(&q->pop_calls, &q->pop_items, item ? 1 : 0);
+  return item;
+}
+
+int bq_pop_many(bq_t *q, void **out, int max) {
+  if (max <= 0) return 0;
+  int n = (q->backend == BQ_RING) ? ring_pop_many(q, out, max, 0) : mq_pop_many(q, out, max, 0);
+  bq_count(&q->pop_calls, &q->pop_items, n);
+  return n;
+}
+
+int bq_try_pop_many(bq_t *q, void **out, int max) {
+  if (max <= 0) return 0;
+  int n = 0;
+  if (q->backend == BQ_RING) {
+    while (n < max) {
+      void *item = ring_try_deq(q);
+      if (!item) break;
+      out[n++] = item;
+    }
+    if (n) ring_notify_not_full(q);
+  } else {
+    pthread_mutex_lock(&q->mtx);
+    while (n < max && q->size > 0) {
+      out[n++] = q->buf[q->head];
+      q->buf[q->head] = NULL;
+      q->head = (q->head + 1) % q->cap;
+      q->size--;
+    }
+    if (n) mq_pub(q);
+    if (n > 1) pthread_cond_broadcast(&q->not_full);
+    else if (n) pthread_cond_signal(&q->not_full);
+    pthread_mutex_unlock(&q->mtx);
+  }
+  bq_count(&q->pop_calls, &q->pop_items, n);
+  return n;
+}
+
+int bq_pop_many_timed(bq_t *q, void **out, int max, uint32_t timeout_us) {
+  if (max <= 0) return 0;
+  uint64_t deadline = mono_ns() + (uint64_t)timeout_us * 1000ull;
+  int n = (q->backend == BQ_RING) ? ring_pop_many(q, out, max, deadline)
+                                  : mq_pop_many(q, out, max, deadline);
+  bq_count(&q->pop_calls, &q->pop_items, n);
+  return n;
+}
@@ -0,0 +1,358 @@
+// app/replay.c
+#define _GNU_SOURCE // madvise, usleep
+#include "replay.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "stats_shm.h"
+#include "types.h"
+
+#define PCAP_MAGIC_US  0xa1b2c3d4u
+#define PCAP_MAGIC_NS  0xa1b23c4du
+#define PCAPNG_MAGIC   0x0a0d0d0au
+
+#define LINKTYPE_NULL       0
+#define LINKTYPE_ETHERNET   1
+#define LINKTYPE_RAW        101
+#define LINKTYPE_LOOP       108
+#define LINKTYPE_LINUX_SLL  113
+#define LINKTYPE_IPV4       228
+#define LINKTYPE_LINUX_SLL2 276
+
+#ifndef REPLAY_DRAIN_MAX_MS
+#define REPLAY_DRAIN_MAX_MS 10000   // 재생 후 파이프라인이 비기를 기다리는 상한
+#endif
+
+typedef struct {
+  const uint8_t *cur, *end;
+  bool pcap;
+  bool swapped;        // 캡처 머신과 바이트 순서가 다름
+  bool nsec;           // 타임스탬프 소수부가 ns
+  uint32_t linktype;
+  uint16_t port;       // dst port (0 = 전부)
+  uint64_t skipped;    // WL-1 UDP가 아닌 프레임
+} replay_src_t;
+
+// 단계별 누적값 (재생 전후 차이로 보고)
+typedef struct {
+  uint64_t rx;
+  uint64_t pass[STF_N], reject[STF_N];
+  uint64_t reports;
+  bq_stats_t q[STQ_N];
+} replay_snap_t;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t rd32(const uint8_t *p, bool swapped) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return swapped ? __builtin_bswap32(v) : v;
+}
+
+static uint16_t be16(const uint8_t *p) {
+  return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+// 링크 헤더를 건너뛰고 IPv4 UDP payload만 (조각난 datagram/잘린 캡처/다른 포트는 NULL)
+static const uint8_t* udp_payload(const replay_src_t *s, const uint8_t *f, uint32_t caplen,
+                                  uint32_t *out_len) {
+  uint32_t off = 0;
+  uint16_t etype = 0x0800;
+  switch (s->linktype) {
+    case LINKTYPE_ETHERNET:
+      if (caplen < 14) return NULL;
+      etype = be16(f + 12);
+      off = 14;
+      while (etype == 0x8100 || etype == 0x88a8) {   // VLAN 태그
+        if (caplen < off + 4) return NULL;
+        etype = be16(f + off + 2);
+        off += 4;
+      }
+      break;
+    case LINKTYPE_LINUX_SLL:
+      if (caplen < 16) return NULL;
+      etype = be16(f + 14);
+      off = 16;
+      break;
+    case LINKTYPE_LINUX_SLL2:
+      if (caplen < 20) return NULL;
+      etype = be16(f);
+      off = 20;
+      break;
+    case LINKTYPE_NULL:
+    case LINKTYPE_LOOP: {
+      // family(AF_INET = 2)는 캡처 머신 바이트 순서
+      if (caplen < 4) return NULL;
+      uint32_t fam;
+      memcpy(&fam, f, sizeof(fam));
+      if (fam != 2 && __builtin_bswap32(fam) != 2) return NULL;
+      off = 4;
+      break;
+    }
+    case LINKTYPE_RAW:
+    case LINKTYPE_IPV4:
+      break;
+    default:
+      return NULL;
+  }
+  if (etype != 0x0800) return NULL;
+
+  const uint8_t *ip = f + off;
+  uint32_t rem = caplen - off;
+  if (rem < 20 || (ip[0] >> 4) != 4 || ip[9] != 17) return NULL;
+  uint32_t ihl = (uint32_t)(ip[0] & 0x0f) * 4;
+  if (ihl < 20 || rem < ihl + 8) return NULL;
+  if (be16(ip + 6) & 0x3fff) return NULL;   // MF 또는 offset: 재조립 안 함 (256B는 조각나지 않음)
+
+  const uint8_t *udp = ip + ihl;
+  if (s->port && be16(udp + 2) != s->port) return NULL;
+  uint32_t ulen = be16(udp + 4);
+  if (ulen < 8 || ihl + ulen > rem) return NULL;   // snaplen으로 잘림
+  *out_len = ulen - 8;
+  return udp + 8;
+}
+
+// 다음 WL-1 datagram (1) / 끝 (0). ts_ns는 pcap만 (raw는 0)
+static int src_next(replay_src_t *s, const uint8_t **data, uint32_t *len, uint64_t *ts_ns) {
+  if (!s->pcap) {
+    if ((size_t)(s->end - s->cur) < sizeof(wl1_packet_t)) return 0;
+    *data = s->cur;
+    *len = sizeof(wl1_packet_t);
+    *ts_ns = 0;
+    s->cur += sizeof(wl1_packet_t);
+    return 1;
+  }
+  while ((size_t)(s->end - s->cur) >= 16) {
+    uint32_t sec = rd32(s->cur, s->swapped);
+    uint32_t frac = rd32(s->cur + 4, s->swapped);
+    uint32_t caplen = rd32(s->cur + 8, s->swapped);
+    const uint8_t *f = s->cur + 16;
+    if ((size_t)(s->end - f) < caplen) return 0;   // 마지막 레코드가 잘림
+    s->cur = f + caplen;
+
+    const uint8_t *pl = udp_payload(s, f, caplen, len);
+    if (!pl) {
+      s->skipped++;
+      continue;
+    }
+    *data = pl;
+    *ts_ns = (uint64_t)sec * 1000000000ull + (s->nsec ? frac : (uint64_t)frac * 1000ull);
+    return 1;
+  }
+  return 0;
+}
+
+static int src_open(replay_src_t *s, const uint8_t *m, size_t size, uint16_t port) {
+  memset(s, 0, sizeof(*s));
+  s->cur = m;
+  s->end = m + size;
+  s->port = port;
+  if (size < 4) return 0;
+
+  uint32_t magic;
+  memcpy(&magic, m, sizeof(magic));
+  if (magic == PCAPNG_MAGIC) {
+    LOGE("replay: pcapng not supported, convert with: editcap -F pcap in.pcapng out.pcap");
+    return -1;
+  }
+  bool us = magic == PCAP_MAGIC_US || magic == __builtin_bswap32(PCAP_MAGIC_US);
+  bool ns = magic == PCAP_MAGIC_NS || magic == __builtin_bswap32(PCAP_MAGIC_NS);
+  if (!us && !ns) return 0;   // raw trace
+
+  if (size < 24) return -1;
+  s->pcap = true;
+  s->nsec = ns;
+  s->swapped = (magic == __builtin_bswap32(PCAP_MAGIC_US) || magic == __builtin_bswap32(PCAP_MAGIC_NS));
+  s->linktype = rd32(m + 20, s->swapped) & 0x0fffffffu;   // 상위 비트는 FCS 정보
+  s->cur = m + 24;
+  return 0;
+}
+
+static void snap_take(pipeline_t *p, replay_snap_t *s) {
+  s->rx = atomic_load(&g_stats->rx_datagrams);
+  for (int i = 0; i < STF_N; i++) {
+    s->pass[i] = atomic_load(&g_stats->filter[i].pass);
+    s->reject[i] = atomic_load(&g_stats->filter[i].reject);
+  }
+  s->reports = atomic_load(&g_stats->reports_sent);
+
+  memset(&s->q[STQ_WL1_RAW], 0, sizeof(s->q[0]));
+  for (int i = 0; i < p->n_wl1_workers; i++) {
+    bq_stats_t st;
+    bq_get_stats(&p->Q_wl1_raw[i], &st);
+    s->q[STQ_WL1_RAW].push_items += st.push_items;
+    s->q[STQ_WL1_RAW].pop_items += st.pop_items;
+    s->q[STQ_WL1_RAW].drops += st.drops;
+    s->q[STQ_WL1_RAW].depth += st.depth;
+  }
+  bq_get_stats(&p->Q_sm_events, &s->q[STQ_SM_EVENTS]);
+  bq_get_stats(&p->Q_tx_cmd, &s->q[STQ_TX_CMD]);
+  bq_get_stats(&p->Q_rsu3_in, &s->q[STQ_RSU3_IN]);
+  bq_get_stats(&p->Q_air, &s->q[STQ_AIR]);
+}
+
+// 유입 경로(샤드 큐 -> worker -> SM의 WL-1 이벤트 소비)가 50ms 동안 멈춰 있으면 끝난 것으로 봄
+// Q_air와 Q_sm_events의 타이머 이벤트(EV_BCAST_DUE/TICK)는 제외: active 사고가 많으면
+// 재전파가 계속 돌아 pop 수가 멈추지 않음. Q_tx_cmd도 제외 (서버가 없으면 재접속 때까지 남음)
+// 반환: false = 상한(REPLAY_DRAIN_MAX_MS)까지 안 빔
+static bool wait_drained(pipeline_t *p) {
+  uint64_t end = now_ns() + (uint64_t)REPLAY_DRAIN_MAX_MS * 1000000ull;
+  uint64_t last = UINT64_MAX;
+  int stable = 0;
+  while (now_ns() < end && stable < 5) {
+    replay_snap_t s;
+    snap_take(p, &s);
+    uint64_t prog = s.q[STQ_WL1_RAW].pop_items;
+    for (int i = STF_HEAVY; i < STF_N; i++) prog += s.pass[i] + s.reject[i];
+    stable = (s.q[STQ_WL1_RAW].depth == 0 && prog == last) ? stable + 1 : 0;
+    last = prog;
+    usleep(10000);
+  }
+  return stable >= 5;
+}
+
+static void sleep_until_ns(uint64_t t) {
+  struct timespec ts = { (time_t)(t / 1000000000ull), (long)(t % 1000000000ull) };
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+  }
+}
+
+int replay_run(pipeline_t *p, const char *path, double speed, volatile int *stop) {
+  if (p->cfg.runtime_mode == RUNTIME_EVLOOP) {
+    LOGE("replay: needs RSU_RUNTIME=threads");
+    return -1;
+  }
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    LOGE("replay: open %s failed (%s)", path, strerror(errno));
+    return -1;
+  }
+  struct stat sb;
+  if (fstat(fd, &sb) != 0 || sb.st_size <= 0) {
+    LOGE("replay: %s is empty", path);
+    close(fd);
+    return -1;
+  }
+  size_t size = (size_t)sb.st_size;
+  void *m = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (m == MAP_FAILED) {
+    LOGE("replay: mmap %s failed (%s)", path, strerror(errno));
+    return -1;
+  }
+  madvise(m, size, MADV_SEQUENTIAL);
+
+  replay_src_t src;
+  if (src_open(&src, (const uint8_t*)m, size, p->cfg.wl1_listen_port) != 0) {
+    munmap(m, size);
+    return -1;
+  }
+  if (!src.pcap && size % sizeof(wl1_packet_t)) {
+    LOGW("replay: %s is not a multiple of %zu bytes, trailing %zu ignored", path, sizeof(wl1_packet_t),
+         size % sizeof(wl1_packet_t));
+  }
+  const bool timed = src.pcap && speed > 0;
+  if (!src.pcap && speed > 0) LOGW("replay: raw trace has no timestamps, replaying at max speed");
+  LOGI("replay: %s (%s, %zu bytes) at %s", path,
+       src.pcap ? (src.nsec ? "pcap ns" : "pcap") : "raw 256B records", size,
+       timed ? "scaled capture time" : "max speed");
+
+  int batch = (int)p->cfg.wl1_rx_batch;
+  if (batch < 1) batch = 1;
+  if (batch > WL1_RX_BATCH_MAX) batch = WL1_RX_BATCH_MAX;
+
+  replay_snap_t before, after;
+  snap_take(p, &before);
+
+  const uint8_t *fr[WL1_RX_BATCH_MAX];
+  uint32_t ln[WL1_RX_BATCH_MAX];
+  int nb = 0;
+  uint64_t frames = 0, ts0 = 0;
+  const uint8_t *f;
+  uint32_t len;
+  uint64_t ts;
+
+  const uint64_t t0 = now_ns();
+  int have = src_next(&src, &f, &len, &ts);
+  if (have) ts0 = ts;
+  while (have && !*stop) {
+    if (timed) {
+      uint64_t due = t0 + (uint64_t)((double)(ts > ts0 ? ts - ts0 : 0) / speed);
+      if (due > now_ns()) {
+        if (nb) {
+          // 이미 모인 것은 제시각에 먼저 보냄
+          wireless_inject(&p->wireless, fr, ln, nb, NULL);
+          nb = 0;
+          continue;
+        }
+        sleep_until_ns(due);
+      }
+    }
+    fr[nb] = f;
+    ln[nb] = len;
+    frames++;
+    if (++nb == batch) {
+      wireless_inject(&p->wireless, fr, ln, nb, timed ? NULL : stop);
+      nb = 0;
+    }
+    have = src_next(&src, &f, &len, &ts);
+  }
+  if (nb) wireless_inject(&p->wireless, fr, ln, nb, timed ? NULL : stop);
+  const uint64_t t_inj = now_ns();
+
+  bool drained = !*stop && wait_drained(p);
+  if (!*stop && !drained) {
+    LOGW("replay: pipeline still busy after %d ms (wired backpressure? server reachable?)", REPLAY_DRAIN_MAX_MS);
+  }
+  const uint64_t t_done = now_ns();
+  snap_take(p, &after);
+  munmap(m, size);
+
+  double inj_s = (double)(t_inj - t0) / 1e9;
+  double all_s = (double)(t_done - t0) / 1e9;
+  uint64_t processed = (after.pass[STF_SM_DEDUP] - before.pass[STF_SM_DEDUP]) +
+                       (after.reject[STF_SM_DEDUP] - before.reject[STF_SM_DEDUP]);
+  LOGI("replay: %llu WL-1 frames (%llu other frames skipped) injected in %.3f s (%.0f frames/s)%s",
+       (unsigned long long)frames, (unsigned long long)src.skipped, inj_s, inj_s > 0 ? frames / inj_s : 0.0,
+       *stop ? " [interrupted]" : "");
+  LOGI("replay: pipeline %s after %.3f s -> %.0f frames/s end-to-end, %llu WL-1 events into SM",
+       drained ? "drained" : "stopped", all_s, all_s > 0 ? frames / all_s : 0.0, (unsigned long long)processed);
+
+  uint64_t sized = (after.pass[STF_LIGHT] - before.pass[STF_LIGHT]) +
+                   (after.reject[STF_LIGHT] - before.reject[STF_LIGHT]);
+  uint64_t rx = after.rx - before.rx;
+  LOGI("replay stage %-9s pass %10llu reject %10llu", "size", (unsigned long long)sized,
+       (unsigned long long)(rx > sized ? rx - sized : 0));
+  for (int i = 0; i < STF_N; i++) {
+    LOGI("replay stage %-9s pass %10llu reject %10llu", stats_filter_name(i),
+         (unsigned long long)(after.pass[i] - before.pass[i]),
+         (unsigned long long)(after.reject[i] - before.reject[i]));
+  }
+  for (int i = 0; i < STQ_N; i++) {
+    LOGI("replay queue %-12s push %10llu drops %10llu", stats_queue_name(i),
+         (unsigned long long)(after.q[i].push_items - before.q[i].push_items),
+         (unsigned long long)(after.q[i].drops - before.q[i].drops));
+  }
+  if (!p->cfg.replay_tx) {
+    // RSU_REPLAY_TX=1이 아니면 송신 없음: 재생으로 생긴 보고/브로드캐스트 수는 wired/wireless tx 요약의 discarded
+    LOGI("replay: server reports and RSU-1 broadcasts counted and discarded (RSU_REPLAY_TX=1 to send)");
+  } else {
+    LOGI("replay: %llu reports sent to server, %u still queued for wired (unsent/dropped: wired tx summary)",
+         (unsigned long long)(after.reports - before.reports), after.q[STQ_TX_CMD].depth);
+  }
+  return 0;
+}
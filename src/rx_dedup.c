@@ -0,0 +1,120 @@
+// app/rx_dedup.c
+#include "rx_dedup.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TICK_SHIFT  6
+#define TICK_MASK   0xffffull
+#define EPOCH_SHIFT 16
+#define FP_SHIFT    24
+
+static inline uint64_t mix64(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+static inline uint64_t key_hash(uint32_t sender_id, uint64_t accident_id) {
+  return mix64(accident_id ^ mix64((uint64_t)sender_id + 0x9e3779b97f4a7c15ull));
+}
+
+static inline uint32_t epoch_idx(uint64_t accident_id) {
+  return (uint32_t)mix64(accident_id) & (RX_DEDUP_EPOCHS - 1);
+}
+
+// fp는 0이 되지 않게 (빈 슬롯 = 0)
+static inline uint64_t key_fp(uint64_t h) {
+  uint64_t fp = h >> FP_SHIFT;
+  return fp ? fp : 1;
+}
+
+int rx_dedup_init(rx_dedup_t *d, uint32_t n_sets, uint32_t window_ms) {
+  memset(d, 0, sizeof(*d));
+  if (window_ms == 0) return 0;
+
+  uint32_t sets = 64;
+  while (sets < n_sets && sets < (1u << 24)) sets <<= 1;
+  d->slots = (_Atomic uint64_t*)calloc((size_t)sets * RX_DEDUP_WAYS, sizeof(uint64_t));
+  if (!d->slots) return -1;
+  d->set_mask = sets - 1;
+
+  uint32_t ticks = (window_ms + (1u << TICK_SHIFT) - 1) >> TICK_SHIFT;
+  if (ticks > TICK_MASK / 2) ticks = TICK_MASK / 2;
+  d->window_ticks = ticks;
+  return 0;
+}
+
+void rx_dedup_destroy(rx_dedup_t *d) {
+  if (!d) return;
+  free((void*)d->slots);
+  d->slots = NULL;
+}
+
+bool rx_dedup_seen(rx_dedup_t *d, uint32_t sender_id, uint64_t accident_id, uint64_t now_ms) {
+  if (!d || !d->slots) return false;
+  uint64_t h = key_hash(sender_id, accident_id);
+  uint64_t fp = key_fp(h);
+  uint64_t ep = atomic_load_explicit(&d->epoch[epoch_idx(accident_id)], memory_order_relaxed);
+  uint64_t now_t = (now_ms >> TICK_SHIFT) & TICK_MASK;
+
+  _Atomic uint64_t *set = &d->slots[(size_t)(h & d->set_mask) * RX_DEDUP_WAYS];
+  for (int i = 0; i < RX_DEDUP_WAYS; i++) {
+    uint64_t w = atomic_load_explicit(&set[i], memory_order_relaxed);
+    if ((w >> FP_SHIFT) != fp) continue;
+    if (((w >> EPOCH_SHIFT) & 0xff) != ep) continue;          // 해제 이전 등록분
+    if (((now_t - w) & TICK_MASK) > d->window_ticks) continue; // 창 지남
+    atomic_fetch_add_explicit(&d->suppressed, 1, memory_order_relaxed);
+    return true;
+  }
+  atomic_fetch_add_explicit(&d->passed, 1, memory_order_relaxed);
+  return false;
+}
+
+void rx_dedup_insert(rx_dedup_t *d, uint32_t sender_id, uint64_t accident_id, uint64_t now_ms) {
+  if (!d || !d->slots) return;
+  uint64_t h = key_hash(sender_id, accident_id);
+  uint64_t fp = key_fp(h);
+  uint64_t ep = atomic_load_explicit(&d->epoch[epoch_idx(accident_id)], memory_order_relaxed);
+  uint64_t now_t = (now_ms >> TICK_SHIFT) & TICK_MASK;
+  uint64_t word = (fp << FP_SHIFT) | (ep << EPOCH_SHIFT) | now_t;
+
+  // 같은 키 -> 갱신, 없으면 빈 칸 또는 가장 오래된 칸을 덮어씀
+  _Atomic uint64_t *set = &d->slots[(size_t)(h & d->set_mask) * RX_DEDUP_WAYS];
+  int same = -1, empty = -1, oldest = 0;
+  uint64_t oldest_age = 0;
+  for (int i = 0; i < RX_DEDUP_WAYS; i++) {
+    uint64_t w = atomic_load_explicit(&set[i], memory_order_relaxed);
+    if ((w >> FP_SHIFT) == fp) {
+      same = i;
+      break;
+    }
+    if (w == 0) {
+      if (empty < 0) empty = i;
+      continue;
+    }
+    uint64_t age = (now_t - w) & TICK_MASK;
+    if (age >= oldest_age) {
+      oldest_age = age;
+      oldest = i;
+    }
+  }
+  int victim = (same >= 0) ? same : (empty >= 0) ? empty : oldest;
+  atomic_store_explicit(&set[victim], word, memory_order_relaxed);
+  atomic_fetch_add_explicit(&d->inserted, 1, memory_order_relaxed);
+}
+
+void rx_dedup_forget(rx_dedup_t *d, uint64_t accident_id) {
+  if (!d || !d->slots) return;
+  atomic_fetch_add_explicit(&d->epoch[epoch_idx(accident_id)], 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&d->forgets, 1, memory_order_relaxed);
+}
+
+void rx_dedup_get_stats(rx_dedup_t *d, rx_dedup_stats_t *st) {
+  st->suppressed = atomic_load_explicit(&d->suppressed, memory_order_relaxed);
+  st->passed = atomic_load_explicit(&d->passed, memory_order_relaxed);
+  st->inserted = atomic_load_explicit(&d->inserted, memory_order_relaxed);
+  st->forgets = atomic_load_explicit(&d->forgets, memory_order_relaxed);
+}
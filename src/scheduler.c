@@ -5,33 +5,175 @@
 #include <string.h>
 #include <time.h>
 
-static void heap_swap(timer_item_t *a, timer_item_t *b){ timer_item_t t=*a;*a=*b;*b=t; }
-static void heap_up(timer_item_t *h, size_t idx) {
-  while (idx>0) {
-    size_t p=(idx-1)/2;
-    if (h[p].due_ms <= h[idx].due_ms) break;
-    heap_swap(&h[p], &h[idx]);
-    idx=p;
+/*
+ * Hierarchical timing wheel (Linux 구 timer wheel과 같은 구조)
+ * - level 0: base 기준 256 tick 이내, level n: 256^(n+1) tick 이내
+ * - base가 256 경계를 지날 때 상위 레벨 슬롯 하나를 하위로 cascade
+ * - 만료된 노드는 fire 리스트로 옮긴 뒤 스레드가 하나씩 잠금 없이 콜백 실행
+ */
+
+#define SLOT_MASK   (SCHED_SLOTS - 1u)
+#define FIRE_LIST   (SCHED_LEVELS * SCHED_SLOTS)
+#define MAX_DELTA   ((1ull << (SCHED_SLOT_BITS * SCHED_LEVELS)) - 1ull)
+
+enum { N_FREE = 0, N_PENDING, N_FIRING, N_CANCELLED };
+
+static inline sched_node_t* node_at(scheduler_t *s, uint32_t ref) { return &s->nodes[ref - 1]; }
+
+static inline void bm_set(scheduler_t *s, uint32_t list) {
+  s->occupied[list / SCHED_SLOTS][(list & SLOT_MASK) >> 6] |= 1ull << (list & 63);
+}
+static inline void bm_clear(scheduler_t *s, uint32_t list) {
+  s->occupied[list / SCHED_SLOTS][(list & SLOT_MASK) >> 6] &= ~(1ull << (list & 63));
+}
+
+// ---- 노드 할당 (idx+1 로 참조, 배열은 2배씩 grow) ----
+static int nodes_grow(scheduler_t *s) {
+  uint32_t n = s->n_nodes ? s->n_nodes * 2u : 64u;
+  if (n <= s->n_nodes) return -1;
+  sched_node_t *nn = (sched_node_t*)realloc(s->nodes, (size_t)n * sizeof(sched_node_t));
+  if (!nn) return -1;
+  memset(nn + s->n_nodes, 0, (size_t)(n - s->n_nodes) * sizeof(sched_node_t));
+  for (uint32_t i = n; i > s->n_nodes; i--) {
+    nn[i - 1].next = s->free_head;
+    s->free_head = i;
   }
+  s->nodes = nn;
+  s->n_nodes = n;
+  return 0;
 }
-static void heap_down(timer_item_t *h, size_t n, size_t idx) {
-  for (;;) {
-    size_t l=idx*2+1, r=idx*2+2, m=idx;
-    if (l<n && h[l].due_ms < h[m].due_ms) m=l;
-    if (r<n && h[r].due_ms < h[m].due_ms) m=r;
-    if (m==idx) break;
-    heap_swap(&h[m], &h[idx]);
-    idx=m;
+
+static uint32_t node_alloc(scheduler_t *s) {
+  if (!s->free_head && nodes_grow(s) != 0) return 0;
+  uint32_t ref = s->free_head;
+  s->free_head = node_at(s, ref)->next;
+  return ref;
+}
+
+static void node_free(scheduler_t *s, uint32_t ref) {
+  sched_node_t *n = node_at(s, ref);
+  n->state = N_FREE;
+  n->gen++;               // 이전 핸들 무효화
+  n->cb = NULL;
+  n->arg = NULL;
+  n->next = s->free_head;
+  s->free_head = ref;
+  s->size--;
+}
+
+// ---- 슬롯 리스트 ----
+static void list_push(scheduler_t *s, uint32_t list, uint32_t ref) {
+  sched_node_t *n = node_at(s, ref);
+  n->list = (uint16_t)list;
+  n->prev = 0;
+  n->next = s->heads[list];
+  if (n->next) node_at(s, n->next)->prev = ref;
+  s->heads[list] = ref;
+  if (list != FIRE_LIST) bm_set(s, list);
+}
+
+static void list_unlink(scheduler_t *s, uint32_t ref) {
+  sched_node_t *n = node_at(s, ref);
+  if (n->prev) node_at(s, n->prev)->next = n->next;
+  else s->heads[n->list] = n->next;
+  if (n->next) node_at(s, n->next)->prev = n->prev;
+  if (!s->heads[n->list] && n->list != FIRE_LIST) bm_clear(s, n->list);
+  n->next = n->prev = 0;
+}
+
+// base 기준으로 레벨/슬롯 결정 (지난 시각은 바로 다음 tick)
+static void wheel_insert(scheduler_t *s, uint32_t ref) {
+  sched_node_t *n = node_at(s, ref);
+  uint64_t e = n->expires;
+  if (e < s->base) e = s->base;
+  uint64_t delta = e - s->base;
+  if (delta > MAX_DELTA) e = s->base + MAX_DELTA; // 범위 밖은 최상위에 두고 cascade 때 재배치
+
+  uint32_t lvl = 0;
+  while (lvl + 1 < SCHED_LEVELS && delta >= (1ull << (SCHED_SLOT_BITS * (lvl + 1)))) lvl++;
+  uint32_t slot = (uint32_t)(e >> (SCHED_SLOT_BITS * lvl)) & SLOT_MASK;
+  list_push(s, lvl * SCHED_SLOTS + slot, ref);
+}
+
+static void cascade(scheduler_t *s, uint32_t lvl, uint32_t slot) {
+  uint32_t list = lvl * SCHED_SLOTS + slot;
+  uint32_t ref = s->heads[list];
+  s->heads[list] = 0;
+  bm_clear(s, list);
+  while (ref) {
+    uint32_t next = node_at(s, ref)->next;
+    wheel_insert(s, ref);
+    ref = next;
+  }
+}
+
+// level 0의 from 이후 첫 비어있지 않은 슬롯 (없으면 SCHED_SLOTS)
+static uint32_t l0_next_set(const scheduler_t *s, uint32_t from) {
+  for (uint32_t w = from >> 6; w < SCHED_SLOTS / 64; w++) {
+    uint64_t bits = s->occupied[0][w];
+    if (w == (from >> 6)) bits &= ~0ull << (from & 63);
+    if (bits) return (w << 6) + (uint32_t)__builtin_ctzll(bits);
   }
+  return SCHED_SLOTS;
+}
+
+// now 까지 base를 진행시키며 만료 노드를 fire 리스트로 이동
+static void wheel_advance(scheduler_t *s, uint64_t now) {
+  while (s->base <= now) {
+    uint32_t idx = (uint32_t)s->base & SLOT_MASK;
+    if (idx == 0) {
+      for (uint32_t lvl = 1; lvl < SCHED_LEVELS; lvl++) {
+        uint32_t slot = (uint32_t)(s->base >> (SCHED_SLOT_BITS * lvl)) & SLOT_MASK;
+        cascade(s, lvl, slot);
+        if (slot != 0) break;
+      }
+    }
+
+    uint32_t ref = s->heads[idx];
+    if (ref) {
+      s->heads[idx] = 0;
+      bm_clear(s, idx);
+      while (ref) {
+        uint32_t next = node_at(s, ref)->next;
+        list_push(s, FIRE_LIST, ref);
+        ref = next;
+      }
+    }
+
+    // 빈 슬롯은 건너뜀 (다음 256 경계는 넘지 않음 -> cascade 누락 없음)
+    uint32_t nx = l0_next_set(s, idx + 1);
+    uint64_t target = s->base - idx + nx;
+    s->base = (target <= now) ? target : now + 1;
+  }
+}
+
+// 다음으로 깨어나야 할 tick. level 0이 비었으면 다음 cascade 경계
+static uint64_t wheel_next_due(const scheduler_t *s) {
+  uint32_t idx = (uint32_t)s->base & SLOT_MASK;
+  if (idx == 0) return s->base; // 경계 tick 자체가 아직 cascade 전
+  uint32_t nx = l0_next_set(s, idx);
+  return s->base - idx + nx;
+}
+
+static void abs_monotonic(struct timespec *ts, uint64_t due_ms) {
+  ts->tv_sec = (time_t)(due_ms / 1000ull);
+  ts->tv_nsec = (long)((due_ms % 1000ull) * 1000000ull);
 }
 
 int scheduler_init(scheduler_t *s, size_t cap) {
   memset(s, 0, sizeof(*s));
-  s->heap = (timer_item_t*)calloc(cap, sizeof(timer_item_t));
-  if (!s->heap) return -1;
-  s->cap = cap;
+  s->base = now_ms_monotonic();
+  s->wake_at = UINT64_MAX;
+  while ((size_t)s->n_nodes < cap) {
+    if (nodes_grow(s) != 0) return -1;
+  }
+
+  pthread_condattr_t ca;
+  pthread_condattr_init(&ca);
+  pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
   pthread_mutex_init(&s->mtx, NULL);
-  pthread_cond_init(&s->cv, NULL);
+  pthread_cond_init(&s->cv, &ca);
+  pthread_condattr_destroy(&ca);
   return 0;
 }
 
@@ -43,55 +185,128 @@ void scheduler_stop(scheduler_t *s) {
 }
 
 void scheduler_destroy(scheduler_t *s) {
-  free(s->heap);
+  free(s->nodes);
+  s->nodes = NULL;
   pthread_mutex_destroy(&s->mtx);
   pthread_cond_destroy(&s->cv);
 }
 
-bool scheduler_add(scheduler_t *s, uint64_t due_ms, timer_cb_t cb, void *arg) {
+sched_timer_id_t scheduler_add_timer(scheduler_t *s, uint64_t due_ms, uint64_t period_ms,
+                                     timer_cb_t cb, void *arg) {
   pthread_mutex_lock(&s->mtx);
-  if (s->size == s->cap) { pthread_mutex_unlock(&s->mtx); return false; }
+  uint32_t ref = node_alloc(s);
+  if (!ref) { pthread_mutex_unlock(&s->mtx); return 0; }
 
-  bool wake = (s->size == 0) || (due_ms < s->heap[0].due_ms);
-  s->heap[s->size] = (timer_item_t){ .due_ms=due_ms, .cb=cb, .arg=arg };
-  heap_up(s->heap, s->size);
+  sched_node_t *n = node_at(s, ref);
+  n->expires = due_ms;
+  n->period = period_ms;
+  n->cb = cb;
+  n->arg = arg;
+  n->state = N_PENDING;
   s->size++;
-  if (wake) pthread_cond_signal(&s->cv);
+  wheel_insert(s, ref);
+
+  sched_timer_id_t id = ((uint64_t)n->gen << 32) | ref;
+  if (due_ms < s->wake_at) pthread_cond_signal(&s->cv);
   pthread_mutex_unlock(&s->mtx);
-  return true;
+  return id;
 }
 
-void* scheduler_thread(void *arg) {
-  scheduler_t *s = (scheduler_t*)arg;
+bool scheduler_add(scheduler_t *s, uint64_t due_ms, timer_cb_t cb, void *arg) {
+  return scheduler_add_timer(s, due_ms, 0, cb, arg) != 0;
+}
 
+bool scheduler_cancel(scheduler_t *s, sched_timer_id_t id) {
+  uint32_t ref = (uint32_t)id;
+  uint32_t gen = (uint32_t)(id >> 32);
+  bool ok = false;
+
+  pthread_mutex_lock(&s->mtx);
+  if (ref && ref <= s->n_nodes) {
+    sched_node_t *n = node_at(s, ref);
+    if (n->gen == gen) {
+      if (n->state == N_PENDING) {
+        list_unlink(s, ref);
+        node_free(s, ref);
+        ok = true;
+      } else if (n->state == N_FIRING) {
+        n->state = N_CANCELLED; // 콜백 종료 후 재등록하지 않고 해제
+        ok = true;
+      }
+    }
+  }
+  pthread_mutex_unlock(&s->mtx);
+  return ok;
+}
+
+size_t scheduler_pending(scheduler_t *s) {
+  pthread_mutex_lock(&s->mtx);
+  size_t n = s->size;
+  pthread_mutex_unlock(&s->mtx);
+  return n;
+}
+
+// 만료된 타이머를 모두 실행 (mtx 잡은 상태로 호출, 콜백 동안만 풀림)
+// 반환: 다음으로 깨어나야 할 tick (UINT64_MAX = 대기 중인 타이머 없음)
+static uint64_t run_due_locked(scheduler_t *s) {
   for (;;) {
+    uint64_t now = now_ms_monotonic();
+    if (s->size == 0) s->base = now + 1;  // 비어있으면 빈 tick을 돌 필요 없음
+    else wheel_advance(s, now);
+
+    uint32_t ref = s->heads[FIRE_LIST];
+    if (!ref) break;
+    list_unlink(s, ref);
+    sched_node_t *n = node_at(s, ref);
+    n->state = N_FIRING;
+    timer_cb_t cb = n->cb;
+    void *cb_arg = n->arg;
+    pthread_mutex_unlock(&s->mtx);
+
+    if (cb) cb(cb_arg);
+
     pthread_mutex_lock(&s->mtx);
-    while (!s->stop && s->size == 0) {
-      pthread_cond_wait(&s->cv, &s->mtx);
+    n = node_at(s, ref); // 콜백 중 add로 배열이 realloc 되었을 수 있음
+    if (n->state == N_FIRING && n->period) {
+      // 위상 유지, 밀린 주기는 건너뜀
+      uint64_t e = n->expires + n->period;
+      if (e < s->base) e += ((s->base - e) / n->period + 1) * n->period;
+      n->expires = e;
+      n->state = N_PENDING;
+      wheel_insert(s, ref);
+    } else {
+      node_free(s, ref);
     }
-    if (s->stop) { pthread_mutex_unlock(&s->mtx); break; }
+  }
+  return s->size ? wheel_next_due(s) : UINT64_MAX;
+}
 
-    uint64_t now = now_ms_monotonic();
-    timer_item_t top = s->heap[0];
+uint64_t scheduler_run_due(scheduler_t *s) {
+  pthread_mutex_lock(&s->mtx);
+  uint64_t next = run_due_locked(s);
+  pthread_mutex_unlock(&s->mtx);
+  return next;
+}
 
-    if (top.due_ms > now) {
-      uint64_t wait_ms = top.due_ms - now;
+void* scheduler_thread(void *arg) {
+  scheduler_t *s = (scheduler_t*)arg;
+
+  pthread_mutex_lock(&s->mtx);
+  while (!s->stop) {
+    uint64_t next = run_due_locked(s);
+    if (s->stop) break;
+
+    if (next == UINT64_MAX) {
+      s->wake_at = UINT64_MAX;
+      pthread_cond_wait(&s->cv, &s->mtx);
+    } else {
+      s->wake_at = next;
       struct timespec ts;
-      clock_gettime(CLOCK_REALTIME, &ts);
-      uint64_t nsec = (uint64_t)ts.tv_nsec + wait_ms * 1000000ull;
-      ts.tv_sec += (time_t)(nsec / 1000000000ull);
-      ts.tv_nsec = (long)(nsec % 1000000000ull);
+      abs_monotonic(&ts, s->wake_at);
       pthread_cond_timedwait(&s->cv, &s->mtx, &ts);
-      pthread_mutex_unlock(&s->mtx);
-      continue;
     }
-
-    s->heap[0] = s->heap[s->size - 1];
-    s->size--;
-    heap_down(s->heap, s->size, 0);
-    pthread_mutex_unlock(&s->mtx);
-
-    if (top.cb) top.cb(top.arg);
+    s->wake_at = UINT64_MAX;
   }
+  pthread_mutex_unlock(&s->mtx);
   return NULL;
 }
@@ -1,9 +1,136 @@
 #include "security.h"
+#include <stdatomic.h>
 #include <string.h>
+#include <time.h>
+
+static uint32_t g_stub_verify_ns = 0;
+
+void sec_set_stub_verify_cost_ns(uint32_t ns) {
+    g_stub_verify_ns = ns;
+}
+
+static void stub_burn_ns(uint32_t ns) {
+    struct timespec t0, t;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &t);
+    } while ((uint64_t)(t.tv_sec - t0.tv_sec) * 1000000000ull + (uint64_t)t.tv_nsec - (uint64_t)t0.tv_nsec < ns);
+}
+
+// ---- 검증 결과 캐시 ----
+// direct-mapped, 슬롯마다 seqlock (홀수 = 쓰는 중, 0 = 빈 슬롯)
+// 읽기는 잠금 없이 seq 전후 비교, 쓰기는 CAS로 슬롯을 잡지 못하면 기록을 포기
+#ifndef SEC_VCACHE_SLOTS
+#define SEC_VCACHE_SLOTS 4096   // 2의 거듭제곱, 슬롯당 ~272B
+#endif
+
+typedef struct {
+    _Atomic uint32_t seq;
+    uint8_t ok;
+    uint64_t digest;
+    wl1_packet_t pkt;
+} vcache_slot_t;
+
+static vcache_slot_t g_vcache[SEC_VCACHE_SLOTS];
+static _Atomic bool g_vcache_on = true;
+
+// 통계는 워커 간 공유 -> 캐시라인 분리
+static struct {
+    _Alignas(64) _Atomic uint64_t hits;
+    _Alignas(64) _Atomic uint64_t misses;
+    _Alignas(64) _Atomic uint64_t evictions;
+    _Atomic uint64_t busy_skips;
+} g_vstat;
+
+static uint64_t pkt_digest(const wl1_packet_t *pkt) {
+    const uint8_t *p = (const uint8_t*)pkt;
+    uint64_t h = 0x243f6a8885a308d3ull;
+    for (size_t i = 0; i + 8 <= sizeof(*pkt); i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, sizeof(w));
+        h = (h ^ w) * 0x9e3779b97f4a7c15ull;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+// 적중하면 true + *ok에 이전 검증 결과
+static bool vcache_lookup(uint64_t d, const wl1_packet_t *pkt, bool *ok) {
+    vcache_slot_t *e = &g_vcache[d & (SEC_VCACHE_SLOTS - 1)];
+    uint32_t s1 = atomic_load_explicit(&e->seq, memory_order_acquire);
+    if (s1 == 0 || (s1 & 1u)) return false;
+    if (e->digest != d) return false;
+
+    bool same = memcmp(&e->pkt, pkt, sizeof(*pkt)) == 0;
+    bool res = e->ok != 0;
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&e->seq, memory_order_relaxed) != s1) return false; // 읽는 중 덮어써짐
+    if (!same) return false;
+    *ok = res;
+    return true;
+}
+
+static void vcache_store(uint64_t d, const wl1_packet_t *pkt, bool ok) {
+    vcache_slot_t *e = &g_vcache[d & (SEC_VCACHE_SLOTS - 1)];
+    uint32_t s = atomic_load_explicit(&e->seq, memory_order_relaxed);
+    if ((s & 1u) ||
+        !atomic_compare_exchange_strong_explicit(&e->seq, &s, s + 1, memory_order_acquire,
+                                                 memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&g_vstat.busy_skips, 1, memory_order_relaxed);
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+    if (s != 0 && e->digest != d) atomic_fetch_add_explicit(&g_vstat.evictions, 1, memory_order_relaxed);
+    e->digest = d;
+    e->ok = ok ? 1 : 0;
+    memcpy(&e->pkt, pkt, sizeof(*pkt));
+    atomic_store_explicit(&e->seq, s + 2, memory_order_release);
+}
+
+void sec_vcache_set_enabled(bool on) {
+    atomic_store_explicit(&g_vcache_on, on, memory_order_relaxed);
+}
+
+void sec_vcache_reset(void) {
+    memset(g_vcache, 0, sizeof(g_vcache));
+    atomic_store(&g_vstat.hits, 0);
+    atomic_store(&g_vstat.misses, 0);
+    atomic_store(&g_vstat.evictions, 0);
+    atomic_store(&g_vstat.busy_skips, 0);
+}
+
+void sec_vcache_get_stats(sec_vcache_stats_t *st) {
+    st->hits = atomic_load_explicit(&g_vstat.hits, memory_order_relaxed);
+    st->misses = atomic_load_explicit(&g_vstat.misses, memory_order_relaxed);
+    st->evictions = atomic_load_explicit(&g_vstat.evictions, memory_order_relaxed);
+    st->busy_skips = atomic_load_explicit(&g_vstat.busy_skips, memory_order_relaxed);
+}
+
+// 실제 서명 검증 (현재는 스텁: 항상 통과, 비용만 에뮬레이션)
+static bool verify_signature(const wl1_packet_t *pkt) {
+    (void)pkt;
+    if (g_stub_verify_ns) stub_burn_ns(g_stub_verify_ns);
+    return true;
+}
 
 bool sec_wireless_rx_strip(const wl1_packet_t *pkt, wl1_payload_t *out_payload) {
     if (!pkt || !out_payload) return false;
-    // 서명 검증 로직(생략) -> Pass
+
+    bool ok;
+    if (atomic_load_explicit(&g_vcache_on, memory_order_relaxed)) {
+        uint64_t d = pkt_digest(pkt);
+        if (vcache_lookup(d, pkt, &ok)) {
+            atomic_fetch_add_explicit(&g_vstat.hits, 1, memory_order_relaxed);
+        } else {
+            atomic_fetch_add_explicit(&g_vstat.misses, 1, memory_order_relaxed);
+            ok = verify_signature(pkt);
+            vcache_store(d, pkt, ok);
+        }
+    } else {
+        ok = verify_signature(pkt);
+    }
+    if (!ok) return false;
+
     memcpy(out_payload, &pkt->payload, sizeof(wl1_payload_t));
     return true;
 }
@@ -16,6 +143,12 @@ bool sec_wireless_tx_wrap(const wl1_payload_t *in_payload, wl1_packet_t *out_pkt
     return true;
 }
 
+bool sec_wireless_tx_refresh(wl1_packet_t *pkt) {
+    if (!pkt) return false;
+    // 더미 서명은 payload와 무관 -> 갱신할 것 없음 (실제 서명이 붙으면 여기서 재서명)
+    return true;
+}
+
 bool sec_wired_rx_strip(const rsu3_packet_t *pkt, rsu3_payload_t *out_payload) {
     if (!pkt || !out_payload) return false;
     // 토큰 검증 로직(생략) -> Pass
@@ -9,176 +9,293 @@
 #include "timeutil.h"
 #include "packet.h"
 #include "security.h" 
+#include "pools.h"
+#include "acc_table.h"
+#include "bcast_frame.h"
+#include "trace.h"
+#include "stats_shm.h"
 
-// ---- 사고 테이블 ----
-typedef struct {
-  uint64_t accident_id;     
-  bool active;
-  uint64_t expire_ms;
-  rsu3_payload_t last_rsu3; 
-} acc_ent_t;
-
-// ---- 2초 tick 이벤트 ----
-static void post_tick_event(void *arg) {
-  bq_t *q = (bq_t*)arg;
-  sm_event_t *ev = (sm_event_t*)calloc(1, sizeof(*ev));
+// ---- 타이머 이벤트 (scheduler 스레드 -> SM 이벤트 큐) ----
+static void post_timer_event(bq_t *q, sm_event_type_t type) {
+  sm_event_t *ev = (sm_event_t*)mempool_alloc(&g_pools.sm_ev);
   if (!ev) return;
-  ev->type = EV_TIMER_TICK;
-  (void)bq_push(q, ev);
+  ev->type = type;
+  if (!bq_push(q, ev)) mempool_free(&g_pools.sm_ev, ev);
 }
 
-static void schedule_next_2s(scheduler_t *sched, bq_t *evq) {
-  (void)scheduler_add(sched, now_ms_monotonic() + 2000, post_tick_event, evq);
-}
+static void post_tick_event(void *arg)  { post_timer_event((bq_t*)arg, EV_TIMER_TICK); }
+static void post_bcast_event(void *arg) { post_timer_event((bq_t*)arg, EV_BCAST_DUE); }
 
-static void* sm_thread(void *arg) {
-  state_manager_t *sm = (state_manager_t*)arg;
-  sm->running = true;
+#ifndef SM_TICK_MS
+#define SM_TICK_MS 2000         // LED 동기화 안전장치 주기
+#endif
+#ifndef SM_BCAST_PERIOD_MS
+#define SM_BCAST_PERIOD_MS 2000 // 사고별 재전파 주기
+#endif
+#ifndef SM_BCAST_SLACK_MS
+#define SM_BCAST_SLACK_MS 10    // 깨우기 시각을 이 단위로 올림 (근접한 마감끼리 묶음)
+#endif
 
-  acc_ent_t table[256];
-  memset(table, 0, sizeof(table));
-  int n = 0;
+// 사고별 위상: 같은 시각에 확정된 사고들도 주기 안에 고르게 퍼지도록
+static uint64_t bcast_phase(uint64_t accident_id) {
+  accident_id ^= accident_id >> 33;
+  accident_id *= 0xc4ceb9fe1a85ec53ull;
+  accident_id ^= accident_id >> 33;
+  return accident_id % SM_BCAST_PERIOD_MS;
+}
 
-  schedule_next_2s(sm->sched, sm->in_ev_q);
+// 위상 유지, 밀린 주기는 건너뜀
+static uint64_t bcast_next(uint64_t due, uint64_t now) {
+  due += SM_BCAST_PERIOD_MS;
+  if (due <= now) due += ((now - due) / SM_BCAST_PERIOD_MS + 1) * SM_BCAST_PERIOD_MS;
+  return due;
+}
 
-  while (sm->running) {
-    sm_event_t *ev = (sm_event_t*)bq_pop(sm->in_ev_q);
-    if (!ev) break;
+static void sm_flush_tx_cmd(state_manager_t *sm, sm_out_t *out) {
+  uint64_t now = trace_now_if();
+  if (now) {
+    for (int i = 0; i < out->n_tx_cmd; i++) {
+      trace_stamp(&((tx_cmd_wired_t*)out->tx_cmd[i])->trace, TR_SM_DONE, now);
+    }
+  }
+  int pushed = bq_push_many(sm->to_tx_cmd_q, out->tx_cmd, out->n_tx_cmd);
+  for (int i = pushed; i < out->n_tx_cmd; i++) {
+    tx_cmd_wired_t *cmd = (tx_cmd_wired_t*)out->tx_cmd[i];
+    mempool_free(&g_pools.rsu2p, cmd->rsu2p);
+    mempool_free(&g_pools.tx_cmd, cmd);
+  }
+  out->n_tx_cmd = 0;
+}
 
-    uint64_t now = now_ms_monotonic();
+static void sm_flush_air(state_manager_t *sm, sm_out_t *out) {
+  int pushed = bq_push_many(sm->to_air_q, out->air, out->n_air);
+  for (int i = pushed; i < out->n_air; i++) bcast_frame_put((bcast_frame_t*)out->air[i]);
+  out->n_air = 0;
+}
 
-    // 1. [WL-1 수신] 차량 사고 보고 -> LED 즉시 점등
-    if (ev->type == EV_WL1_RX) {
-      rsu2_payload_t *p = ev->u.rsu2p;
+static void sm_emit_tx_cmd(state_manager_t *sm, sm_out_t *out, tx_cmd_wired_t *cmd) {
+  out->tx_cmd[out->n_tx_cmd++] = cmd;
+  if (out->n_tx_cmd == SM_BATCH_MAX) sm_flush_tx_cmd(sm, out);
+}
 
-      // (1) 중복 검색
-      int idx = -1;
-      for (int i = 0; i < n; i++) {
-        if (table[i].accident_id == p->accident.accident_id) { 
-            idx = i; 
-            break; 
-        }
-      }
+static void sm_emit_air(state_manager_t *sm, sm_out_t *out, bcast_frame_t *f) {
+  out->air[out->n_air++] = f;
+  if (out->n_air == SM_BATCH_MAX) sm_flush_air(sm, out);
+}
 
-      // (2) 이미 알고 있는 Active 사고 -> 무시
-      if (idx >= 0 && table[idx].active) {
-          free(p); 
-          // [LOG] 중복이라 무시됨 (디버깅용)
-          // LOGD("Duplicate accident ignored locally");
-      } 
-      // (3) 새로운 사고 -> 등록 & LED ON & 서버 전송
-      else {
-          if (idx < 0 && n < 256) {
-              idx = n++;
-              table[idx].accident_id = p->accident.accident_id;
-          }
-          
-          if (idx >= 0) {
-              table[idx].active = true;
-              table[idx].expire_ms = UINT64_MAX; // 영구 유지
-              
-              if (sm->led) {
-                  led_set(sm->led, true);
-                  LOGI("!! EMERGENCY !! Accident Detected -> LED ON");
-              }
-          }
-
-          // 서버 전송
-          tx_cmd_wired_t *cmd = (tx_cmd_wired_t*)calloc(1, sizeof(*cmd)); 
-          if (cmd) {
-            cmd->rsu2p = p; 
-            (void)bq_push(sm->to_tx_cmd_q, cmd);
-            LOGI("New accident reported to server (ID: %llx)", (long long)p->accident.accident_id);
-          } else {
-            free(p);
-          }
-      }
+// 사고 i의 재전파 프레임: 캐시가 있으면 send_time만 고치고, 없으면 직렬화+wrap 후 캐시
+static bcast_frame_t* sm_bcast_frame(acc_table_t *t, int i, uint64_t now) {
+  bcast_frame_t *f = t->frame[i];
+  if (!f) {
+    wl1_payload_t wl1p;
+    if (!packet_rsu3_to_wl1(&t->cold[i], &wl1p)) return NULL;
+    f = bcast_frame_new();
+    if (!f) return NULL;
+    if (!sec_wireless_tx_wrap(&wl1p, &f->pkt)) {
+      bcast_frame_put(f);
+      return NULL;
     }
-    // 2. [서버(RSU-3) 수신] -> 상태 동기화
-    else if (ev->type == EV_RSU3_RX) {
-      rsu3_payload_t *r = ev->u.rsu3p;
+    t->frame[i] = f;
+    return f;
+  }
 
-      int idx = -1;
-      for (int i = 0; i < n; i++) {
-        if (table[i].accident_id == r->accident.accident_id) { idx = i; break; }
-      }
-      
-      // 혹시 서버가 먼저 알려준 경우 등록
-      if (idx < 0 && n < 256) {
-        idx = n++;
-        table[idx].accident_id = r->accident.accident_id;
-      }
+  // 이전 송신분을 TX가 아직 들고 있으면 복사본을 새 캐시로 (copy-on-write)
+  if (bcast_frame_shared(f)) {
+    bcast_frame_t *nf = bcast_frame_new();
+    if (!nf) return NULL;
+    nf->pkt = f->pkt;
+    acc_table_drop_frame(t, i);
+    t->frame[i] = f = nf;
+  }
 
-      if (idx >= 0) {
-        // [수정된 부분] 서버 Protocol: 0x0000(0) == ON, 0xFFFF == OFF
-        bool is_alarm_on = (r->server_info.acc_flag == 0);
-
-        // 상태 업데이트
-        table[idx].active = is_alarm_on;
-        table[idx].expire_ms = UINT64_MAX; 
-        table[idx].last_rsu3 = *r;          
-
-        // 전체 테이블 검사 후 LED 갱신
-        if (sm->led) {
-          bool any_active = false;
-          for (int i = 0; i < n; i++) {
-              if (table[i].active) { 
-                  any_active = true; 
-                  break; 
-              }
-          }
-          (void)led_set(sm->led, any_active);
-          
-          if (is_alarm_on) {
-            LOGI("Server Confirmed ON (Ack) -> LED Keeping ON");
-          } else {
-            LOGI("Server Command OFF -> LED OFF");
-          }
-        }
-      }
-      free(r);
+  f->pkt.payload.sender.send_time = now;
+  if (!sec_wireless_tx_refresh(&f->pkt)) {
+    acc_table_drop_frame(t, i);
+    return NULL;
+  }
+  return f;
+}
+
+// 마감 지난 사고들을 전파하고 다음 주기로 재예약
+static void sm_bcast_due(state_manager_t *sm, acc_table_t *t, sm_out_t *out, uint64_t now) {
+  uint64_t due;
+  int i;
+  while ((i = acc_table_pop_due(t, now, &due)) >= 0) {
+    if (!t->hot[i].active || t->cold[i].rsu_id == 0) continue;
+
+    if (acc_table_schedule(t, i, bcast_next(due, now)) != 0) {
+      LOGW("broadcast schedule failed (ID: %llx)", (long long)t->hot[i].accident_id);
     }
-    // 3. [2초 타이머] -> 주기적 전파
-    else if (ev->type == EV_TIMER_TICK) {
-      bool any_active = false;
-      for (int i = 0; i < n; i++) {
-        if (!table[i].active) continue;
-        any_active = true;
 
-        if (table[i].last_rsu3.rsu_id == 0) continue; 
+    bcast_frame_t *f = sm_bcast_frame(t, i, now);
+    if (!f) continue;
+    bcast_frame_get(f);   // Q_air 몫
+    sm_emit_air(sm, out, f);
+  }
+}
 
-        wl1_payload_t wl1p;
-        if (!packet_rsu3_to_wl1(&table[i].last_rsu3, &wl1p)) continue;
+static void sm_handle_event(state_manager_t *sm, acc_table_t *t, sm_event_t *ev, sm_out_t *out) {
+  // 1. [WL-1 수신] 차량 사고 보고 -> LED 즉시 점등
+  if (ev->type == EV_WL1_RX) {
+    rsu2_payload_t *p = ev->u.rsu2p;
 
-        wl1_packet_t *pkt = (wl1_packet_t*)calloc(1, sizeof(wl1_packet_t));
-        if (!pkt) continue;
+    // (1) 중복 검색
+    int idx = acc_table_find(t, p->accident.accident_id);
 
-        if (!sec_wireless_tx_wrap(&wl1p, pkt)) {
-            free(pkt);
-            continue;
+    // (2) 이미 알고 있는 Active 사고 -> 무시
+    if (idx >= 0 && t->hot[idx].active) {
+        out->n_dup++;
+        mempool_free(&g_pools.rsu2p, p);
+        // [LOG] 중복이라 무시됨 (디버깅용)
+        // LOGD("Duplicate accident ignored locally");
+    } 
+    // (3) 새로운 사고 -> 등록 & LED ON & 서버 전송
+    else {
+        out->n_new++;
+        if (idx < 0) {
+            idx = acc_table_insert(t, p->accident.accident_id);
+            if (idx < 0) LOGW("accident table full (%u entries)", t->count);
+        }
+        
+        if (idx >= 0) {
+            acc_table_set_active(t, idx, true);
+            t->hot[idx].expire_ms = UINT64_MAX; // 영구 유지
+            
+            if (sm->led) {
+                led_set(sm->led, true);
+                LOGI("!! EMERGENCY !! Accident Detected -> LED ON");
+            }
+        }
+
+        // 서버 전송
+        tx_cmd_wired_t *cmd = (tx_cmd_wired_t*)mempool_alloc(&g_pools.tx_cmd);
+        if (cmd) {
+          cmd->rsu2p = p; 
+          cmd->trace = ev->trace;
+          LOGI("New accident reported to server (ID: %llx)", (long long)p->accident.accident_id);
+          sm_emit_tx_cmd(sm, out, cmd);
+        } else {
+          mempool_free(&g_pools.rsu2p, p);
+        }
+    }
+  }
+  // 2. [서버(RSU-3) 수신] -> 상태 동기화
+  else if (ev->type == EV_RSU3_RX) {
+    rsu3_payload_t *r = ev->u.rsu3p;
+
+    // [수정된 부분] 서버 Protocol: 0x0000(0) == ON, 0xFFFF == OFF
+    bool is_alarm_on = (r->server_info.acc_flag == 0);
+
+    if (is_alarm_on) {
+      // 혹시 서버가 먼저 알려준 경우 등록
+      int idx = acc_table_insert(t, r->accident.accident_id);
+      if (idx >= 0) {
+        acc_table_set_active(t, idx, true);
+        t->hot[idx].expire_ms = UINT64_MAX; 
+        if (memcmp(&t->cold[idx], r, sizeof(*r)) != 0) {
+          acc_table_drop_frame(t, idx); // 내용이 바뀐 경우만 프레임 재생성
+          t->cold[idx] = *r;
         }
-        (void)bq_push(sm->to_air_q, pkt);
+        // 처음 확정된 사고만 예약 (이후 ON 갱신은 기존 주기 유지)
+        if (t->hot[idx].bcast_due == 0 &&
+            acc_table_schedule(t, idx, now_ms_monotonic() + bcast_phase(r->accident.accident_id)) != 0) {
+          LOGW("broadcast schedule failed (ID: %llx)", (long long)r->accident.accident_id);
+        }
+      } else {
+        LOGW("accident table full (%u entries)", t->count);
       }
+    } else {
+      // 해제된 사고는 테이블에서 제거 (다시 보고되면 새 사고로 등록)
+      acc_table_remove(t, acc_table_find(t, r->accident.accident_id));
+      rx_dedup_forget(sm->dedup, r->accident.accident_id);
+    }
 
-      schedule_next_2s(sm->sched, sm->in_ev_q);
+    // LED 갱신 (active 개수는 증분 관리)
+    if (sm->led) {
+      (void)led_set(sm->led, t->active_count > 0);
       
-      // LED 상태 강제 동기화 (안전장치)
-      if (sm->led) (void)led_set(sm->led, any_active);
+      if (is_alarm_on) {
+        LOGI("Server Confirmed ON (Ack) -> LED Keeping ON");
+      } else {
+        LOGI("Server Command OFF -> LED OFF");
+      }
     }
+    mempool_free(&g_pools.rsu3p, r);
+  }
+  // 3. [재전파 마감] -> 마감이 지난 사고만 전파
+  else if (ev->type == EV_BCAST_DUE) {
+    sm->bcast_armed_ms = UINT64_MAX; // 이 타이머는 소진됨
+    sm_bcast_due(sm, t, out, now_ms_monotonic());
+  }
+  // 4. [2초 타이머] -> 놓친 마감 처리 + LED 상태 강제 동기화 (안전장치)
+  else if (ev->type == EV_TIMER_TICK) {
+    sm_bcast_due(sm, t, out, now_ms_monotonic());
+    if (sm->led) (void)led_set(sm->led, t->active_count > 0);
+  }
+}
+
+// 가장 이른 마감에 맞춰 1회성 타이머 (이미 더 이른 타이머가 있으면 그대로)
+static void sm_arm_bcast(state_manager_t *sm, acc_table_t *t) {
+  uint64_t due = acc_table_next_due(t);
+  if (due == UINT64_MAX) return;
+  due = (due + SM_BCAST_SLACK_MS - 1) / SM_BCAST_SLACK_MS * SM_BCAST_SLACK_MS;
+  if (due >= sm->bcast_armed_ms) return;
 
-    free(ev);
+  if (sm->bcast_timer) scheduler_cancel(sm->sched, sm->bcast_timer);
+  sm->bcast_timer = scheduler_add_timer(sm->sched, due, 0, post_bcast_event, sm->in_ev_q);
+  sm->bcast_armed_ms = sm->bcast_timer ? due : UINT64_MAX;
+}
+
+// 꺼낸 이벤트 배치 처리, 배치에서 생긴 출력은 큐별로 한 번에
+static void sm_process_batch(state_manager_t *sm, void **evs, int n) {
+  uint64_t pop_ns = trace_now_if();
+  for (int i = 0; i < n; i++) {
+    if (pop_ns) trace_stamp(&((sm_event_t*)evs[i])->trace, TR_SM_POP, pop_ns);
+    sm_handle_event(sm, &sm->table, (sm_event_t*)evs[i], &sm->out);
+    mempool_free(&g_pools.sm_ev, evs[i]);
   }
+  if (sm->out.n_tx_cmd) sm_flush_tx_cmd(sm, &sm->out);
+  if (sm->out.n_air) sm_flush_air(sm, &sm->out);
+  sm_arm_bcast(sm, &sm->table);
 
+  stats_add(&g_stats->filter[STF_SM_DEDUP].pass, sm->out.n_new);
+  stats_add(&g_stats->filter[STF_SM_DEDUP].reject, sm->out.n_dup);
+  sm->out.n_new = sm->out.n_dup = 0;
+  stats_set(&g_stats->acc_count, sm->table.count);
+  stats_set(&g_stats->acc_active, sm->table.active_count);
+  stats_set(&g_stats->acc_cap, sm->table.cap);
+}
+
+static void* sm_thread(void *arg) {
+  state_manager_t *sm = (state_manager_t*)arg;
+  void *evs[SM_BATCH_MAX];
+
+  while (sm->running) {
+    int n = bq_pop_many(sm->in_ev_q, evs, SM_BATCH_MAX);
+    if (n == 0) break;
+    sm_process_batch(sm, evs, n);
+  }
   return NULL;
 }
 
-int state_manager_start(state_manager_t *sm,
-                        const app_config_t *cfg,
-                        bq_t *in_ev_q,
-                        bq_t *to_tx_cmd_q,
-                        bq_t *to_air_q,
-                        scheduler_t *sched,
-                        led_handle_t *led) {
+int state_manager_poll(state_manager_t *sm) {
+  void *evs[SM_BATCH_MAX];
+  int total = 0, n;
+  while ((n = bq_try_pop_many(sm->in_ev_q, evs, SM_BATCH_MAX)) > 0) {
+    sm_process_batch(sm, evs, n);
+    total += n;
+  }
+  return total;
+}
+
+int state_manager_init(state_manager_t *sm,
+                       const app_config_t *cfg,
+                       bq_t *in_ev_q,
+                       bq_t *to_tx_cmd_q,
+                       bq_t *to_air_q,
+                       scheduler_t *sched,
+                       led_handle_t *led,
+                       rx_dedup_t *dedup) {
   memset(sm, 0, sizeof(*sm));
   sm->cfg = cfg;
   sm->in_ev_q = in_ev_q;
@@ -186,13 +303,48 @@ int state_manager_start(state_manager_t *sm,
   sm->to_air_q = to_air_q;
   sm->sched = sched;
   sm->led = led;
+  sm->dedup = dedup;
+  sm->bcast_armed_ms = UINT64_MAX;
+
+  if (acc_table_init(&sm->table, cfg->acc_table_cap, cfg->acc_table_max) != 0) {
+    LOGE("accident table alloc failed");
+    return -1;
+  }
+  sm->table_ready = true;
+
+  // 주기 타이머 한 번 등록 (tick마다 재등록하지 않음)
+  sm->tick_timer = scheduler_add_timer(sched, now_ms_monotonic() + SM_TICK_MS, SM_TICK_MS,
+                                       post_tick_event, in_ev_q);
+  if (!sm->tick_timer) LOGW("tick timer add failed");
+  sm->running = true;
+  return 0;
+}
 
+int state_manager_start(state_manager_t *sm,
+                        const app_config_t *cfg,
+                        bq_t *in_ev_q,
+                        bq_t *to_tx_cmd_q,
+                        bq_t *to_air_q,
+                        scheduler_t *sched,
+                        led_handle_t *led,
+                        rx_dedup_t *dedup) {
+  if (state_manager_init(sm, cfg, in_ev_q, to_tx_cmd_q, to_air_q, sched, led, dedup) != 0) return -1;
   if (pthread_create(&sm->th, NULL, sm_thread, sm) != 0) return -1;
+  sm->th_started = true;
   return 0;
 }
 
 void state_manager_stop(state_manager_t *sm) {
   if (!sm) return;
   sm->running = false;
-  pthread_join(sm->th, NULL);
-}
\ No newline at end of file
+  if (sm->th_started) {
+    pthread_join(sm->th, NULL);
+    sm->th_started = false;
+  }
+  if (sm->table_ready) {
+    scheduler_cancel(sm->sched, sm->tick_timer);
+    if (sm->bcast_timer) scheduler_cancel(sm->sched, sm->bcast_timer);
+    acc_table_destroy(&sm->table);
+    sm->table_ready = false;
+  }
+}
@@ -0,0 +1,78 @@
+// app/stats_shm.c
+#include "stats_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "log.h"
+
+static rsu_stats_t g_local;          // 공유 메모리가 없을 때 / 닫은 뒤
+rsu_stats_t *g_stats = &g_local;
+
+static rsu_stats_t *g_map;
+static char g_name[64];
+
+static void stats_header_init(rsu_stats_t *st) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  memset(st, 0, sizeof(*st));
+  st->magic = RSU_STATS_MAGIC;
+  st->version = RSU_STATS_VERSION;
+  st->size = (uint32_t)sizeof(*st);
+  st->pid = (uint32_t)getpid();
+  st->started_ms = (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
+}
+
+int stats_shm_open(const char *name) {
+  stats_header_init(&g_local);
+  g_stats = &g_local;
+  if (!name || !*name) return -1;
+
+  int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    LOGW("stats shm %s: shm_open failed (%s), counters stay in-process", name, strerror(errno));
+    return -1;
+  }
+  if (ftruncate(fd, (off_t)sizeof(rsu_stats_t)) != 0) {
+    LOGW("stats shm %s: ftruncate failed (%s)", name, strerror(errno));
+    close(fd);
+    shm_unlink(name);
+    return -1;
+  }
+  void *m = mmap(NULL, sizeof(rsu_stats_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (m == MAP_FAILED) {
+    LOGW("stats shm %s: mmap failed (%s)", name, strerror(errno));
+    shm_unlink(name);
+    return -1;
+  }
+
+  g_map = (rsu_stats_t*)m;
+  // 이전 실행이 남긴 값 위에 바로 덮음: magic은 마지막에 써서 읽는 쪽이 반쯤 쓴 헤더를 안 보게
+  stats_header_init(&g_local);
+  uint32_t magic = g_local.magic;
+  g_local.magic = 0;
+  memcpy(g_map, &g_local, sizeof(*g_map));
+  atomic_thread_fence(memory_order_release);
+  g_map->magic = magic;
+  g_local.magic = magic;
+  snprintf(g_name, sizeof(g_name), "%s", name);
+  g_stats = g_map;
+  LOGI("stats shm %s (%zu bytes, view with rsu-top)", name, sizeof(rsu_stats_t));
+  return 0;
+}
+
+void stats_shm_close(void) {
+  g_stats = &g_local;
+  if (!g_map) return;
+  munmap(g_map, sizeof(*g_map));
+  g_map = NULL;
+  shm_unlink(g_name);
+  g_name[0] = '\0';
+}
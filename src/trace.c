@@ -0,0 +1,142 @@
+// app/trace.c
+#include "trace.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "pools.h"
+
+// log-linear: 값 < 2^SUB_BITS는 1ns 단위, 이후 2배 구간마다 2^SUB_BITS칸
+#define TR_SUB_BITS    5
+#define TR_SUB         (1u << TR_SUB_BITS)
+#define TR_HIST_BUCKETS ((32 - TR_SUB_BITS + 1) * TR_SUB)   // uint32 ns 범위
+
+// 샘플 수는 칸 합으로 (기록 시 원자 연산 하나 줄임)
+typedef struct {
+  _Alignas(64) _Atomic uint64_t sum_ns;
+  _Atomic uint64_t max_ns;
+  _Atomic uint64_t b[TR_HIST_BUCKETS];
+} trace_hist_t;
+
+_Atomic bool g_trace_on;
+
+static trace_hist_t g_hist[TR_N_SPANS];
+static uint64_t *g_rx_ns;     // g_pools.wl1_pkt 슬롯별 RX 시각
+static uint32_t g_rx_n;
+
+static const char *const g_span_names[TR_N_SPANS] = {
+  "wl1_queue", "wl1_proc", "sm_queue", "sm_proc", "tx_queue", "tx_send", "e2e",
+};
+
+static inline uint32_t bucket_of(uint64_t v) {
+  if (v > UINT32_MAX) v = UINT32_MAX;
+  if (v < TR_SUB) return (uint32_t)v;
+  uint32_t k = 63u - (uint32_t)__builtin_clzll(v);        // TR_SUB_BITS..31
+  return (k - TR_SUB_BITS + 1) * TR_SUB + (uint32_t)((v >> (k - TR_SUB_BITS)) & (TR_SUB - 1));
+}
+
+// 칸의 상한 (이 값 이하가 이 칸에 들어감)
+static uint64_t bucket_high(uint32_t idx) {
+  if (idx < 2 * TR_SUB) return idx;
+  uint32_t k = idx / TR_SUB + TR_SUB_BITS - 1;
+  uint64_t low = (uint64_t)(TR_SUB + idx % TR_SUB) << (k - TR_SUB_BITS);
+  return low + (1ull << (k - TR_SUB_BITS)) - 1;
+}
+
+void trace_record(trace_span_t sp, uint64_t ns) {
+  trace_hist_t *h = &g_hist[sp];
+  atomic_fetch_add_explicit(&h->b[bucket_of(ns)], 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&h->sum_ns, ns, memory_order_relaxed);
+  uint64_t m = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+  while (ns > m && !atomic_compare_exchange_weak_explicit(&h->max_ns, &m, ns,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+  }
+}
+
+int trace_init(void) {
+  g_rx_n = g_pools.wl1_pkt.count;
+  g_rx_ns = (uint64_t*)calloc(g_rx_n ? g_rx_n : 1, sizeof(uint64_t));
+  if (!g_rx_ns) {
+    g_rx_n = 0;
+    return -1;
+  }
+  return 0;
+}
+
+void trace_destroy(void) {
+  free(g_rx_ns);
+  g_rx_ns = NULL;
+  g_rx_n = 0;
+}
+
+void trace_wl1_rx_mark(const void *pkt, uint64_t now) {
+  uint32_t i = mempool_index(&g_pools.wl1_pkt, pkt);
+  if (i < g_rx_n) g_rx_ns[i] = now;
+}
+
+uint64_t trace_wl1_rx_take(const void *pkt) {
+  uint32_t i = mempool_index(&g_pools.wl1_pkt, pkt);
+  if (i >= g_rx_n) return 0;
+  uint64_t t = g_rx_ns[i];
+  g_rx_ns[i] = 0;
+  return t;
+}
+
+void trace_set_enabled(bool on) {
+  atomic_store(&g_trace_on, on);
+}
+
+void trace_reset(void) {
+  for (int s = 0; s < TR_N_SPANS; s++) {
+    trace_hist_t *h = &g_hist[s];
+    atomic_store(&h->sum_ns, 0);
+    atomic_store(&h->max_ns, 0);
+    for (uint32_t i = 0; i < TR_HIST_BUCKETS; i++) atomic_store(&h->b[i], 0);
+  }
+}
+
+const char* trace_span_name(trace_span_t sp) {
+  return (sp >= 0 && sp < TR_N_SPANS) ? g_span_names[sp] : "?";
+}
+
+void trace_get_span_stats(trace_span_t sp, trace_span_stats_t *out) {
+  memset(out, 0, sizeof(*out));
+  if (sp < 0 || sp >= TR_N_SPANS) return;
+  trace_hist_t *h = &g_hist[sp];
+
+  // 칸을 한 번 읽어 그 합으로 분위수 (기록 중에 읽어도 일관된 근사)
+  uint64_t b[TR_HIST_BUCKETS];
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < TR_HIST_BUCKETS; i++) {
+    b[i] = atomic_load_explicit(&h->b[i], memory_order_relaxed);
+    total += b[i];
+  }
+  out->count = total;
+  out->max_ns = atomic_load(&h->max_ns);
+  if (total == 0) return;
+  out->mean_ns = atomic_load(&h->sum_ns) / total;
+
+  const double qs[3] = { 0.50, 0.99, 0.999 };
+  uint64_t *dst[3] = { &out->p50_ns, &out->p99_ns, &out->p999_ns };
+  uint64_t seen = 0;
+  uint32_t i = 0;
+  for (int q = 0; q < 3; q++) {
+    uint64_t rank = (uint64_t)(qs[q] * (double)total);
+    if (rank >= total) rank = total - 1;
+    while (i < TR_HIST_BUCKETS && seen + b[i] <= rank) seen += b[i++];
+    uint64_t v = (i < TR_HIST_BUCKETS) ? bucket_high(i) : out->max_ns;
+    *dst[q] = (v < out->max_ns) ? v : out->max_ns;
+  }
+}
+
+void trace_log_stats(void) {
+  for (int s = 0; s < TR_N_SPANS; s++) {
+    trace_span_stats_t st;
+    trace_get_span_stats((trace_span_t)s, &st);
+    if (st.count == 0) continue;
+    LOGI("trace %-9s n=%llu mean %.1f us p50 %.1f us p99 %.1f us p99.9 %.1f us max %.1f us",
+         g_span_names[s], (unsigned long long)st.count, st.mean_ns / 1000.0, st.p50_ns / 1000.0,
+         st.p99_ns / 1000.0, st.p999_ns / 1000.0, st.max_ns / 1000.0);
+  }
+}
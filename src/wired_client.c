@@ -3,203 +3,539 @@
 #include "log.h"
 #include "debug.h"
 #include "timeutil.h"
+#include "pools.h"
+#include "trace.h"
+#include "stats_shm.h"
 #include <arpa/inet.h>
 #include <errno.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
+#include <time.h>
 #include <unistd.h>
 
 // -----------------------------------------------------------------------------
-// 1. [Outgoing] RSU -> Server (사고 보고용 클라이언트)
+// 1. [Outgoing] RSU -> Server (사고 보고용 클라이언트, epoll 상태 머신)
 // -----------------------------------------------------------------------------
-static int tcp_connect_to_server(const app_config_t *cfg) {
-  int s = socket(AF_INET, SOCK_STREAM, 0);
-  if (s < 0) return -1;
-
-  // [수정] 20905번 Bind 제거! 
-  // RSU가 서버로 보낼 때는 OS가 아무 빈 포트나 쓰게 둡니다.
-  // 20905번은 아래 "수신 서버"가 써야 하기 때문입니다.
-
-  struct sockaddr_in srv;
-  memset(&srv, 0, sizeof(srv));
-  srv.sin_family = AF_INET;
-  srv.sin_port = htons(cfg->server_port); // 20615
-  srv.sin_addr.s_addr = inet_addr(cfg->server_ip);
-
-  if (connect(s, (struct sockaddr*)&srv, sizeof(srv)) < 0) {
-    LOGW("tcp connect failed: %d", errno);
-    close(s);
-    return -1;
-  }
-  
-  DBG_INFO("TCP Connected to Server %s:%d (Outgoing)", cfg->server_ip, cfg->server_port);
-  return s;
+#ifndef WC_DRAIN_MAX
+#define WC_DRAIN_MAX 64
+#endif
+
+static uint64_t now_us_monotonic(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000ull;
 }
 
-// [Thread] 서버가 보내는 "즉시 응답(ACK)" 수신 (기존 연결 유지)
-static void* tcp_rx_ack_thread(void *arg) {
-    wired_client_t *wc = (wired_client_t*)arg;
-    uint8_t buf[256];
+static void wc_ep_set(wired_client_t *wc, int op, int fd, uint32_t events) {
+    struct epoll_event ev = { .events = events, .data.fd = fd };
+    epoll_ctl(wc->ep_fd, op, fd, &ev);
+}
 
-    while (wc->running) {
-        // RSU-3 Packet Size (64 Bytes) 수신
-        ssize_t n = recv(wc->sock_out, buf, sizeof(rsu3_packet_t), MSG_WAITALL);
-        if (n <= 0) {
-            // 연결 끊기면 재연결 로직이 필요하지만, 여기선 로그만 찍고 종료
-            if (wc->running) LOGW("Outgoing connection recv error: %d", errno);
-            break;
+// 가장 이른 마감으로 timerfd를 맞춤 (바뀔 때만 syscall)
+static void wc_arm_timer(wired_client_t *wc) {
+    uint64_t at = 0;
+    switch (wc->state) {
+    case WC_DISCONNECTED: at = wc->next_connect_us; break;
+    case WC_CONNECTING:   at = wc->connect_start_us + (uint64_t)wc->cfg->wired_connect_timeout_ms * 1000ull; break;
+    case WC_CONNECTED:    at = wc->want_out ? 0 : wc->flush_at_us; break;
+    }
+    if (at == wc->armed_us) return;
+    wc->armed_us = at;
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = (time_t)(at / 1000000ull);
+    its.it_value.tv_nsec = (long)(at % 1000000ull) * 1000;
+    if (at == 0) its.it_value.tv_nsec = 0;   // 해제
+    timerfd_settime(wc->tm_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static void wc_schedule_reconnect(wired_client_t *wc, uint64_t now) {
+    uint32_t b = wc->backoff_ms;
+    // +-25% jitter (여러 RSU가 동시에 재접속하지 않도록)
+    uint32_t j = b / 4 ? (uint32_t)(now * 2654435761u >> 7) % (b / 2 + 1) : 0;
+    wc->next_connect_us = now + ((uint64_t)b - b / 4 + j) * 1000ull;
+    uint32_t max = wc->cfg->wired_reconnect_max_ms;
+    wc->backoff_ms = (b >= max / 2) ? max : b * 2;
+}
+
+static void wc_set_offline(wired_client_t *wc, uint64_t now) {
+    if (wc->sock_out >= 0) {
+        close(wc->sock_out);   // epoll 등록도 같이 빠짐
+        wc->sock_out = -1;
+    }
+    wc->state = WC_DISCONNECTED;
+    wc->want_out = false;
+    wc->flush_at_us = 0;
+    wc->head_off = 0;   // 보내다 만 보고는 새 연결에서 처음부터
+    wc->ack_len = 0;
+    wc->health.connected = false;
+    if (!wc->offline_since_us) wc->offline_since_us = now;
+    wc_schedule_reconnect(wc, now);
+}
+
+static void wc_connect_failed(wired_client_t *wc, uint64_t now, int err) {
+    wc->health.connect_fails++;
+    // 서버가 없을 때 backoff마다 찍히지 않도록 끊긴 뒤 첫 실패만 WARN (backoff가 초기값)
+    if (wc->backoff_ms <= wc->cfg->wired_reconnect_min_ms) {
+        LOGW("wired: connect to %s:%d failed (%s), retry in ~%u ms", wc->cfg->server_ip,
+             wc->cfg->server_port, strerror(err), wc->backoff_ms);
+    } else {
+        DBG_DEBUG("wired: connect failed (%s), retry in ~%u ms", strerror(err), wc->backoff_ms);
+    }
+    wc_set_offline(wc, now);
+}
+
+static void wc_flush(wired_client_t *wc, uint64_t now);
+
+static void wc_connected(wired_client_t *wc, uint64_t now) {
+    uint64_t lat = now - wc->connect_start_us;
+    wc->state = WC_CONNECTED;
+    wc->backoff_ms = wc->cfg->wired_reconnect_min_ms;
+    wc->health.connected = true;
+    wc->health.connects++;
+    wc->health.connect_us_last = lat;
+    wc->health.connect_us_sum += lat;
+    if (lat > wc->health.connect_us_max) wc->health.connect_us_max = lat;
+    uint64_t off_ms = wc->offline_since_us ? (now - wc->offline_since_us) / 1000ull : 0;
+    wc->health.offline_ms_total += off_ms;
+    wc->offline_since_us = 0;
+
+    LOGI("wired: connected to %s:%d (connect %llu us, offline %llu ms, %u buffered)",
+         wc->cfg->server_ip, wc->cfg->server_port, (unsigned long long)lat,
+         (unsigned long long)off_ms, wc->tx_len);
+    wc_ep_set(wc, EPOLL_CTL_MOD, wc->sock_out, EPOLLIN | EPOLLRDHUP);
+    if (wc->tx_len) wc_flush(wc, now);   // 끊긴 동안 쌓인 것
+}
+
+static void wc_start_connect(wired_client_t *wc, uint64_t now) {
+    int s = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s < 0) {
+        wc_connect_failed(wc, now, errno);
+        return;
+    }
+    int one = 1;
+    // 묶음은 직접 만들므로 Nagle 대기는 불필요
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (wc->cfg->wired_tx_cork) setsockopt(s, IPPROTO_TCP, TCP_CORK, &one, sizeof(one));
+
+    // 20905번은 "수신 서버"가 쓰므로 bind하지 않음 (OS가 빈 포트 배정)
+    struct sockaddr_in srv;
+    memset(&srv, 0, sizeof(srv));
+    srv.sin_family = AF_INET;
+    srv.sin_port = htons(wc->cfg->server_port); // 20615
+    srv.sin_addr.s_addr = inet_addr(wc->cfg->server_ip);
+
+    wc->sock_out = s;
+    wc->connect_start_us = now;
+    wc->state = WC_CONNECTING;
+    if (connect(s, (struct sockaddr*)&srv, sizeof(srv)) == 0) {
+        wc_ep_set(wc, EPOLL_CTL_ADD, s, EPOLLIN | EPOLLRDHUP);
+        wc_connected(wc, now);
+        return;
+    }
+    if (errno != EINPROGRESS) {
+        wc_connect_failed(wc, now, errno);
+        return;
+    }
+    wc_ep_set(wc, EPOLL_CTL_ADD, s, EPOLLOUT);
+}
+
+// iov 전부를 보내거나 EAGAIN까지 (반환: 보낸 바이트, -1 = 연결 오류)
+// writev와 같지만 끊긴 연결에 SIGPIPE가 나지 않도록 sendmsg(MSG_NOSIGNAL)
+static ssize_t wc_sendv(int fd, struct iovec *iov, int iovcnt, wc_tx_stats_t *st) {
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    size_t total = 0;
+    while (iovcnt > 0) {
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)iovcnt;
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        st->syscalls++;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return -1;
+        }
+        total += (size_t)n;
+        size_t left = (size_t)n;
+        while (iovcnt > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            st->partial++;
+            iov->iov_base = (char*)iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+    st->bytes += total;
+    return (ssize_t)total;
+}
+
+// 버퍼 전체를 한 번에 (링이 감겨 있으면 iovec 2개), 못 보낸 만큼은 EPOLLOUT 대기
+static void wc_flush(wired_client_t *wc, uint64_t now) {
+    wc->flush_at_us = 0;
+    if (wc->state != WC_CONNECTED || wc->tx_len == 0) return;
+    const bool resume = wc->want_out;   // EPOLLOUT: 지난 flush에서 못 보낸 나머지 이어서
+
+    const size_t psz = sizeof(rsu2_packet_t);
+    uint32_t first = wc->tx_cap - wc->tx_head;
+    if (first > wc->tx_len) first = wc->tx_len;
+    struct iovec iov[2];
+    int iovcnt = 1;
+    iov[0].iov_base = (uint8_t*)&wc->txbuf[wc->tx_head] + wc->head_off;
+    iov[0].iov_len = first * psz - wc->head_off;
+    if (first < wc->tx_len) {
+        iov[1].iov_base = &wc->txbuf[0];
+        iov[1].iov_len = (size_t)(wc->tx_len - first) * psz;
+        iovcnt = 2;
+    }
+
+    ssize_t n = wc_sendv(wc->sock_out, iov, iovcnt, &wc->tx_stats);
+    if (n < 0) {
+        LOGW("wired: send failed (%s), %u report(s) kept for reconnect", strerror(errno), wc->tx_len);
+        wc->health.disconnects++;
+        wc_set_offline(wc, now);
+        return;
+    }
+
+    size_t sent = wc->head_off + (size_t)n;
+    uint32_t done = (uint32_t)(sent / psz);
+    uint64_t sent_ns = done ? trace_now_if() : 0;
+    for (uint32_t i = 0; sent_ns && i < done; i++) {
+        trace_stamp(&wc->tx_trace[(wc->tx_head + i) % wc->tx_cap], TR_TCP_SEND, sent_ns);
+    }
+    wc->tx_head = (wc->tx_head + done) % wc->tx_cap;
+    wc->tx_len -= done;
+    wc->head_off = sent % psz;
+    wc->tx_stats.reports += done;
+    stats_add(&g_stats->reports_sent, done);
+    if (resume) wc->tx_stats.resumes++;
+    else wc->tx_stats.flushes++;
+    wc->health.buffered = wc->tx_len;
+    if (done) DBG_INFO("[TX] Sent %u Accident Report(s) to Server", done);
+
+    bool more = wc->tx_len > 0;
+    if (more != wc->want_out) {
+        wc->want_out = more;
+        wc_ep_set(wc, EPOLL_CTL_MOD, wc->sock_out, EPOLLIN | EPOLLRDHUP | (more ? EPOLLOUT : 0));
+    }
+    if (!more && wc->cfg->wired_tx_cork) {
+        // cork 해제 = 남은 부분 세그먼트 즉시 전송, 다음 묶음을 위해 다시 cork
+        int off = 0, on = 1;
+        setsockopt(wc->sock_out, IPPROTO_TCP, TCP_CORK, &off, sizeof(off));
+        setsockopt(wc->sock_out, IPPROTO_TCP, TCP_CORK, &on, sizeof(on));
+    }
+}
+
+/*
+ * Q_tx_cmd를 비울 때까지 꺼내 송신 버퍼 뒤에 wrap (명령/페이로드는 여기서 풀 반환)
+ * flush 정책: wired_tx_batch개 이상 쌓였으면 즉시, 아니면 첫 보고 후 wired_tx_delay_us에
+ * 사고가 한꺼번에 몰리면 syscall/TCP 세그먼트 수가 보고 수가 아니라 묶음 수에 비례
+ */
+static void wc_drain_tx_q(wired_client_t *wc, uint64_t now) {
+    void *cmds[WC_DRAIN_MAX];
+    int n;
+    uint32_t added = 0;
+    while ((n = bq_try_pop_many(wc->tx_cmd_q, cmds, WC_DRAIN_MAX)) > 0) {
+        uint64_t pop_ns = trace_now_if();
+        for (int i = 0; i < n; i++) {
+            tx_cmd_wired_t *cmd = (tx_cmd_wired_t*)cmds[i];
+            if (cmd->rsu2p) {
+                if (wc->muted) {
+                    wc->tx_stats.discarded++;
+                } else if (wc->tx_len == wc->tx_cap) {
+                    wc->tx_stats.dropped++;
+                } else {
+                    uint32_t slot = (wc->tx_head + wc->tx_len) % wc->tx_cap;
+                    if (sec_wired_tx_wrap(cmd->rsu2p, &wc->txbuf[slot])) {
+                        wc->tx_trace[slot] = cmd->trace;
+                        trace_stamp(&wc->tx_trace[slot], TR_TXQ_POP, pop_ns);
+                        if (!pop_ns) wc->tx_trace[slot].base_ns = 0;
+                        wc->tx_len++;
+                        added++;
+                    } else {
+                        wc->tx_stats.dropped++;   // wrap(서명) 실패: 보낼 수 없는 보고
+                    }
+                }
+                mempool_free(&g_pools.rsu2p, cmd->rsu2p);
+            }
+            mempool_free(&g_pools.tx_cmd, cmd);
         }
+    }
+    wc->health.buffered = wc->tx_len;
+    if (wc->tx_len > wc->health.buffered_max) wc->health.buffered_max = wc->tx_len;
+    if (!added || wc->state != WC_CONNECTED || wc->want_out) return;
+
+    if (wc->tx_len >= wc->cfg->wired_tx_batch || wc->cfg->wired_tx_delay_us == 0) {
+        wc_flush(wc, now);
+    } else if (!wc->flush_at_us) {
+        wc->flush_at_us = now + wc->cfg->wired_tx_delay_us;
+    }
+}
 
-        if (n != sizeof(rsu3_packet_t)) continue;
+// 서버 즉시 응답(ACK): rsu3_packet_t 단위로 잘라 상태 관리로
+static void wc_read_acks(wired_client_t *wc, uint64_t now) {
+    for (;;) {
+        ssize_t n = recv(wc->sock_out, wc->ack_buf + wc->ack_len, sizeof(wc->ack_buf) - wc->ack_len,
+                         MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+        }
+        if (n <= 0) {
+            LOGW("wired: server closed connection (%s)", n == 0 ? "eof" : strerror(errno));
+            wc->health.disconnects++;
+            wc_set_offline(wc, now);
+            return;
+        }
+        wc->ack_len += (size_t)n;
+        if (wc->ack_len < sizeof(wc->ack_buf)) continue;
+        wc->ack_len = 0;
 
         // [RX Strip] RSU-3 -> RSU-3'
-        rsu3_packet_t *pkt = (rsu3_packet_t*)buf;
-        rsu3_payload_t *payload = (rsu3_payload_t*)calloc(1, sizeof(rsu3_payload_t));
-        
-        if (sec_wired_rx_strip(pkt, payload)) {
+        rsu3_payload_t *payload = (rsu3_payload_t*)mempool_alloc(&g_pools.rsu3p);
+        if (!payload) continue;
+        if (sec_wired_rx_strip((const rsu3_packet_t*)wc->ack_buf, payload)) {
             // 즉시 응답(ON 확인)도 상태 관리에 반영
-            bq_push(wc->rsu3_out_q, payload);
+            if (!bq_push(wc->rsu3_out_q, payload)) mempool_free(&g_pools.rsu3p, payload);
         } else {
-            free(payload);
+            mempool_free(&g_pools.rsu3p, payload);
         }
     }
-    return NULL;
 }
 
-// [Thread] 사고 패킷 전송 (TX Manager)
-static void* tcp_tx_manager_thread(void *arg) {
-    wired_client_t *wc = (wired_client_t*)arg;
+static void wc_on_sock(wired_client_t *wc, uint32_t events, uint64_t now) {
+    if (wc->state == WC_CONNECTING) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(wc->sock_out, SOL_SOCKET, SO_ERROR, &err, &len) < 0) err = errno;
+        if (err) wc_connect_failed(wc, now, err);
+        else wc_connected(wc, now);
+        return;
+    }
+    if (wc->state != WC_CONNECTED) return;
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        wc_read_acks(wc, now);
+        if (wc->state != WC_CONNECTED) return;
+    }
+    if (events & EPOLLOUT) wc_flush(wc, now);
+}
 
-    while (wc->running) {
-        tx_cmd_wired_t *cmd = (tx_cmd_wired_t*)bq_pop(wc->tx_cmd_q);
-        if (!cmd) {
-            if (!wc->running) break;
-            continue;
+// 시간 기반 전이: 재접속, connect timeout, flush 마감
+static void wc_on_time(wired_client_t *wc, uint64_t now) {
+    switch (wc->state) {
+    case WC_DISCONNECTED:
+        if (!wc->muted && now >= wc->next_connect_us) wc_start_connect(wc, now);
+        break;
+    case WC_CONNECTING:
+        if (now >= wc->connect_start_us + (uint64_t)wc->cfg->wired_connect_timeout_ms * 1000ull) {
+            wc_connect_failed(wc, now, ETIMEDOUT);
         }
+        break;
+    case WC_CONNECTED:
+        if (wc->flush_at_us && !wc->want_out && now >= wc->flush_at_us) wc_flush(wc, now);
+        break;
+    }
+}
 
-        if (cmd->rsu2p) {
-            rsu2_packet_t pkt;
-            memset(&pkt, 0, sizeof(pkt));
-            
-            if (sec_wired_tx_wrap(cmd->rsu2p, &pkt)) {
-                send(wc->sock_out, &pkt, sizeof(pkt), 0);
-                DBG_INFO("[TX] Sent Accident Report to Server");
-            }
-            free(cmd->rsu2p);
+#define WC_TAG_CMD (-2)   // event loop 모드: 명령 서버 epoll fd를 이 루프에 중첩
+
+// epoll 1회분 (timeout_ms: -1 = 가장 이른 마감까지, 0 = 대기 없음)
+static void wc_io_once(wired_client_t *wc, int timeout_ms) {
+    struct epoll_event evs[8];
+
+    wc_arm_timer(wc);
+    int n = epoll_wait(wc->ep_fd, evs, 8, timeout_ms);
+    if (n < 0) {
+        if (errno != EINTR) LOGE("wired: epoll_wait failed: %d", errno);
+        return;
+    }
+    uint64_t now = now_us_monotonic();
+    for (int i = 0; i < n; i++) {
+        int fd = evs[i].data.fd;
+        uint64_t v;
+        if (fd == wc->ev_fd) {
+            if (read(wc->ev_fd, &v, sizeof(v)) < 0) { /* 이미 비워짐 */ }
+            wc_drain_tx_q(wc, now);
+        } else if (fd == wc->tm_fd) {
+            if (read(wc->tm_fd, &v, sizeof(v)) < 0) { /* 재설정으로 취소됨 */ }
+            wc->armed_us = 0;
+        } else if (fd == WC_TAG_CMD) {
+            cmd_server_poll(&wc->cmd);
+        } else if (fd == wc->sock_out) {
+            wc_on_sock(wc, evs[i].events, now);
         }
-        free(cmd);
     }
+    wc_on_time(wc, now_us_monotonic());
+    // 이번 회차에 생긴 마감(flush_at_us, next_connect_us)도 timerfd에 반영
+    // (event loop는 다음 wired 이벤트가 올 때까지 여기로 안 돌아옴)
+    wc_arm_timer(wc);
+
+    stats_set(&g_stats->wired_state, (uint64_t)wc->state);
+    stats_set(&g_stats->wired_connects, wc->health.connects);
+    stats_set(&g_stats->wired_disconnects, wc->health.disconnects);
+    stats_set(&g_stats->wired_buffered, wc->tx_len);
+}
+
+// [Thread] Outgoing IO 루프 (연결/보고 송신/ACK 수신)
+static void* wc_io_thread(void *arg) {
+    wired_client_t *wc = (wired_client_t*)arg;
+    while (wc->running) wc_io_once(wc, -1);
     return NULL;
 }
 
+void wired_client_get_health(const wired_client_t *wc, wc_health_t *out) {
+    *out = wc->health;
+    if (wc->offline_since_us) out->offline_ms_total += (now_us_monotonic() - wc->offline_since_us) / 1000ull;
+}
 
-// -----------------------------------------------------------------------------
-// 2. [Incoming] Server -> RSU (명령 수신용 서버) - 핵심 추가!!
-// -----------------------------------------------------------------------------
-static void* tcp_command_server_thread(void *arg) {
-    wired_client_t *wc = (wired_client_t*)arg;
-    
-    // 1. 수신용 소켓 생성
-    int listen_sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (listen_sock < 0) return NULL;
-
-    int yes = 1;
-    setsockopt(listen_sock, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
-
-    struct sockaddr_in addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(wc->cfg->local_port); // 20905
-    addr.sin_addr.s_addr = htonl(INADDR_ANY);
-
-    if (bind(listen_sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        LOGE("Command Server Bind Failed (Port %d): %d", wc->cfg->local_port, errno);
-        close(listen_sock);
-        return NULL;
-    }
-
-    listen(listen_sock, 5);
-    LOGI("Command Server Listening on Port %d (Waiting for OFF signal)", wc->cfg->local_port);
-    wc->sock_in_listen = listen_sock;
-
-    while (wc->running) {
-        struct sockaddr_in cli_addr;
-        socklen_t len = sizeof(cli_addr);
-        
-        // 2. 서버 접속 대기 (Accept)
-        int conn = accept(listen_sock, (struct sockaddr*)&cli_addr, &len);
-        if (conn < 0) {
-            if (errno == EINTR) continue;
-            break; // 종료
-        }
+static int wc_io_open(wired_client_t *wc) {
+    const app_config_t *cfg = wc->cfg;
+    wc->sock_out = -1;
+    wc->tx_cap = cfg->wired_tx_buf ? cfg->wired_tx_buf : 1;
+    wc->txbuf = (rsu2_packet_t*)malloc((size_t)wc->tx_cap * sizeof(rsu2_packet_t));
+    wc->tx_trace = (pkt_trace_t*)calloc(wc->tx_cap, sizeof(pkt_trace_t));
+    wc->ep_fd = epoll_create1(EPOLL_CLOEXEC);
+    wc->ev_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    wc->tm_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (!wc->txbuf || !wc->tx_trace || wc->ep_fd < 0 || wc->ev_fd < 0 || wc->tm_fd < 0) return -1;
+    wc_ep_set(wc, EPOLL_CTL_ADD, wc->ev_fd, EPOLLIN);
+    wc_ep_set(wc, EPOLL_CTL_ADD, wc->tm_fd, EPOLLIN);
+    if (bq_set_notify_fd(wc->tx_cmd_q, wc->ev_fd) != 0) {
+        LOGE("wired: tx queue must be a mutex queue (notify fd)");
+        return -1;
+    }
 
-        // DBG_INFO("Server connected to send command!");
-
-        // 3. 명령 패킷 수신 (64 Bytes)
-        uint8_t buf[256];
-        ssize_t n = recv(conn, buf, sizeof(rsu3_packet_t), MSG_WAITALL);
-        
-        if (n == sizeof(rsu3_packet_t)) {
-            rsu3_packet_t *pkt = (rsu3_packet_t*)buf;
-            rsu3_payload_t *payload = (rsu3_payload_t*)calloc(1, sizeof(rsu3_payload_t));
-            
-            if (sec_wired_rx_strip(pkt, payload)) {
-                LOGI("[CMD] Received Command from Server (Flag: 0x%04X)", payload->server_info.acc_flag);
-                // State Manager에게 전달 -> 여기서 LED 꺼짐!
-                bq_push(wc->rsu3_out_q, payload);
-            } else {
-                free(payload);
-            }
-        }
-        
-        // 명령 하나 받고 바로 끊는 구조 (HTTP 처럼)
-        close(conn);
+    wc->backoff_ms = cfg->wired_reconnect_min_ms ? cfg->wired_reconnect_min_ms : 1;
+    wc->state = WC_DISCONNECTED;
+
+    // 재생 중 보고는 RSU_REPLAY_TX=1일 때만 서버로: 현장 캡처의 사고가 상위로 올라가지 않게
+    // 연결하지 않고 Q_tx_cmd만 비움 (next_connect_us 0 = 타이머 없음)
+    if (cfg->replay_path && !cfg->replay_tx) {
+        wc->muted = true;
+        LOGI("wired: replay without RSU_REPLAY_TX=1, reports are counted and discarded");
+        return 0;
     }
-    
-    close(listen_sock);
-    return NULL;
+
+    // 첫 연결은 바로 시도 (실패해도 루프가 backoff로 재시도)
+    uint64_t now = now_us_monotonic();
+    wc->offline_since_us = now;
+    wc->next_connect_us = now;
+    wc_start_connect(wc, now);
+    return 0;
 }
 
+static void wc_io_stop(wired_client_t *wc) {
+    if (wc->io_started) {
+        uint64_t one = 1;
+        if (write(wc->ev_fd, &one, sizeof(one)) < 0) { /* 루프가 running을 다시 봄 */ }
+        pthread_join(wc->th_io, NULL);
+        wc->io_started = false;
+    }
+    if (wc->txbuf) {
+        // 남은 버퍼는 연결돼 있으면 한 번 더 시도
+        wc_drain_tx_q(wc, now_us_monotonic());
+        wc_flush(wc, now_us_monotonic());
+
+        wc_health_t h;
+        wired_client_get_health(wc, &h);
+        const wc_tx_stats_t *st = &wc->tx_stats;
+        LOGI("wired tx: %llu reports in %llu flushes (%.1f/flush, %llu resumed), %llu syscalls, %llu partial, %llu dropped, %llu discarded (replay), %llu unsent",
+             (unsigned long long)st->reports, (unsigned long long)st->flushes,
+             st->flushes ? (double)st->reports / (double)st->flushes : 0.0,
+             (unsigned long long)st->resumes,
+             (unsigned long long)st->syscalls, (unsigned long long)st->partial,
+             (unsigned long long)st->dropped, (unsigned long long)st->discarded,
+             (unsigned long long)wc->tx_len);
+        LOGI("wired link: %llu connects (avg %llu us, max %llu us), %llu fails, %llu drops, offline %llu ms, peak buffer %llu",
+             (unsigned long long)h.connects,
+             (unsigned long long)(h.connects ? h.connect_us_sum / h.connects : 0),
+             (unsigned long long)h.connect_us_max, (unsigned long long)h.connect_fails,
+             (unsigned long long)h.disconnects, (unsigned long long)h.offline_ms_total,
+             (unsigned long long)h.buffered_max);
+    }
+    if (wc->tx_cmd_q) bq_set_notify_fd(wc->tx_cmd_q, -1);
+    if (wc->sock_out >= 0) close(wc->sock_out);
+    wc->sock_out = -1;
+    if (wc->ep_fd > 0) close(wc->ep_fd);
+    if (wc->ev_fd > 0) close(wc->ev_fd);
+    if (wc->tm_fd > 0) close(wc->tm_fd);
+    wc->ep_fd = wc->ev_fd = wc->tm_fd = -1;
+    free(wc->txbuf);
+    wc->txbuf = NULL;
+    free(wc->tx_trace);
+    wc->tx_trace = NULL;
+}
 
 // -----------------------------------------------------------------------------
 // 초기화 및 종료
 // -----------------------------------------------------------------------------
-int wired_client_start(wired_client_t *wc, const app_config_t *cfg, bq_t *tx_cmd_q, bq_t *rsu3_out_q) {
+static int wired_client_open(wired_client_t *wc, const app_config_t *cfg, bq_t *tx_cmd_q, bq_t *rsu3_out_q) {
   memset(wc, 0, sizeof(*wc));
   wc->cfg = cfg;
   wc->tx_cmd_q = tx_cmd_q;
   wc->rsu3_out_q = rsu3_out_q;
+  wc->sock_out = -1;
 
   wc->running = true;
 
-  // 1. 서버로 접속 (Outgoing)
-  wc->sock_out = tcp_connect_to_server(cfg);
-  if (wc->sock_out < 0) {
-      LOGW("Failed to connect to server (Offline Mode)");
-      // 실패해도 수신 서버는 켜야 함
-  } else {
-      if (pthread_create(&wc->th_tx, NULL, tcp_tx_manager_thread, wc) != 0) return -1;
-      if (pthread_create(&wc->th_rx_ack, NULL, tcp_rx_ack_thread, wc) != 0) return -1;
+  // 1. 서버 방향 (Outgoing) - 연결 실패해도 IO 루프가 backoff로 재접속
+  if (wc_io_open(wc) != 0) {
+      LOGE("wired: io loop setup failed");
+      return -1;
+  }
+  return 0;
+}
+
+int wired_client_start(wired_client_t *wc, const app_config_t *cfg, bq_t *tx_cmd_q, bq_t *rsu3_out_q) {
+  if (wired_client_open(wc, cfg, tx_cmd_q, rsu3_out_q) != 0) return -1;
+  if (pthread_create(&wc->th_io, NULL, wc_io_thread, wc) != 0) return -1;
+  wc->io_started = true;
+
+  // 2. 서버로부터 명령 수신 (Incoming Server) - bind 실패해도 보고 송신은 계속
+  //    재생(muted)은 서버와 주고받지 않으므로 포트도 안 잡음
+  if (wc->muted) return 0;
+  if (cmd_server_start(&wc->cmd, cfg, rsu3_out_q) != 0) {
+      LOGE("wired: command server unavailable (port %d)", cfg->local_port);
   }
+  return 0;
+}
 
-  // 2. 서버로부터 접속 대기 (Incoming Server) - New!
-  if (pthread_create(&wc->th_cmd_srv, NULL, tcp_command_server_thread, wc) != 0) return -1;
+int wired_client_open_loop(wired_client_t *wc, const app_config_t *cfg, bq_t *tx_cmd_q, bq_t *rsu3_out_q) {
+  if (wired_client_open(wc, cfg, tx_cmd_q, rsu3_out_q) != 0) return -1;
 
+  // 명령 서버도 스레드 없이, epoll fd를 이 루프에 넣어 한 fd로 묶음
+  if (cmd_server_open(&wc->cmd, cfg, rsu3_out_q) != 0) {
+      LOGE("wired: command server unavailable (port %d)", cfg->local_port);
+  } else {
+      struct epoll_event ev = { .events = EPOLLIN, .data.fd = WC_TAG_CMD };
+      epoll_ctl(wc->ep_fd, EPOLL_CTL_ADD, cmd_server_fd(&wc->cmd), &ev);
+  }
   return 0;
 }
 
+int wired_client_fd(const wired_client_t *wc) {
+  return wc->ep_fd;
+}
+
+void wired_client_poll(wired_client_t *wc) {
+  wc_io_once(wc, 0);
+}
+
 void wired_client_stop(wired_client_t *wc) {
-  if (!wc) return;
+  if (!wc || !wc->cfg) return;
   wc->running = false;
-  
-  if (wc->sock_out > 0) close(wc->sock_out);
-  if (wc->sock_in_listen > 0) {
-      shutdown(wc->sock_in_listen, SHUT_RDWR); // accept 깨우기
-      close(wc->sock_in_listen);
-  }
 
-  // 쓰레드 종료 대기 (단순화)
-  // pthread_join... 
-}
\ No newline at end of file
+  wc_io_stop(wc);
+
+  cmd_server_stop(&wc->cmd);
+}
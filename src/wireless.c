@@ -1,102 +1,379 @@
+#define _GNU_SOURCE // recvmmsg/sendmmsg
 #include "wireless.h"
 
 #include "types.h"
 #include "log.h"
+#include "debug.h"
 #include "timeutil.h"
+#include "pools.h"
+#include "bcast_frame.h"
+#include "wl1_worker.h"
+#include "filter.h"
+#include "trace.h"
+#include "stats_shm.h"
 
 #include <arpa/inet.h>
 #include <errno.h>
 #include <netinet/in.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <unistd.h>
 
-#ifndef WL1_TX_BCAST_IP
-#define WL1_TX_BCAST_IP "255.255.255.255"
-#endif
-
-#ifndef WL1_TX_PORT
-// TODO: 실제 WL-1 송신 포트로 바꿔야 함
-#define WL1_TX_PORT 30001
-#endif
-
-static void* wireless_rx_thread(void *arg) {
-    wireless_t *w = (wireless_t*)arg;
+// 단건 모드: recvfrom 1회 = datagram 1개
+static void wl1_rx_single_loop(wireless_t *w) {
     uint8_t buf[512]; // 충분한 크기
 
     while (w->running) {
         struct sockaddr_in src;
         socklen_t slen = sizeof(src);
         ssize_t n = recvfrom(w->sock_rx, buf, sizeof(buf), 0, (struct sockaddr*)&src, &slen);
-        if (n > 0) {
-            // 패킷 수신 시점 기록
-            LOGI("[STEP 1] UDP RX Packet: %ld bytes", n);
-        }
         if (n < 0) {
             if (errno == EINTR) continue;
             continue;
         }
-        
+        // 패킷 수신 시점 기록
+        uint64_t rx_ns = trace_now_if();
+        stats_add(&g_stats->rx_datagrams, 1);
+        DBG_DEBUG("[STEP 1] UDP RX Packet: %ld bytes", (long)n);
+
         // WL-1 Packet Size Check (256 Bytes)
         if (n != sizeof(wl1_packet_t)) {
             // LOGW("Invalid WL-1 size: %ld", n);
             continue;
         }
 
+        // light filter 탈락 / 최근 넘긴 보고의 반복이면 할당 전에 버림
+        const wl1_packet_t *raw = (const wl1_packet_t*)buf;
+        if (!filter_pass_light(raw)) {
+            w->rx_filtered++;
+            stats_add(&g_stats->filter[STF_LIGHT].reject, 1);
+            continue;
+        }
+        stats_add(&g_stats->filter[STF_LIGHT].pass, 1);
+        if (rx_dedup_seen(w->dedup, raw->payload.sender.sender_id,
+                          raw->payload.accident.accident_id, now_ms_monotonic())) {
+            stats_add(&g_stats->filter[STF_RX_DEDUP].reject, 1);
+            continue;
+        }
+        stats_add(&g_stats->filter[STF_RX_DEDUP].pass, 1);
+
         // Raw Packet을 그대로 큐에 복사해서 넣음
         // (필터/보안은 Pipeline Worker가 수행)
-        wl1_packet_t *pkt = calloc(1, sizeof(wl1_packet_t));
+        wl1_packet_t *pkt = mempool_alloc(&g_pools.wl1_pkt);
+        if (!pkt) continue;
         memcpy(pkt, buf, sizeof(wl1_packet_t));
-        
-        if (!bq_push(w->out_rx_q, pkt)) {
-            free(pkt);
+        trace_wl1_rx_mark(pkt, rx_ns);
+
+        if (!bq_push(&w->out_rx_q[wl1_shard_of(pkt, w->n_rx_q)], pkt)) {
+            mempool_free(&g_pools.wl1_pkt, pkt);
         }
     }
-    return NULL;
 }
 
-static void* wireless_tx_thread(void *arg) {
-    wireless_t *w = (wireless_t*)arg;
-    struct sockaddr_in dst;
-    memset(&dst, 0, sizeof(dst));
-    dst.sin_family = AF_INET;
-    dst.sin_port = htons(30001); // TODO: Config
-    dst.sin_addr.s_addr = inet_addr("255.255.255.255");
-    
-    int yes=1;
-    setsockopt(w->sock_tx, SOL_SOCKET, SO_BROADCAST, &yes, sizeof(yes));
+// 크기 검사를 통과한 패킷 버퍼(slot[cand_idx[0..nc)]) -> light filter / RX dedup -> 샤드 큐
+// 큐로 넘긴 칸은 slot[i] = NULL, 탈락한 칸은 그대로 (호출자가 재사용/반환)
+// wait_stop != NULL: 샤드 큐가 가득 차도 버리지 않고 자리가 날 때까지 기다림 (파일 재생 최대 속도)
+// 반환: 큐로 넘긴 수
+static int wl1_rx_forward(wireless_t *w, wl1_packet_t **slot, const int *cand_idx, int nc,
+                          uint64_t rx_ns, volatile int *wait_stop) {
+    void *ready[WL1_MAX_WORKERS][WL1_RX_BATCH_MAX];
+    int nready[WL1_MAX_WORKERS];
+    const wl1_packet_t *cand[WL1_RX_BATCH_MAX];
+    for (int c = 0; c < nc; c++) cand[c] = slot[cand_idx[c]];
+
+    // light filter는 배치 단위로 한 번에 (탈락한 슬롯은 그대로 재사용)
+    uint64_t pass = filter_light_batch(cand, nc);
+    int npass = __builtin_popcountll(pass);
+    w->rx_filtered += (uint64_t)(nc - npass);
+    stats_add(&g_stats->filter[STF_LIGHT].pass, (uint64_t)npass);
+    stats_add(&g_stats->filter[STF_LIGHT].reject, (uint64_t)(nc - npass));
+
+    int nr = 0;
+    uint64_t now = now_ms_monotonic();
+    for (int s = 0; s < w->n_rx_q; s++) nready[s] = 0;
+    for (int c = 0; c < nc; c++) {
+        if (!(pass & (1ull << c))) continue;
+        int i = cand_idx[c];
+        // 최근 넘긴 보고의 반복 -> 슬롯 그대로 재사용 (할당/큐 전달 없음)
+        if (rx_dedup_seen(w->dedup, slot[i]->payload.sender.sender_id,
+                          slot[i]->payload.accident.accident_id, now)) continue;
+        int s = wl1_shard_of(slot[i], w->n_rx_q);
+        trace_wl1_rx_mark(slot[i], rx_ns);
+        ready[s][nready[s]++] = slot[i];
+        slot[i] = NULL;
+        nr++;
+    }
+    stats_add(&g_stats->filter[STF_RX_DEDUP].pass, (uint64_t)nr);
+    stats_add(&g_stats->filter[STF_RX_DEDUP].reject, (uint64_t)(npass - nr));
+    if (nr == 0) return 0;
+
+    // 샤드별로 한 번에 큐로 (넘치면 Q_DROP_TAIL 정책대로 뒤쪽이 버려짐)
+    for (int s = 0; s < w->n_rx_q; s++) {
+        if (nready[s] == 0) continue;
+        bq_t *q = &w->out_rx_q[s];
+        int pushed = 0;
+        if (!wait_stop) {
+            pushed = bq_push_many(q, ready[s], nready[s]);
+        } else {
+            // 남은 자리만큼만 넣어 drop으로 세지 않음 (이 스레드가 유일한 생산자면 항상 다 들어감)
+            while (pushed < nready[s] && w->running && !*wait_stop) {
+                int room = q->cap - (int)bq_depth(q);
+                if (room <= 0) {
+                    sched_yield();
+                    continue;
+                }
+                int k = nready[s] - pushed;
+                if (k > room) k = room;
+                int got = bq_push_many(q, &ready[s][pushed], k);
+                if (got == 0 && atomic_load(&q->stop)) break;
+                pushed += got;
+            }
+        }
+        for (int i = pushed; i < nready[s]; i++) mempool_free(&g_pools.wl1_pkt, ready[s][i]);
+    }
+    return nr;
+}
+
+// 배치 1회: recvmmsg 1회로 최대 batch개의 datagram을 패킷 버퍼(rx_slot)에 바로 수신
+// - flags: 스레드 모드는 MSG_WAITFORONE(첫 datagram까지만 대기하고 나머지는 이미 도착한 것만,
+//   배치를 채우려고 기다리지 않으므로 저부하 시 지연이 늘지 않음), event loop는 MSG_DONTWAIT
+// - 첫 datagram 대기 상한은 SO_RCVTIMEO(wl1_rx_timeout_ms)
+// 반환: 받은 datagram 수 (0 = 없음/타임아웃, -1 = 패킷 버퍼 할당 실패)
+static int wl1_rx_batch_once(wireless_t *w, int batch, int flags) {
+    wl1_packet_t **slot = w->rx_slot;
+    struct mmsghdr msgs[WL1_RX_BATCH_MAX];
+    struct iovec iov[WL1_RX_BATCH_MAX];
+    int cand_idx[WL1_RX_BATCH_MAX];
+
+    // 지난 배치에서 큐로 넘어간 슬롯만 새로 할당
+    int nslot = 0;
+    for (; nslot < batch; nslot++) {
+        if (!slot[nslot]) slot[nslot] = mempool_alloc(&g_pools.wl1_pkt);
+        if (!slot[nslot]) break;
+    }
+    if (nslot == 0) return -1;
+
+    memset(msgs, 0, sizeof(msgs[0]) * (size_t)nslot);
+    for (int i = 0; i < nslot; i++) {
+        iov[i].iov_base = slot[i];
+        iov[i].iov_len = sizeof(wl1_packet_t);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int n = recvmmsg(w->sock_rx, msgs, (unsigned int)nslot, flags, NULL);
+    if (n <= 0) {
+        // EAGAIN(타임아웃)/EINTR/소켓 종료 -> 호출자가 running 재확인
+        return 0;
+    }
+    uint64_t rx_ns = trace_now_if();   // 배치 전체에 한 시각
 
+    // WL-1 Packet Size Check (256 Bytes), 초과분은 MSG_TRUNC로 걸러짐
+    int nc = 0;
+    for (int i = 0; i < n; i++) {
+        if (msgs[i].msg_len != sizeof(wl1_packet_t)) continue;
+        if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) continue;
+        cand_idx[nc++] = i;
+    }
+    stats_add(&g_stats->rx_datagrams, (uint64_t)n);
+
+    int nr = wl1_rx_forward(w, slot, cand_idx, nc, rx_ns, NULL);
+    DBG_DEBUG("[STEP 1] UDP RX Batch: %d datagrams (%d forwarded)", n, nr);
+    (void)nr;
+    return n;
+}
+
+int wireless_inject(wireless_t *w, const uint8_t *const *frames, const uint32_t *len, int n,
+                     volatile int *wait_stop) {
+    wl1_packet_t *slot[WL1_RX_BATCH_MAX];
+    int cand_idx[WL1_RX_BATCH_MAX];
+    if (n > WL1_RX_BATCH_MAX) n = WL1_RX_BATCH_MAX;
+
+    int nc = 0;
+    for (int i = 0; i < n; i++) {
+        slot[i] = NULL;
+        if (len[i] != sizeof(wl1_packet_t)) continue;
+        // 최대 속도 재생이면 heap fallback 없이 워커가 풀 버퍼를 돌려줄 때까지 기다림
+        if (!wait_stop) {
+            slot[i] = mempool_alloc(&g_pools.wl1_pkt);
+        } else {
+            while (!(slot[i] = mempool_try_alloc(&g_pools.wl1_pkt)) && !*wait_stop && w->running) {
+                sched_yield();
+            }
+        }
+        if (!slot[i]) continue;
+        memcpy(slot[i], frames[i], sizeof(wl1_packet_t));
+        cand_idx[nc++] = i;
+    }
+    stats_add(&g_stats->rx_datagrams, (uint64_t)n);
+
+    int nr = wl1_rx_forward(w, slot, cand_idx, nc, trace_now_if(), wait_stop);
+    for (int i = 0; i < n; i++) mempool_free(&g_pools.wl1_pkt, slot[i]);
+    return nr;
+}
+
+static void wl1_rx_batch_loop(wireless_t *w, int batch) {
+    while (w->running) {
+        if (wl1_rx_batch_once(w, batch, MSG_WAITFORONE) < 0) {
+            LOGW("wireless rx: packet alloc failed");
+            usleep(1000);
+        }
+    }
+}
+
+#ifndef WL1_TX_BATCH_MAX
+#define WL1_TX_BATCH_MAX 64
+#endif
+
+// 단건 모드: pop 1회 = sendto 1회
+static void wl1_tx_single_loop(wireless_t *w, const struct sockaddr_in *dst) {
     while (w->running) {
-        // 이미 Wrap된 wl1_packet_t(256B)가 넘어옴
-        wl1_packet_t *pkt = (wl1_packet_t*)bq_pop(w->in_tx_q);
-        if (!pkt) {
+        // 이미 Wrap된 프레임(256B)이 넘어옴
+        bcast_frame_t *f = (bcast_frame_t*)bq_pop(w->in_tx_q);
+        if (!f) {
             if (!w->running) break;
             continue;
         }
 
-        sendto(w->sock_tx, pkt, sizeof(wl1_packet_t), 0, (struct sockaddr*)&dst, sizeof(dst));
-        free(pkt);
+        if (w->tx_muted) {
+            w->tx_discarded++;
+        } else if (sendto(w->sock_tx, &f->pkt, sizeof(wl1_packet_t), 0,
+                          (const struct sockaddr*)dst, sizeof(*dst)) == (ssize_t)sizeof(wl1_packet_t)) {
+            w->tx_sent++;
+            stats_add(&g_stats->air_sent, 1);
+        } else {
+            w->tx_failed++;
+        }
+        bcast_frame_put(f);
+    }
+}
+
+// 꺼낸 프레임들을 sendmmsg로 송신 후 참조 반환
+// sendmmsg가 중간에 실패하면 그 패킷만 실패로 세고 나머지를 이어서 보냄
+static void wl1_tx_send(wireless_t *w, void **frames, int n) {
+    struct mmsghdr msgs[WL1_TX_BATCH_MAX];
+    struct iovec iov[WL1_TX_BATCH_MAX];
+
+    if (w->tx_muted) {
+        w->tx_discarded += (uint64_t)n;
+        for (int i = 0; i < n; i++) bcast_frame_put((bcast_frame_t*)frames[i]);
+        return;
     }
+
+    memset(msgs, 0, sizeof(msgs[0]) * (size_t)n);
+    for (int i = 0; i < n; i++) {
+        iov[i].iov_base = &((bcast_frame_t*)frames[i])->pkt;
+        iov[i].iov_len = sizeof(wl1_packet_t);
+        msgs[i].msg_hdr.msg_name = (void*)&w->tx_dst;
+        msgs[i].msg_hdr.msg_namelen = sizeof(w->tx_dst);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int off = 0, sent = 0, failed = 0;
+    while (off < n) {
+        int r = sendmmsg(w->sock_tx, &msgs[off], (unsigned int)(n - off), 0);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            failed++;   // msgs[off] 송신 실패 -> 건너뛰고 계속
+            off++;
+            continue;
+        }
+        sent += r;
+        off += r;
+    }
+    w->tx_sent += (uint64_t)sent;
+    w->tx_failed += (uint64_t)failed;
+    stats_add(&g_stats->air_sent, (uint64_t)sent);
+
+    if (failed > 0) {
+        LOGW("wireless tx: batch %d sent, %d failed (errno=%d)", sent, failed, errno);
+    } else {
+        DBG_DEBUG("wireless tx: batch %d sent", sent);
+    }
+
+    for (int i = 0; i < n; i++) bcast_frame_put((bcast_frame_t*)frames[i]);
+}
+
+// 배치 모드: Q_air에 쌓인 것을 한 번에 꺼내 sendmmsg 1회로 송신
+static void wl1_tx_batch_loop(wireless_t *w, int batch) {
+    void *frames[WL1_TX_BATCH_MAX];
+
+    while (w->running) {
+        int n = bq_pop_many(w->in_tx_q, frames, batch);
+        if (n == 0) {
+            if (!w->running) break;
+            continue;
+        }
+        wl1_tx_send(w, frames, n);
+    }
+}
+
+static int wl1_tx_batch_size(const wireless_t *w) {
+    int batch = (int)w->cfg->wl1_tx_batch;
+    return batch > WL1_TX_BATCH_MAX ? WL1_TX_BATCH_MAX : batch;
+}
+
+static int wl1_rx_batch_size(const wireless_t *w) {
+    int batch = (int)w->cfg->wl1_rx_batch;
+    return batch > WL1_RX_BATCH_MAX ? WL1_RX_BATCH_MAX : batch;
+}
+
+static void* wireless_rx_thread(void *arg) {
+    wireless_t *w = (wireless_t*)arg;
+    int batch = wl1_rx_batch_size(w);
+    if (batch <= 1) wl1_rx_single_loop(w);
+    else            wl1_rx_batch_loop(w, batch);
     return NULL;
 }
 
-int wireless_start(wireless_t *w, const app_config_t *cfg, bq_t *out_rx_q, bq_t *in_tx_q) {
-  if (!w || !cfg || !out_rx_q || !in_tx_q) return -1;
+static void* wireless_tx_thread(void *arg) {
+    wireless_t *w = (wireless_t*)arg;
+    int batch = wl1_tx_batch_size(w);
+    if (batch <= 1) wl1_tx_single_loop(w, &w->tx_dst);
+    else            wl1_tx_batch_loop(w, batch);
+    return NULL;
+}
 
-  memset(w, 0, sizeof(*w));
-  w->cfg = cfg;
-  w->out_rx_q = out_rx_q;
-  w->in_tx_q = in_tx_q;
-  w->running = true;
+int wireless_rx_poll(wireless_t *w) {
+    int batch = wl1_rx_batch_size(w);
+    if (batch < 1) batch = 1;
+    int n = wl1_rx_batch_once(w, batch, MSG_DONTWAIT);
+    if (n < 0) LOGW("wireless rx: packet alloc failed");
+    return n;
+}
+
+int wireless_tx_poll(wireless_t *w) {
+    void *frames[WL1_TX_BATCH_MAX];
+    int batch = wl1_tx_batch_size(w);
+    if (batch < 1) batch = 1;
+    int total = 0, n;
+    while ((n = bq_try_pop_many(w->in_tx_q, frames, batch)) > 0) {
+        wl1_tx_send(w, frames, n);
+        total += n;
+    }
+    return total;
+}
 
-  // RX socket
+// RX 소켓 (wl1_bind_ip:wl1_listen_port)
+static int wl1_rx_open(wireless_t *w, const app_config_t *cfg) {
   w->sock_rx = socket(AF_INET, SOCK_DGRAM, 0);
   if (w->sock_rx < 0) return -1;
 
   int yes = 1;
   setsockopt(w->sock_rx, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
 
+  // 수신 대기 상한: 트래픽이 없어도 주기적으로 깨어나 running 확인
+  if (cfg->wl1_rx_timeout_ms > 0) {
+    struct timeval tv;
+    tv.tv_sec = (time_t)(cfg->wl1_rx_timeout_ms / 1000);
+    tv.tv_usec = (suseconds_t)(cfg->wl1_rx_timeout_ms % 1000) * 1000;
+    setsockopt(w->sock_rx, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  }
+
   struct sockaddr_in addr;
   memset(&addr, 0, sizeof(addr));
   addr.sin_family = AF_INET;
@@ -109,36 +386,78 @@ int wireless_start(wireless_t *w, const app_config_t *cfg, bq_t *out_rx_q, bq_t
     w->sock_rx = -1;
     return -1;
   }
+  return 0;
+}
+
+int wireless_open(wireless_t *w, const app_config_t *cfg,
+                  bq_t *out_rx_q, int n_rx_q, bq_t *in_tx_q, rx_dedup_t *dedup) {
+  if (!w || !cfg || !out_rx_q || !in_tx_q) return -1;
+  if (n_rx_q < 1 || n_rx_q > WL1_MAX_WORKERS) return -1;
+
+  memset(w, 0, sizeof(*w));
+  w->cfg = cfg;
+  w->out_rx_q = out_rx_q;
+  w->n_rx_q = n_rx_q;
+  w->in_tx_q = in_tx_q;
+  w->dedup = dedup;
+  w->sock_rx = w->sock_tx = -1;
+  w->running = true;
+
+  // 파일 재생(replay.h)은 wireless_inject로만 받음: 포트를 잡지 않아 같은 호스트의 rsu와 함께
+  // 띄울 수 있고, 현장 트래픽이 섞이지 않으며 샤드 생산자가 재생 스레드 하나로 유지됨
+  if (!cfg->replay_path && wl1_rx_open(w, cfg) != 0) return -1;
+
+  // 재생 중 송신은 RSU_REPLAY_TX=1일 때만: 현장 캡처의 사고 경보가 실제로 방송되지 않게 세고 버림
+  w->tx_muted = cfg->replay_path && !cfg->replay_tx;
+  if (w->tx_muted) return 0;
 
   // TX socket
   w->sock_tx = socket(AF_INET, SOCK_DGRAM, 0);
   if (w->sock_tx < 0) {
-    close(w->sock_rx);
+    if (w->sock_rx >= 0) close(w->sock_rx);
     w->sock_rx = -1;
     return -1;
   }
+  int yes = 1;
+  setsockopt(w->sock_tx, SOL_SOCKET, SO_BROADCAST, &yes, sizeof(yes));
 
-  // threads
-  if (pthread_create(&w->th_rx, NULL, wireless_rx_thread, w) != 0) {
-    close(w->sock_rx);
-    close(w->sock_tx);
-    w->sock_rx = w->sock_tx = -1;
-    return -1;
+  memset(&w->tx_dst, 0, sizeof(w->tx_dst));
+  w->tx_dst.sin_family = AF_INET;
+  w->tx_dst.sin_port = htons(cfg->wl1_tx_port);
+  w->tx_dst.sin_addr.s_addr = inet_addr(cfg->wl1_tx_ip);
+  return 0;
+}
+
+int wireless_start(wireless_t *w, const app_config_t *cfg,
+                   bq_t *out_rx_q, int n_rx_q, bq_t *in_tx_q, rx_dedup_t *dedup) {
+  if (wireless_open(w, cfg, out_rx_q, n_rx_q, in_tx_q, dedup) != 0) return -1;
+
+  // threads (RX 소켓이 없으면(재생) RX 스레드도 없음)
+  if (w->sock_rx >= 0) {
+    if (pthread_create(&w->th_rx, NULL, wireless_rx_thread, w) != 0) {
+      close(w->sock_rx);
+      if (w->sock_tx >= 0) close(w->sock_tx);
+      w->sock_rx = w->sock_tx = -1;
+      return -1;
+    }
+    w->rx_started = true;
   }
   if (pthread_create(&w->th_tx, NULL, wireless_tx_thread, w) != 0) {
     w->running = false;
-    close(w->sock_rx);
-    close(w->sock_tx);
-    pthread_join(w->th_rx, NULL);
+    if (w->sock_rx >= 0) close(w->sock_rx);
+    if (w->sock_tx >= 0) close(w->sock_tx);
+    if (w->rx_started) pthread_join(w->th_rx, NULL);
+    w->rx_started = false;
     w->sock_rx = w->sock_tx = -1;
     return -1;
   }
+  w->th_started = true;
 
   return 0;
 }
 
 void wireless_stop(wireless_t *w) {
-  if (!w) return;
+  if (!w || !w->cfg) return;
 
   w->running = false;
 
@@ -146,6 +465,20 @@ void wireless_stop(wireless_t *w) {
   if (w->sock_rx >= 0) { close(w->sock_rx); w->sock_rx = -1; }
   if (w->sock_tx >= 0) { close(w->sock_tx); w->sock_tx = -1; }
 
-  pthread_join(w->th_rx, NULL);
-  pthread_join(w->th_tx, NULL);
+  if (w->th_started) {
+    if (w->rx_started) pthread_join(w->th_rx, NULL);
+    pthread_join(w->th_tx, NULL);
+    w->th_started = false;
+    w->rx_started = false;
+  }
+  for (int i = 0; i < WL1_RX_BATCH_MAX; i++) {
+    mempool_free(&g_pools.wl1_pkt, w->rx_slot[i]);
+    w->rx_slot[i] = NULL;
+  }
+
+  LOGI("wireless rx: %llu dropped by light filter (%s)",
+       (unsigned long long)w->rx_filtered, filter_batch_impl_name());
+  LOGI("wireless tx: %llu sent, %llu failed, %llu discarded (replay)",
+       (unsigned long long)w->tx_sent, (unsigned long long)w->tx_failed,
+       (unsigned long long)w->tx_discarded);
 }
@@ -0,0 +1,153 @@
+#include "wl1_worker.h"
+
+#include "types.h"
+#include "filter.h"
+#include "security.h"
+#include "packet.h"
+#include "debug.h"
+#include "pools.h"
+#include "timeutil.h"
+#include "trace.h"
+#include "stats_shm.h"
+
+#ifndef WL1_WORKER_BATCH_MAX
+#define WL1_WORKER_BATCH_MAX 32
+#endif
+
+// 배치 안 단계별 탈락 수 (배치 끝에 공유 통계로 한 번에)
+typedef struct {
+    uint32_t heavy_reject;
+    uint32_t strip_reject;
+} wl1_batch_cnt_t;
+
+// 패킷 1개: [Filter] -> [Strip] -> [Packet Conv] -> sm_event_t (실패 시 NULL)
+// 성공하면 *sender_id에 dedup 키용 송신자 ID
+static sm_event_t* wl1_process_one(wl1_worker_t *w, wl1_packet_t *pkt, uint32_t *sender_id,
+                                   wl1_batch_cnt_t *cnt) {
+    uint32_t dist = 0;
+    DBG_INFO("[STEP 2] Worker Pop. Addr: %p", (void*)pkt);
+    // 1. Filter (Raw Packet 검사, light는 wireless RX에서 이미 통과)
+    if (!filter_pass_heavy(w->filter, pkt, &dist)) {
+        cnt->heavy_reject++;
+        mempool_free(&g_pools.wl1_pkt, pkt);
+        return NULL;
+    }
+
+    // 2. Wireless RX Strip (Packet -> Payload)
+    wl1_payload_t stripped;
+    if (!sec_wireless_rx_strip(pkt, &stripped)) {
+        cnt->strip_reject++;
+        mempool_free(&g_pools.wl1_pkt, pkt);
+        return NULL;
+    }
+    mempool_free(&g_pools.wl1_pkt, pkt);
+    *sender_id = stripped.sender.sender_id;
+
+    // 3. Packet Convert (WL-1' -> RSU-2')
+    rsu2_payload_t *rsu2p = mempool_alloc(&g_pools.rsu2p);
+    if (!rsu2p || !packet_wl1_to_rsu2(&stripped, w->rsu_id, dist, rsu2p)) {
+        mempool_free(&g_pools.rsu2p, rsu2p);
+        return NULL;
+    }
+
+    sm_event_t *ev = mempool_alloc(&g_pools.sm_ev);
+    if (!ev) {
+        mempool_free(&g_pools.rsu2p, rsu2p);
+        return NULL;
+    }
+    ev->type = EV_WL1_RX;
+    ev->u.rsu2p = rsu2p;
+    return ev;
+}
+
+// 꺼낸 배치 처리 후 결과 이벤트를 한 번에 넘김
+static void wl1_process_batch(wl1_worker_t *w, void **pkts, int n) {
+    void *evs[WL1_WORKER_BATCH_MAX];
+    uint32_t senders[WL1_WORKER_BATCH_MAX];   // dedup 키 (push 후에는 ev를 만질 수 없음)
+    uint64_t acc_ids[WL1_WORKER_BATCH_MAX];
+
+    uint64_t pop_ns = trace_now_if();
+    wl1_batch_cnt_t cnt = { 0, 0 };
+    int ne = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t rx_ns = pop_ns ? trace_wl1_rx_take(pkts[i]) : 0;   // pkt는 처리 중 풀로 돌아감
+        sm_event_t *ev = wl1_process_one(w, (wl1_packet_t*)pkts[i], &senders[ne], &cnt);
+        if (!ev) continue;
+        if (pop_ns && rx_ns) {
+            trace_begin(&ev->trace, rx_ns);
+            trace_stamp(&ev->trace, TR_WL1_POP, pop_ns);
+        }
+        acc_ids[ne] = ev->u.rsu2p->accident.accident_id;
+        evs[ne++] = ev;
+    }
+    uint32_t heavy_pass = (uint32_t)n - cnt.heavy_reject;
+    stats_add(&g_stats->filter[STF_HEAVY].pass, heavy_pass);
+    stats_add(&g_stats->filter[STF_HEAVY].reject, cnt.heavy_reject);
+    stats_add(&g_stats->filter[STF_STRIP].pass, heavy_pass - cnt.strip_reject);
+    stats_add(&g_stats->filter[STF_STRIP].reject, cnt.strip_reject);
+    if (ne == 0) return;
+
+    uint64_t done_ns = trace_now_if();
+    if (done_ns) {
+        for (int i = 0; i < ne; i++) trace_stamp(&((sm_event_t*)evs[i])->trace, TR_WL1_DONE, done_ns);
+    }
+
+    // 4. Send to StateManager
+    DBG_INFO("[STEP 3] Push to SM Queue (%d events)", ne);
+    int pushed = bq_push_many(w->out_q, evs, ne);
+    if (w->dedup) {
+        // push 성공분만 등록
+        uint64_t now = now_ms_monotonic();
+        for (int i = 0; i < pushed; i++) {
+            rx_dedup_insert(w->dedup, senders[i], acc_ids[i], now);
+        }
+    }
+    for (int i = pushed; i < ne; i++) {
+        sm_event_t *ev = (sm_event_t*)evs[i];
+        mempool_free(&g_pools.rsu2p, ev->u.rsu2p);
+        mempool_free(&g_pools.sm_ev, ev);
+    }
+}
+
+// 샤드 큐에 쌓인 만큼 한 번에 꺼내 처리
+static void* wl1_worker_thread(void *arg) {
+    wl1_worker_t *w = (wl1_worker_t*)arg;
+    void *pkts[WL1_WORKER_BATCH_MAX];
+
+    for (;;) {
+        int n = bq_pop_many(w->in_q, pkts, WL1_WORKER_BATCH_MAX);
+        if (n == 0) break;
+        wl1_process_batch(w, pkts, n);
+    }
+    return NULL;
+}
+
+int wl1_worker_poll(wl1_worker_t *w) {
+    void *pkts[WL1_WORKER_BATCH_MAX];
+    int total = 0, n;
+    while ((n = bq_try_pop_many(w->in_q, pkts, WL1_WORKER_BATCH_MAX)) > 0) {
+        wl1_process_batch(w, pkts, n);
+        total += n;
+    }
+    return total;
+}
+
+void wl1_worker_init(wl1_worker_t *w, bq_t *in_q, bq_t *out_q, uint32_t rsu_id,
+                     const filter_ctx_t *filter, rx_dedup_t *dedup) {
+    w->in_q = in_q;
+    w->out_q = out_q;
+    w->rsu_id = rsu_id;
+    w->filter = filter;
+    w->dedup = dedup;
+}
+
+int wl1_worker_start(wl1_worker_t *w, bq_t *in_q, bq_t *out_q, uint32_t rsu_id,
+                     const filter_ctx_t *filter, rx_dedup_t *dedup) {
+    wl1_worker_init(w, in_q, out_q, rsu_id, filter, dedup);
+    if (pthread_create(&w->th, NULL, wl1_worker_thread, w) != 0) return -1;
+    return 0;
+}
+
+void wl1_worker_join(wl1_worker_t *w) {
+    pthread_join(w->th, NULL);
+}
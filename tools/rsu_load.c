@@ -0,0 +1,512 @@
+// tools/rsu_load.c
+// WL-1 부하 생성기 + 로컬 서버 스텁 (한 머신에서 rsu 종단 성능 측정)
+// - 송신: 지정 속도로 WL-1 패킷을 sendmmsg (사고 수/중복 비율/무효 비율 지정)
+// - 스텁 서버: server_port에서 rsu의 RSU-2 보고를 받아 도착 시각을 찍음
+//   종단 지연 = 그 사고의 첫 WL-1 sendmmsg 직전 ~ RSU-2 보고 recv
+// - 명령: rsu의 local_port(명령 서버)로 접속해 RSU-3 ACK(보고마다)/OFF(사고 교체 시)를 보냄
+// - 결과: 진행 상황은 stderr, 최종 결과는 rsu-bench와 같은 CSV(suite,case,metric,value)로 stdout
+//
+// 사고 모델: 활성 사고 N개 슬롯을 돌려 씀
+// - 패킷마다 확률 dup으로 활성 사고 하나의 반복 보고(차량 senders대 중 하나),
+//   아니면 새 사고를 만들어 가장 오래된 슬롯을 교체 (-o면 교체된 사고에 OFF)
+// - 같은 차량의 반복은 RX dedup, 다른 차량의 반복은 SM dedup에서 걸러짐
+// - 무효 패킷(ttl 1, send_test.py와 같은 형태)은 light filter에서 걸러짐
+//
+// usage: rsu-load [-r pps(0=최대)] [-d sec] [-n accidents] [-p dup] [-x invalid] [-s senders]
+//                 [-b batch] [-h host] [-u wl1_port] [-S server_port] [-L local_port] [-a] [-o]
+//   rsu는 스텁을 보게 실행: RSU_SERVER_IP=127.0.0.1 ./rsu
+#define _GNU_SOURCE // sendmmsg
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "types.h"
+
+#define LOAD_ACC_BASE  0x4c4f000000000000ull   // 이 범위 밖 보고(main.c 테스트 등)는 무시
+#define LOAD_SENDER_BASE 0x10000u
+#define LOAD_BATCH_MAX 64
+#define LOAD_CONNECT_WAIT_S 15
+
+typedef struct {
+  // 옵션
+  uint32_t rate;        // pkt/s (0 = 최대)
+  double secs;
+  uint32_t accidents;   // 활성 사고 슬롯 수
+  double dup;           // 반복 보고 비율
+  double invalid;       // light filter 탈락 패킷 비율
+  uint32_t senders;     // 사고당 보고 차량 수
+  int batch;
+  const char *host;
+  uint16_t wl1_port;
+  uint16_t server_port;
+  uint16_t local_port;
+  bool ack;
+  bool off;
+
+  // 새 사고 seq별 첫 송신 시각 (0 = 아직), 스텁이 읽음
+  _Atomic uint64_t *first_send;
+  uint32_t max_new;
+
+  // 스텁 서버 (스텁 스레드만 씀, 끝나고 main이 읽음)
+  int listen_fd;
+  int ack_fd;
+  uint8_t *seen;
+  uint64_t *lat_ns;
+  _Atomic uint64_t reports;     // 새 사고 보고 (지연 기록된 것)
+  _Atomic uint64_t dup_reports; // 같은 사고 보고를 또 받음
+  _Atomic uint64_t foreign;     // 범위 밖 사고
+  _Atomic uint64_t acks;
+  _Atomic bool connected;
+  _Atomic bool stop;
+} load_t;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t now_ms_realtime(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
+}
+
+static inline uint64_t xorshift64(uint64_t *s) {
+  uint64_t x = *s;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *s = x;
+}
+
+// [0, 1)
+static inline double rnd01(uint64_t *s) {
+  return (double)(xorshift64(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int cmp_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
+
+static int tcp_connect(const char *host, uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_in a;
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_port = htons(port);
+  if (inet_pton(AF_INET, host, &a.sin_addr) != 1 || connect(fd, (struct sockaddr*)&a, sizeof(a)) != 0) {
+    close(fd);
+    return -1;
+  }
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return fd;
+}
+
+static bool send_all(int fd, const void *buf, size_t len) {
+  const uint8_t *p = (const uint8_t*)buf;
+  while (len) {
+    ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    p += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+// RSU-3 프레임 (acc_flag: 0 = ON/ACK, 0xFFFF = OFF), 보고에서 온 값은 그대로 돌려줌
+static void make_rsu3(rsu3_packet_t *f, uint32_t rsu_id_be, const acc_info_t *acc, uint16_t dist_be,
+                      uint64_t rsu_rx_time, uint16_t acc_flag) {
+  memset(f, 0, sizeof(*f));
+  f->payload.rsu_id = rsu_id_be;
+  f->payload.accident = *acc;
+  f->payload.server_info.distance = dist_be;
+  f->payload.server_info.acc_flag = acc_flag;
+  f->payload.server_info.rsu_rx_time = rsu_rx_time;
+  memcpy(f->token, &rsu_id_be, sizeof(rsu_id_be));
+}
+
+// 보고 묶음 처리: 새 사고면 지연 기록 (+ ACK)
+static size_t stub_handle(load_t *L, const uint8_t *buf, size_t len, uint64_t now) {
+  rsu3_packet_t acks[64];
+  int na = 0;
+  size_t off = 0;
+  for (; len - off >= sizeof(rsu2_packet_t); off += sizeof(rsu2_packet_t)) {
+    rsu2_packet_t r;
+    memcpy(&r, buf + off, sizeof(r));
+    uint64_t id = r.payload.accident.accident_id;
+    uint64_t seq = id - LOAD_ACC_BASE;
+    if (id < LOAD_ACC_BASE || seq >= L->max_new) {
+      atomic_fetch_add_explicit(&L->foreign, 1, memory_order_relaxed);
+      continue;
+    }
+    uint64_t t0 = atomic_load_explicit(&L->first_send[seq], memory_order_relaxed);
+    if (!t0 || L->seen[seq]) {
+      atomic_fetch_add_explicit(&L->dup_reports, 1, memory_order_relaxed);
+      continue;
+    }
+    L->seen[seq] = 1;
+    uint64_t n = atomic_load_explicit(&L->reports, memory_order_relaxed);
+    L->lat_ns[n] = now > t0 ? now - t0 : 0;
+    atomic_store_explicit(&L->reports, n + 1, memory_order_relaxed);
+
+    if (L->ack_fd >= 0) {
+      make_rsu3(&acks[na++], r.payload.rsu_id, &r.payload.accident, r.payload.rsu_info.distance,
+                r.payload.rsu_info.rsu_rx_time, 0x0000);
+      if (na == 64) {
+        if (send_all(L->ack_fd, acks, sizeof(acks[0]) * (size_t)na)) atomic_fetch_add(&L->acks, (uint64_t)na);
+        na = 0;
+      }
+    }
+  }
+  if (na && send_all(L->ack_fd, acks, sizeof(acks[0]) * (size_t)na)) atomic_fetch_add(&L->acks, (uint64_t)na);
+  return off;
+}
+
+// [Thread] 서버 스텁: rsu 연결 수락 -> RSU-2 보고 수신 (끊기면 다시 수락)
+static void* stub_thread(void *arg) {
+  load_t *L = (load_t*)arg;
+  uint8_t buf[64 * 256];
+  size_t have = 0;
+  int c = -1;
+
+  while (!atomic_load(&L->stop)) {
+    struct pollfd pfd = { .fd = c >= 0 ? c : L->listen_fd, .events = POLLIN };
+    int pr = poll(&pfd, 1, 100);
+    if (pr <= 0) continue;
+    if (c < 0) {
+      c = accept(L->listen_fd, NULL, NULL);
+      if (c >= 0) {
+        have = 0;
+        atomic_store(&L->connected, true);
+        fprintf(stderr, "[load] rsu connected to stub server\n");
+      }
+      continue;
+    }
+    ssize_t r = recv(c, buf + have, sizeof(buf) - have, 0);
+    if (r <= 0) {
+      if (r < 0 && errno == EINTR) continue;
+      fprintf(stderr, "[load] rsu disconnected from stub server\n");
+      close(c);
+      c = -1;
+      atomic_store(&L->connected, false);
+      continue;
+    }
+    uint64_t now = now_ns();
+    have += (size_t)r;
+    size_t used = stub_handle(L, buf, have, now);
+    memmove(buf, buf + used, have - used);
+    have -= used;
+  }
+  if (c >= 0) close(c);
+  return NULL;
+}
+
+static int stub_listen(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  int yes = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+  struct sockaddr_in a;
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_port = htons(port);
+  a.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (struct sockaddr*)&a, sizeof(a)) != 0 || listen(fd, 4) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+typedef struct {
+  uint64_t seq;         // 사고 seq (UINT64_MAX = 빈 슬롯)
+} load_slot_t;
+
+static void make_wl1(wl1_packet_t *p, uint64_t seq, uint32_t sender, bool valid) {
+  memset(&p->payload, 0, sizeof(p->payload));
+  p->payload.header.version = 1;
+  p->payload.header.msg_type = 0;
+  p->payload.header.ttl = valid ? 3 : 1;
+  p->payload.sender.sender_id = sender;
+  p->payload.sender.send_time = now_ms_realtime();
+  p->payload.sender.lat = 37000000 + (int32_t)(seq % 1000);
+  p->payload.sender.lon = 127000000 + (int32_t)(seq % 997);
+  p->payload.accident.direction = (uint16_t)(seq % 360);
+  p->payload.accident.lane = (uint8_t)(1 + seq % 4);
+  p->payload.accident.severity = (uint8_t)(2 + seq % 2);
+  p->payload.accident.accident_time = p->payload.sender.send_time;
+  p->payload.accident.accident_id = LOAD_ACC_BASE + seq;
+  p->payload.accident.lat = 37000000 + (int32_t)(seq % 1000);
+  p->payload.accident.lon = 127000000 + (int32_t)(seq % 997);
+  memset(p->security, 0xEE, WL_SEC_SIZE);
+}
+
+static void usage(void) {
+  fprintf(stderr,
+          "usage: rsu-load [-r pps(0=max)] [-d sec] [-n accidents] [-p dup] [-x invalid] [-s senders]\n"
+          "                [-b batch] [-h host] [-u wl1_port] [-S server_port] [-L local_port] [-a] [-o]\n"
+          "  -a  ACK each report with RSU-3 ON   -o  RSU-3 OFF when an accident is replaced\n");
+}
+
+int main(int argc, char **argv) {
+  load_t L;
+  memset(&L, 0, sizeof(L));
+  L.rate = 10000;
+  L.secs = 5;
+  L.accidents = 1000;
+  L.dup = 0.5;
+  L.invalid = 0.0;
+  L.senders = 4;
+  L.batch = 32;
+  L.host = "127.0.0.1";
+  L.wl1_port = 30000;
+  L.server_port = 20615;
+  L.local_port = 20905;
+  L.ack_fd = -1;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "r:d:n:p:x:s:b:h:u:S:L:ao")) != -1) {
+    switch (opt) {
+      case 'r': L.rate = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'd': L.secs = atof(optarg); break;
+      case 'n': L.accidents = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'p': L.dup = atof(optarg); break;
+      case 'x': L.invalid = atof(optarg); break;
+      case 's': L.senders = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'b': L.batch = atoi(optarg); break;
+      case 'h': L.host = optarg; break;
+      case 'u': L.wl1_port = (uint16_t)atoi(optarg); break;
+      case 'S': L.server_port = (uint16_t)atoi(optarg); break;
+      case 'L': L.local_port = (uint16_t)atoi(optarg); break;
+      case 'a': L.ack = true; break;
+      case 'o': L.off = true; break;
+      default: usage(); return 2;
+    }
+  }
+  if (L.secs <= 0) L.secs = 1;
+  if (L.accidents < 1) L.accidents = 1;
+  if (L.senders < 1) L.senders = 1;
+  if (L.batch < 1) L.batch = 1;
+  if (L.batch > LOAD_BATCH_MAX) L.batch = LOAD_BATCH_MAX;
+
+  // 새 사고 수 상한 (최대 속도는 넉넉히, 넘으면 그 시점에서 송신 종료)
+  double est = L.rate ? (double)L.rate * L.secs + 1 : 4194304.0;
+  L.max_new = est > 16777216.0 ? 16777216u : (uint32_t)est;
+  L.first_send = calloc(L.max_new, sizeof(L.first_send[0]));
+  L.seen = calloc(L.max_new, 1);
+  L.lat_ns = calloc(L.max_new, sizeof(uint64_t));
+  load_slot_t *slots = malloc(sizeof(load_slot_t) * L.accidents);
+  if (!L.first_send || !L.seen || !L.lat_ns || !slots) {
+    fprintf(stderr, "[load] out of memory (%u accidents)\n", L.max_new);
+    return 1;
+  }
+  for (uint32_t i = 0; i < L.accidents; i++) slots[i].seq = UINT64_MAX;
+
+  L.listen_fd = stub_listen(L.server_port);
+  if (L.listen_fd < 0) {
+    fprintf(stderr, "[load] stub server: port %u bind failed (%s)\n", L.server_port, strerror(errno));
+    return 1;
+  }
+  pthread_t th;
+  if (pthread_create(&th, NULL, stub_thread, &L) != 0) return 1;
+
+  // rsu가 스텁에 붙을 때까지 (재접속 backoff 최대 10초)
+  fprintf(stderr, "[load] stub server on :%u, waiting for rsu (RSU_SERVER_IP=127.0.0.1)\n", L.server_port);
+  uint64_t wait_end = now_ns() + LOAD_CONNECT_WAIT_S * 1000000000ull;
+  while (!atomic_load(&L.connected) && now_ns() < wait_end) usleep(10000);
+  if (!atomic_load(&L.connected)) {
+    fprintf(stderr, "[load] rsu did not connect within %d s\n", LOAD_CONNECT_WAIT_S);
+    atomic_store(&L.stop, true);
+    pthread_join(th, NULL);
+    return 1;
+  }
+
+  int off_fd = -1;
+  if (L.ack || L.off) {
+    if (L.ack) L.ack_fd = tcp_connect(L.host, L.local_port);
+    if (L.off) off_fd = tcp_connect(L.host, L.local_port);
+    if ((L.ack && L.ack_fd < 0) || (L.off && off_fd < 0)) {
+      fprintf(stderr, "[load] command port %s:%u connect failed, RSU-3 disabled\n", L.host, L.local_port);
+    }
+  }
+
+  int tx = socket(AF_INET, SOCK_DGRAM, 0);
+  int sndbuf = 4 << 20;
+  setsockopt(tx, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+  struct sockaddr_in dst;
+  memset(&dst, 0, sizeof(dst));
+  dst.sin_family = AF_INET;
+  dst.sin_port = htons(L.wl1_port);
+  if (inet_pton(AF_INET, L.host, &dst.sin_addr) != 1) {
+    fprintf(stderr, "[load] bad host %s\n", L.host);
+    return 2;
+  }
+  fprintf(stderr, "[load] -> %s:%u rate %u pkt/s%s for %.1f s, %u accidents, dup %.2f, invalid %.2f, %u senders\n",
+          L.host, L.wl1_port, L.rate, L.rate ? "" : " (max)", L.secs, L.accidents, L.dup, L.invalid, L.senders);
+
+  static wl1_packet_t pkts[LOAD_BATCH_MAX];
+  struct mmsghdr msgs[LOAD_BATCH_MAX];
+  struct iovec iov[LOAD_BATCH_MAX];
+  uint64_t new_seq[LOAD_BATCH_MAX];
+  rsu3_packet_t offs[LOAD_BATCH_MAX];
+  memset(msgs, 0, sizeof(msgs));
+  for (int i = 0; i < LOAD_BATCH_MAX; i++) {
+    iov[i].iov_base = &pkts[i];
+    iov[i].iov_len = sizeof(wl1_packet_t);
+    msgs[i].msg_hdr.msg_name = &dst;
+    msgs[i].msg_hdr.msg_namelen = sizeof(dst);
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  uint64_t rng = 0x9e3779b97f4a7c15ull;
+  uint64_t sent = 0, send_fail = 0, n_new = 0, n_dup = 0, n_invalid = 0, n_off = 0;
+  uint32_t filled = 0, next_slot = 0;
+  const uint64_t t0 = now_ns();
+  const uint64_t t_end = t0 + (uint64_t)(L.secs * 1e9);
+  uint64_t next_tick = t0 + 1000000000ull, tick_sent = 0, tick_rep = 0;
+
+  for (;;) {
+    uint64_t now = now_ns();
+    if (now >= t_end || n_new >= L.max_new) break;
+
+    int nb = L.batch;
+    if (L.rate) {
+      uint64_t due = (uint64_t)((double)(now - t0) * (double)L.rate / 1e9) + 1;
+      if (due <= sent) {
+        uint64_t at = t0 + (uint64_t)((double)sent * 1e9 / (double)L.rate);
+        struct timespec ts = { (time_t)(at / 1000000000ull), (long)(at % 1000000000ull) };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        continue;
+      }
+      if (due - sent < (uint64_t)nb) nb = (int)(due - sent);
+    }
+
+    int nn = 0, noff = 0;
+    for (int i = 0; i < nb; i++) {
+      if (L.invalid > 0 && rnd01(&rng) < L.invalid) {
+        make_wl1(&pkts[i], 0, LOAD_SENDER_BASE, false);
+        n_invalid++;
+        continue;
+      }
+      if (filled && rnd01(&rng) < L.dup) {
+        uint64_t seq = slots[xorshift64(&rng) % filled].seq;
+        make_wl1(&pkts[i], seq, LOAD_SENDER_BASE + (uint32_t)(xorshift64(&rng) % L.senders), true);
+        n_dup++;
+        continue;
+      }
+      if (n_new >= L.max_new) {
+        nb = i;
+        break;
+      }
+      // 새 사고: 가장 오래된 슬롯 교체
+      load_slot_t *s = &slots[next_slot];
+      if (s->seq != UINT64_MAX && off_fd >= 0) {
+        wl1_packet_t old;
+        make_wl1(&old, s->seq, LOAD_SENDER_BASE, true);
+        make_rsu3(&offs[noff++], 0, &old.payload.accident, 0, 0, 0xFFFF);
+      }
+      s->seq = n_new++;
+      next_slot = (next_slot + 1) % L.accidents;
+      if (filled < L.accidents) filled++;
+      make_wl1(&pkts[i], s->seq, LOAD_SENDER_BASE, true);
+      new_seq[nn++] = s->seq;
+    }
+    if (nb == 0) break;
+
+    uint64_t ts = now_ns();
+    for (int i = 0; i < nn; i++) atomic_store_explicit(&L.first_send[new_seq[i]], ts, memory_order_relaxed);
+    int r = sendmmsg(tx, msgs, (unsigned int)nb, 0);
+    if (r < 0) r = 0;
+    sent += (uint64_t)nb;
+    send_fail += (uint64_t)(nb - r);
+    if (noff) {
+      if (send_all(off_fd, offs, sizeof(offs[0]) * (size_t)noff)) n_off += (uint64_t)noff;
+    }
+
+    if (ts >= next_tick) {
+      uint64_t rep = atomic_load(&L.reports);
+      fprintf(stderr, "[load] t=%.0fs sent %llu pkt/s  reports %llu/s\n", (double)(ts - t0) / 1e9,
+              (unsigned long long)(sent - tick_sent), (unsigned long long)(rep - tick_rep));
+      tick_sent = sent;
+      tick_rep = rep;
+      next_tick += 1000000000ull;
+    }
+  }
+  const uint64_t send_wall = now_ns() - t0;
+
+  // 남은 보고 (보고가 200ms 동안 안 늘면 끝, 최대 2초)
+  uint64_t last = atomic_load(&L.reports), last_t = now_ns();
+  uint64_t drain_end = last_t + 2000000000ull;
+  while (now_ns() < drain_end && atomic_load(&L.reports) < n_new) {
+    usleep(5000);
+    uint64_t cur = atomic_load(&L.reports);
+    if (cur != last) {
+      last = cur;
+      last_t = now_ns();
+    } else if (now_ns() - last_t > 200000000ull) {
+      break;
+    }
+  }
+  atomic_store(&L.stop, true);
+  pthread_join(th, NULL);
+  close(tx);
+  close(L.listen_fd);
+  if (L.ack_fd >= 0) close(L.ack_fd);
+  if (off_fd >= 0) close(off_fd);
+
+  uint64_t got = atomic_load(&L.reports);
+  qsort(L.lat_ns, got, sizeof(uint64_t), cmp_u64);
+
+  char cs[96];
+  snprintf(cs, sizeof(cs), "r%u_n%u_dup%.2f_inv%.2f%s%s", L.rate, L.accidents, L.dup, L.invalid,
+           L.ack ? "_ack" : "", L.off ? "_off" : "");
+#define REPORT(metric, v) printf("load,%s,%s,%.3f\n", cs, metric, (double)(v))
+  double wall_s = (double)send_wall / 1e9;
+  REPORT("sent", sent);
+  REPORT("send_fail", send_fail);
+  REPORT("sent_pps", (double)sent / wall_s);
+  REPORT("new_accidents", n_new);
+  REPORT("dup_pkts", n_dup);
+  REPORT("invalid_pkts", n_invalid);
+  REPORT("reports", got);
+  REPORT("report_pps", (double)got / wall_s);
+  REPORT("delivered_pct", n_new ? 100.0 * (double)got / (double)n_new : 0.0);
+  REPORT("dup_reports", atomic_load(&L.dup_reports));
+  REPORT("acks_sent", atomic_load(&L.acks));
+  REPORT("offs_sent", n_off);
+  if (got) {
+    REPORT("lat_p50_us", (double)L.lat_ns[got / 2] / 1000.0);
+    REPORT("lat_p90_us", (double)L.lat_ns[got * 9 / 10] / 1000.0);
+    REPORT("lat_p99_us", (double)L.lat_ns[got * 99 / 100] / 1000.0);
+    REPORT("lat_p999_us", (double)L.lat_ns[got * 999 / 1000] / 1000.0);
+    REPORT("lat_max_us", (double)L.lat_ns[got - 1] / 1000.0);
+  }
+#undef REPORT
+  fflush(stdout);
+
+  free(slots);
+  free(L.first_send);
+  free(L.seen);
+  free(L.lat_ns);
+  return 0;
+}
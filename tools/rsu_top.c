@@ -0,0 +1,195 @@
+// tools/rsu_top.c
+// 실행 중인 rsu의 공유 메모리 카운터(stats_shm.h)를 읽어 주기마다 속도로 보여줌
+// - usage: rsu-top [interval_s=1] [iterations=0(무한)]
+//          RSU_STATS_SHM=/name rsu-top   (기본 /rsu_stats)
+#define _GNU_SOURCE // nanosleep
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "stats_shm.h"
+
+// 속도 계산용 직전 값 (누적 카운터만)
+typedef struct {
+  uint64_t rx;
+  uint64_t pass[STF_N], reject[STF_N];
+  uint64_t drops[STQ_N], push[STQ_N];
+  uint64_t reports, cmd_frames, air;
+  uint64_t rule_evals[STATS_RULES_MAX], rule_rejects[STATS_RULES_MAX];
+} top_snap_t;
+
+static uint64_t ld(_Atomic uint64_t *c) {
+  return atomic_load_explicit(c, memory_order_relaxed);
+}
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static const char* wired_state_name(uint64_t s) {
+  switch (s) {
+    case 0: return "DISCONNECTED";
+    case 1: return "CONNECTING";
+    case 2: return "CONNECTED";
+    default: return "?";
+  }
+}
+
+static void snap_take(rsu_stats_t *st, top_snap_t *s) {
+  s->rx = ld(&st->rx_datagrams);
+  for (int i = 0; i < STF_N; i++) {
+    s->pass[i] = ld(&st->filter[i].pass);
+    s->reject[i] = ld(&st->filter[i].reject);
+  }
+  for (int i = 0; i < STQ_N; i++) {
+    s->drops[i] = ld(&st->queue[i].drops);
+    s->push[i] = ld(&st->queue[i].push_items);
+  }
+  s->reports = ld(&st->reports_sent);
+  s->cmd_frames = ld(&st->cmd_frames);
+  s->air = ld(&st->air_sent);
+  for (int i = 0; i < STATS_RULES_MAX; i++) {
+    s->rule_evals[i] = ld(&st->rule[i].evals);
+    s->rule_rejects[i] = ld(&st->rule[i].rejects);
+  }
+}
+
+// 재시작 직후처럼 값이 줄었으면 0
+static double rate(uint64_t cur, uint64_t prev, double dt) {
+  return (cur >= prev && dt > 0) ? (double)(cur - prev) / dt : 0.0;
+}
+
+static rsu_stats_t* stats_attach(const char *name) {
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0) return NULL;
+  struct stat sb;
+  if (fstat(fd, &sb) != 0 || (size_t)sb.st_size < sizeof(rsu_stats_t)) {
+    close(fd);
+    return NULL;
+  }
+  void *m = mmap(NULL, sizeof(rsu_stats_t), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (m == MAP_FAILED) return NULL;
+
+  rsu_stats_t *st = (rsu_stats_t*)m;
+  if (st->magic != RSU_STATS_MAGIC || st->version != RSU_STATS_VERSION ||
+      st->size != sizeof(rsu_stats_t)) {
+    fprintf(stderr, "rsu-top: %s: layout mismatch (magic %08x version %u size %u, expected v%u %zu)\n",
+            name, st->magic, st->version, st->size, RSU_STATS_VERSION, sizeof(rsu_stats_t));
+    munmap(m, sizeof(rsu_stats_t));
+    return NULL;
+  }
+  return st;
+}
+
+static void show(rsu_stats_t *st, const top_snap_t *cur, const top_snap_t *prev, double dt,
+                 const char *name, int stale) {
+  printf("rsu-top  %s  pid %u  heartbeat %llu%s\n", name, st->pid,
+         (unsigned long long)ld(&st->heartbeat), stale ? "  [STALE: not updating]" : "");
+  printf("rx %.0f/s  reports %.0f/s  air %.0f/s  cmd frames %.0f/s (bad %llu, %llu conn)\n",
+         rate(cur->rx, prev->rx, dt), rate(cur->reports, prev->reports, dt),
+         rate(cur->air, prev->air, dt), rate(cur->cmd_frames, prev->cmd_frames, dt),
+         (unsigned long long)ld(&st->cmd_bad_frames), (unsigned long long)ld(&st->cmd_conns));
+
+  printf("\n%-10s %12s %12s %14s %14s\n", "filter", "pass/s", "reject/s", "pass", "reject");
+  for (int i = 0; i < STF_N; i++) {
+    printf("%-10s %12.0f %12.0f %14llu %14llu\n", stats_filter_name(i),
+           rate(cur->pass[i], prev->pass[i], dt), rate(cur->reject[i], prev->reject[i], dt),
+           (unsigned long long)cur->pass[i], (unsigned long long)cur->reject[i]);
+  }
+
+  uint64_t nr = ld(&st->rule_count);
+  if (nr > STATS_RULES_MAX) nr = STATS_RULES_MAX;
+  printf("\n%-24s %12s %12s %14s %14s  (%llu reorders)\n", "light rule", "evals/s", "reject/s", "evals",
+         "rejects", (unsigned long long)ld(&st->rule_reorders));
+  for (uint64_t i = 0; i < nr; i++) {
+    char text[STATS_RULE_TEXT + 1];
+    memcpy(text, st->rule[i].text, STATS_RULE_TEXT);
+    text[STATS_RULE_TEXT] = '\0';
+    printf("%-24s %12.0f %12.0f %14llu %14llu\n", text,
+           rate(cur->rule_evals[i], prev->rule_evals[i], dt),
+           rate(cur->rule_rejects[i], prev->rule_rejects[i], dt),
+           (unsigned long long)cur->rule_evals[i], (unsigned long long)cur->rule_rejects[i]);
+  }
+
+  printf("\n%-12s %6s %6s %6s %10s %10s %12s\n", "queue", "depth", "hw", "cap", "push/s", "drops/s",
+         "drops");
+  for (int i = 0; i < STQ_N; i++) {
+    stats_queue_t *q = &st->queue[i];
+    printf("%-12s %6llu %6llu %6llu %10.0f %10.0f %12llu\n", stats_queue_name(i),
+           (unsigned long long)ld(&q->depth), (unsigned long long)ld(&q->high_water),
+           (unsigned long long)ld(&q->cap), rate(cur->push[i], prev->push[i], dt),
+           rate(cur->drops[i], prev->drops[i], dt), (unsigned long long)cur->drops[i]);
+  }
+
+  printf("\nscheduler pending %llu  accidents %llu (active %llu, cap %llu)\n",
+         (unsigned long long)ld(&st->sched_pending), (unsigned long long)ld(&st->acc_count),
+         (unsigned long long)ld(&st->acc_active), (unsigned long long)ld(&st->acc_cap));
+  printf("wired %s  connects %llu disconnects %llu  buffered %llu\n",
+         wired_state_name(ld(&st->wired_state)), (unsigned long long)ld(&st->wired_connects),
+         (unsigned long long)ld(&st->wired_disconnects), (unsigned long long)ld(&st->wired_buffered));
+  fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+  double interval = argc > 1 ? atof(argv[1]) : 1.0;
+  long iterations = argc > 2 ? atol(argv[2]) : 0;
+  if (interval <= 0) interval = 1.0;
+  const char *name = getenv("RSU_STATS_SHM");
+  if (!name || !*name) name = RSU_STATS_SHM_DEFAULT;
+
+  rsu_stats_t *st = stats_attach(name);
+  if (!st) {
+    fprintf(stderr, "rsu-top: cannot open %s (%s) - is rsu running?\n", name, strerror(errno));
+    return 1;
+  }
+  const int tty = isatty(STDOUT_FILENO);
+
+  top_snap_t prev, cur;
+  snap_take(st, &prev);
+  uint32_t pid = st->pid;
+  uint64_t started = st->started_ms;
+  uint64_t last_hb = ld(&st->heartbeat);
+  double t_prev = now_s();
+
+  for (long it = 0; iterations <= 0 || it < iterations; it++) {
+    struct timespec d = { (time_t)interval, (long)((interval - (double)(time_t)interval) * 1e9) };
+    nanosleep(&d, NULL);
+
+    // 같은 이름으로 새로 뜬 rsu (이전 매핑은 unlink된 옛 세그먼트) -> 다시 붙고 기준값 초기화
+    if (st->pid != pid || st->started_ms != started || ld(&st->heartbeat) == last_hb) {
+      rsu_stats_t *n = stats_attach(name);
+      if (n && (n->pid != pid || n->started_ms != started)) {
+        munmap(st, sizeof(rsu_stats_t));
+        st = n;
+        pid = st->pid;
+        started = st->started_ms;
+        snap_take(st, &prev);
+        last_hb = ld(&st->heartbeat);
+        t_prev = now_s();
+        continue;
+      }
+      if (n) munmap(n, sizeof(rsu_stats_t));
+    }
+
+    double t = now_s();
+    uint64_t hb = ld(&st->heartbeat);
+    snap_take(st, &cur);
+    if (tty) printf("\033[H\033[2J");
+    else if (it) printf("\n");
+    show(st, &cur, &prev, t - t_prev, name, hb == last_hb);
+    prev = cur;
+    t_prev = t;
+    last_hb = hb;
+  }
+  munmap(st, sizeof(rsu_stats_t));
+  return 0;
+}